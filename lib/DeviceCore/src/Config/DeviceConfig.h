@@ -4,6 +4,30 @@
 
 namespace DeviceCore {
 
+enum class ModbusFunction : uint8_t {
+  HoldingRegisters = 3,
+  InputRegisters = 4,
+};
+
+enum class ModbusValueType : uint8_t {
+  U16,
+  S16,
+  U32,  // 32-bit types span two registers, high word first
+  S32,
+  F32,
+};
+
+// One register range to poll from a Modbus RTU slave.
+struct ModbusBlock {
+  const char* name;
+  uint8_t slaveId;
+  ModbusFunction function;
+  uint16_t start;
+  uint16_t count;
+  ModbusValueType type;
+  unsigned long intervalMs;
+};
+
 struct DeviceConfig {
   const char* ssid;
   const char* password;
@@ -22,6 +46,25 @@ struct DeviceConfig {
   unsigned long serialBaud;
   const char* maintenancePhone;
   const char* userManualUrl;
+  size_t serialRxDepth;
+  size_t offlineQueueBytes;
+  size_t serialBatchMaxBytes;
+  unsigned long serialBatchMaxLatencyMs;
+  uint8_t mqttQos;
+  size_t mqttInflightWindow;
+  const ModbusBlock* modbusBlocks;
+  size_t modbusBlockCount;
+  const char* modbusTopic;
+  uint8_t modbusDePin;
+  unsigned long modbusTimeoutMs;
+  const char* modbusRequestTopic;
+  const char* modbusResponseTopic;
+  uint8_t logSinks;  // LogSink bits; 0 disables logging
+  const char* logTopic;
+  const char* metricsTopic;
+  unsigned long metricsIntervalMs;  // 0 -> on demand only
+  uint32_t heapAlarmMinBlock;       // 0 disables the fragmentation alarm
+  const char* configTopic;          // config/* commands and replies; nullptr disables them
 };
 
 }  // namespace DeviceCore
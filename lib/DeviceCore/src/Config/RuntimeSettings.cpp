@@ -0,0 +1,176 @@
+#include "RuntimeSettings.h"
+
+#include <cstring>
+
+namespace DeviceCore {
+
+namespace {
+constexpr uint32_t kMinHeartbeatMs = 1000UL;
+constexpr uint32_t kMaxHeartbeatMs = 86400000UL;
+constexpr uint32_t kMinPulseMs = 10UL;
+constexpr uint32_t kMaxPulseMs = 5000UL;
+constexpr uint32_t kMinBufferLimit = 16;
+constexpr uint32_t kMinBatchLatencyMs = 1UL;
+constexpr uint32_t kMaxBatchLatencyMs = 10000UL;
+constexpr uint32_t kSupportedBauds[] = {1200UL, 2400UL, 4800UL, 9600UL, 19200UL, 38400UL, 57600UL,
+                                        74880UL, 115200UL, 230400UL, 460800UL, 921600UL};
+
+void copyTopic(char* dest, const char* src) {
+  size_t len = src ? strnlen(src, RuntimeSettings::kMaxTopicLength) : 0;
+  memcpy(dest, src ? src : "", len);
+  dest[len] = '\0';
+}
+
+bool readRange(JsonVariantConst message, const char* key, uint32_t minValue, uint32_t maxValue, uint32_t& out, bool& present) {
+  JsonVariantConst value = message[key];
+  if (value.isNull()) {
+    return true;
+  }
+  present = true;
+  if (!value.is<uint32_t>()) {
+    return false;
+  }
+  uint32_t parsed = value.as<uint32_t>();
+  if (parsed < minValue || parsed > maxValue) {
+    return false;
+  }
+  out = parsed;
+  return true;
+}
+
+bool readTopic(JsonVariantConst message, const char* key, char* out, bool& present) {
+  JsonVariantConst value = message[key];
+  if (value.isNull()) {
+    return true;
+  }
+  present = true;
+  const char* topic = value.as<const char*>();
+  if (!topic) {
+    return false;
+  }
+  size_t len = strnlen(topic, RuntimeSettings::kMaxTopicLength + 1);
+  // Publish topics may not be empty, over-long or contain wildcards. Quotes,
+  // backslashes and control characters are refused too, so the topics can
+  // be echoed into JSON replies as they are.
+  if (len == 0 || len > RuntimeSettings::kMaxTopicLength || strpbrk(topic, "+#\"\\")) {
+    return false;
+  }
+  for (size_t i = 0; i < len; ++i) {
+    if (static_cast<unsigned char>(topic[i]) < 0x20) {
+      return false;
+    }
+  }
+  memcpy(out, topic, len + 1);
+  return true;
+}
+
+bool supportedBaud(uint32_t baud) {
+  for (uint32_t candidate : kSupportedBauds) {
+    if (candidate == baud) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+RuntimeSettings::RuntimeSettings()
+    : heartbeatInterval(0),
+      user1PulseDuration(0),
+      errPulseDuration(0),
+      serialBufferLimit(0),
+      serialBaud(0),
+      serialBatchMaxBytes(0),
+      serialBatchMaxLatencyMs(0) {
+  primaryTopic[0] = '\0';
+  serialTopic[0] = '\0';
+}
+
+void RuntimeSettings::capture(const DeviceConfig& config) {
+  heartbeatInterval = config.heartbeatInterval;
+  user1PulseDuration = config.user1PulseDuration;
+  errPulseDuration = config.errPulseDuration;
+  serialBufferLimit = config.serialBufferLimit;
+  serialBaud = config.serialBaud;
+  serialBatchMaxBytes = config.serialBatchMaxBytes;
+  serialBatchMaxLatencyMs = config.serialBatchMaxLatencyMs;
+  copyTopic(primaryTopic, config.primaryTopic);
+  copyTopic(serialTopic, config.serialTopic);
+}
+
+bool RuntimeSettings::operator==(const RuntimeSettings& other) const {
+  return heartbeatInterval == other.heartbeatInterval &&
+         user1PulseDuration == other.user1PulseDuration &&
+         errPulseDuration == other.errPulseDuration &&
+         serialBufferLimit == other.serialBufferLimit &&
+         serialBaud == other.serialBaud &&
+         serialBatchMaxBytes == other.serialBatchMaxBytes &&
+         serialBatchMaxLatencyMs == other.serialBatchMaxLatencyMs &&
+         strcmp(primaryTopic, other.primaryTopic) == 0 &&
+         strcmp(serialTopic, other.serialTopic) == 0;
+}
+
+bool stageSettings(const RuntimeSettings& current,
+                   JsonVariantConst message,
+                   size_t maxBufferLimit,
+                   RuntimeSettings& staged,
+                   const char*& badField) {
+  staged = current;
+  badField = nullptr;
+
+  // "cmd" itself is the only non-setting key allowed.
+  size_t recognised = message["cmd"].isNull() ? 0 : 1;
+  bool present = false;
+
+  struct RangeField {
+    const char* key;
+    uint32_t minValue;
+    uint32_t maxValue;
+    uint32_t* target;
+  };
+  const RangeField fields[] = {
+      {"heartbeatInterval", kMinHeartbeatMs, kMaxHeartbeatMs, &staged.heartbeatInterval},
+      {"user1PulseDuration", kMinPulseMs, kMaxPulseMs, &staged.user1PulseDuration},
+      {"errPulseDuration", kMinPulseMs, kMaxPulseMs, &staged.errPulseDuration},
+      {"serialBufferLimit", kMinBufferLimit, static_cast<uint32_t>(maxBufferLimit), &staged.serialBufferLimit},
+      {"serialBaud", 0, UINT32_MAX, &staged.serialBaud},
+      {"serialBatchMaxBytes", 0, static_cast<uint32_t>(maxBufferLimit), &staged.serialBatchMaxBytes},
+      {"serialBatchMaxLatencyMs", kMinBatchLatencyMs, kMaxBatchLatencyMs, &staged.serialBatchMaxLatencyMs},
+  };
+
+  for (const RangeField& field : fields) {
+    present = false;
+    if (!readRange(message, field.key, field.minValue, field.maxValue, *field.target, present)) {
+      badField = field.key;
+      return false;
+    }
+    recognised += present ? 1 : 0;
+  }
+
+  if (!supportedBaud(staged.serialBaud)) {
+    badField = "serialBaud";
+    return false;
+  }
+
+  present = false;
+  if (!readTopic(message, "primaryTopic", staged.primaryTopic, present)) {
+    badField = "primaryTopic";
+    return false;
+  }
+  recognised += present ? 1 : 0;
+
+  present = false;
+  if (!readTopic(message, "serialTopic", staged.serialTopic, present)) {
+    badField = "serialTopic";
+    return false;
+  }
+  recognised += present ? 1 : 0;
+
+  if (recognised != message.size()) {
+    badField = "unknown key";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace DeviceCore
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "DeviceConfig.h"
+
+namespace DeviceCore {
+
+// DeviceConfig fields that may be changed at runtime over MQTT. The topic
+// strings are owned here so DeviceConfig can point into them. Fixed-width
+// fields keep the layout stable for persistence.
+struct RuntimeSettings {
+  static constexpr size_t kMaxTopicLength = 64;
+
+  uint32_t heartbeatInterval;
+  uint32_t user1PulseDuration;
+  uint32_t errPulseDuration;
+  uint32_t serialBufferLimit;
+  uint32_t serialBaud;
+  uint32_t serialBatchMaxBytes;
+  uint32_t serialBatchMaxLatencyMs;
+  char primaryTopic[kMaxTopicLength + 1];
+  char serialTopic[kMaxTopicLength + 1];
+
+  RuntimeSettings();
+
+  void capture(const DeviceConfig& config);
+  bool operator==(const RuntimeSettings& other) const;
+  bool operator!=(const RuntimeSettings& other) const { return !(*this == other); }
+};
+
+// Copies current into staged and overlays every recognised field of a
+// "config/set" message. Either every field validates or staged must be
+// discarded; on failure badField names the first offending key.
+bool stageSettings(const RuntimeSettings& current,
+                   JsonVariantConst message,
+                   size_t maxBufferLimit,
+                   RuntimeSettings& staged,
+                   const char*& badField);
+
+}  // namespace DeviceCore
@@ -0,0 +1,102 @@
+#include "AllocTrace.h"
+#include <cstdlib>
+
+namespace DeviceCore {
+
+size_t AllocTrace::s_task = AllocTrace::kOutsideTasks;
+AllocTotals AllocTrace::s_totals[AllocTrace::kOutsideTasks + 1];
+AllocSite AllocTrace::s_sites[AllocTrace::kMaxSites];
+size_t AllocTrace::s_siteCount = 0;
+uint32_t AllocTrace::s_untracked = 0;
+bool AllocTrace::s_steady = false;
+uint32_t AllocTrace::s_steadyAllocations = 0;
+uintptr_t AllocTrace::s_firstSteadyCaller = 0;
+
+bool AllocTrace::enabled() {
+#ifdef DEVICECORE_ALLOC_TRACE
+  return true;
+#else
+  return false;
+#endif
+}
+
+void AllocTrace::reset() {
+  for (size_t i = 0; i <= kOutsideTasks; ++i) {
+    s_totals[i] = AllocTotals();
+  }
+  s_siteCount = 0;
+  s_untracked = 0;
+}
+
+void AllocTrace::markSteadyState() {
+  s_steady = true;
+  s_steadyAllocations = 0;
+  s_firstSteadyCaller = 0;
+}
+
+// Runs inside the allocator wrappers: no logging, no allocation.
+void AllocTrace::recordAllocation(void* caller, size_t size) {
+  AllocTotals& totals = s_totals[s_task];
+  ++totals.allocations;
+  totals.bytes += size;
+
+  uintptr_t address = reinterpret_cast<uintptr_t>(caller);
+  if (s_steady && s_task != kOutsideTasks) {
+    if (s_steadyAllocations++ == 0) {
+      s_firstSteadyCaller = address;
+    }
+#ifdef DEVICECORE_ALLOC_STRICT
+    abort();
+#endif
+  }
+  for (size_t i = 0; i < s_siteCount; ++i) {
+    if (s_sites[i].caller == address) {
+      ++s_sites[i].allocations;
+      s_sites[i].bytes += size;
+      return;
+    }
+  }
+  if (s_siteCount < kMaxSites) {
+    AllocSite& site = s_sites[s_siteCount++];
+    site.caller = address;
+    site.allocations = 1;
+    site.bytes = size;
+    return;
+  }
+  ++s_untracked;
+}
+
+}  // namespace DeviceCore
+
+#ifdef DEVICECORE_ALLOC_TRACE
+extern "C" {
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+void __real_free(void* pointer);
+
+void* __wrap_malloc(size_t size) {
+  DeviceCore::AllocTrace::recordAllocation(__builtin_return_address(0), size);
+  return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+  DeviceCore::AllocTrace::recordAllocation(__builtin_return_address(0), count * size);
+  return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size) {
+  DeviceCore::AllocTrace::recordAllocation(__builtin_return_address(0), size);
+  return __real_realloc(pointer, size);
+}
+
+void __wrap_free(void* pointer) {
+  if (pointer) {
+    DeviceCore::AllocTrace::recordFree();
+  }
+  __real_free(pointer);
+}
+
+}  // extern "C"
+#endif
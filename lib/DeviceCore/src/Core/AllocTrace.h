@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Scheduler.h"
+
+#ifndef DEVICECORE_ALLOC_TRACE_SITES
+#define DEVICECORE_ALLOC_TRACE_SITES 16
+#endif
+
+namespace DeviceCore {
+
+struct AllocTotals {
+  uint32_t allocations;
+  uint32_t bytes;
+  uint32_t frees;
+};
+
+struct AllocSite {
+  uintptr_t caller;  // return address into the caller; resolve with addr2line
+  uint32_t allocations;
+  uint32_t bytes;
+};
+
+// Debug-build allocation accounting. With DEVICECORE_ALLOC_TRACE defined and
+// the linker told to --wrap malloc, calloc, realloc and free (see the
+// esp12e_alloctrace environment), every heap call is charged to the
+// scheduler task that was running and to the address it was made from.
+// Without the flag the class still links but records nothing.
+//
+// Once markSteadyState() has been called, allocations made from inside a
+// task are also counted as steady-state allocations, which should stay at
+// zero. DEVICECORE_ALLOC_STRICT turns the first one into an abort so a host
+// build fails at the offending call.
+class AllocTrace {
+public:
+  static constexpr size_t kMaxSites = DEVICECORE_ALLOC_TRACE_SITES;
+  // Bucket for allocations made outside any task: SDK callbacks, the
+  // network stack and setup().
+  static constexpr size_t kOutsideTasks = Scheduler::kMaxTasks;
+
+  static bool enabled();
+  static void enterTask(size_t index) { s_task = index; }
+  static void leaveTask() { s_task = kOutsideTasks; }
+
+  static const AllocTotals& totals(size_t bucket) { return s_totals[bucket]; }
+  static size_t siteCount() { return s_siteCount; }
+  static const AllocSite& site(size_t index) { return s_sites[index]; }
+  // Allocations from call sites that did not fit in the table.
+  static uint32_t untrackedSites() { return s_untracked; }
+  static void reset();
+
+  static void markSteadyState();
+  static bool steadyState() { return s_steady; }
+  static uint32_t steadyStateAllocations() { return s_steadyAllocations; }
+  static uintptr_t firstSteadyStateCaller() { return s_firstSteadyCaller; }
+
+  static void recordAllocation(void* caller, size_t size);
+  static void recordFree() { ++s_totals[s_task].frees; }
+
+private:
+  static size_t s_task;
+  static AllocTotals s_totals[kOutsideTasks + 1];
+  static AllocSite s_sites[kMaxSites];
+  static size_t s_siteCount;
+  static uint32_t s_untracked;
+  static bool s_steady;
+  static uint32_t s_steadyAllocations;
+  static uintptr_t s_firstSteadyCaller;
+};
+
+}  // namespace DeviceCore
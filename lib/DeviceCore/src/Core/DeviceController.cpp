@@ -1,4 +1,7 @@
 #include "DeviceController.h"
+#include "AllocTrace.h"
+#include "FixedString.h"
+#include "Log.h"
 #include <ArduinoJson.h>
 
 namespace DeviceCore {
@@ -6,29 +9,79 @@ namespace DeviceCore {
 namespace {
 constexpr unsigned long kDefaultSerialBaud = 115200UL;
 constexpr size_t kDefaultSerialBufferLimit = 256;
-constexpr unsigned long kWifiRetryIntervalMs = 2000UL;
-constexpr unsigned long kMqttRetryIntervalMs = 2000UL;
+constexpr unsigned long kDefaultModbusTimeoutMs = 100UL;
+constexpr unsigned long kWifiRetryBaseMs = 2000UL;
+constexpr unsigned long kWifiRetryCapMs = 60000UL;
+constexpr unsigned long kWifiStableSessionMs = 60000UL;
 constexpr unsigned long kResetHoldDurationMs = 10000UL;
 constexpr unsigned long kWifiConnectTimeoutMs = 20000UL;
+constexpr unsigned long kFastConnectTimeoutMs = 6000UL;
+constexpr unsigned long kDirectedConnectTimeoutMs = 8000UL;
+constexpr unsigned long kScanMaxAgeMs = 30000UL;
+constexpr unsigned long kRoamCheckIntervalMs = 10000UL;
+constexpr unsigned long kRoamScanMaxAgeMs = 15000UL;
+constexpr unsigned long kRoamCooldownMs = 120000UL;
+constexpr int32_t kRoamRssiThreshold = -75;
+constexpr int32_t kRoamHysteresisDb = 8;
+constexpr unsigned long kLoopProbeReportIntervalMs = 60000UL;
+constexpr unsigned long kSchedulerReportIntervalMs = 60000UL;
+constexpr unsigned long kResetPollMs = 100UL;
+constexpr unsigned long kPortalPollMs = 100UL;
+constexpr unsigned long kProvisioningIdlePollMs = 250UL;
+constexpr unsigned long kWifiAssociatingPollMs = 50UL;
+constexpr unsigned long kConnectionPollMs = 250UL;
+constexpr unsigned long kMqttPollMs = 20UL;
+constexpr unsigned long kLedIdleRecheckMs = 1000UL;
+constexpr size_t kLogLinesPerPass = 4;
+// Keys and punctuation (208), seven 10-digit numbers, status and detail
+// (at most 32), and both topics at their longest.
+constexpr size_t kSettingsReplyCapacity = 208 + 7 * 10 + 32 + 2 * RuntimeSettings::kMaxTopicLength;
+
+const char* const kConnectionStateNames[] = {"idle", "scan", "wifi", "mqtt", "online"};
 }
 
 DeviceController* DeviceController::s_instance = nullptr;
 
 DeviceController::DeviceController(const DeviceConfig& config)
     : _config(config),
-      _mqttClient(_wifiClient),
+      _mqttTap(_mqttSocket),
+      _mqttClient(_mqttTap),
       _leds(config.pinUser1, config.pinErr, config.user1PulseDuration, config.errPulseDuration),
       _serialForwarder(config.serialBufferLimit),
-      _mqttLayer(_mqttClient, _config),
-      _credentialStore(),
-      _provisioningManager(_credentialStore, config.maintenancePhone, config.userManualUrl),
+      _modbusBus(_serialForwarder),
+      _modbusPoller(_modbusBus),
+      _mqttLayer(_mqttClient, _mqttSocket, _config),
+      _modbusGateway(_modbusBus, _mqttLayer, _config),
+      _modbusPollNext(false),
+      _settingsStore(_configJournal),
+      _credentialStore(_configJournal),
+      _scanCache(),
+      _provisioningManager(_credentialStore, _scanCache, config.maintenancePhone, config.userManualUrl),
   _credentials(),
+      _networks(),
+      _triedNetworks(0),
+      _directedJoin(false),
+      _lastRoamCheckMs(0),
+      _lastRoamMs(0),
       _heartbeatEnabled(true),
-      _lastWifiRetryMs(0),
+      _wifiReconnect("WiFi", kWifiRetryBaseMs, kWifiRetryCapMs, kWifiStableSessionMs),
       _lastProvisioningCheckMs(0),
       _resetPressStartMs(0),
       _resetTriggered(false),
   _wifiReady(false),
+      _connectionState(ConnectionState::Idle),
+      _connectOrigin(ConnectOrigin::Boot),
+      _connectStartMs(0),
+      _fastConnectActive(false),
+      _bootToFirstPublishMs(0),
+      _scheduler(kSchedulerReportIntervalMs),
+      _memory(_scheduler),
+      _metrics(_scheduler, _serialForwarder, _memory, _mqttLayer),
+      _memoryAlarmUnsent(false),
+      _ledTask(Scheduler::kInvalidTask),
+      _ledNetworkReady(false),
+      _logCursor(0),
+      _loopProbe(kLoopProbeReportIntervalMs),
   _initialSsid(config.ssid),
   _initialPassword(config.password) {
   if (_config.serialBufferLimit == 0) {
@@ -46,6 +99,9 @@ DeviceController::DeviceController(const DeviceConfig& config)
   if (_config.heartbeatInterval == 0) {
     _config.heartbeatInterval = 5000UL;
   }
+  if (_config.modbusTimeoutMs == 0) {
+    _config.modbusTimeoutMs = kDefaultModbusTimeoutMs;
+  }
 
   if (_config.pinReset == 0xFF) {
     _config.pinReset = 14;  // Default to GPIO14 if not set
@@ -54,13 +110,31 @@ DeviceController::DeviceController(const DeviceConfig& config)
   _ssidBuffer[0] = '\0';
   _passwordBuffer[0] = '\0';
 
+  _defaultSettings.capture(_config);
+  adoptSettings(_defaultSettings);
   _serialForwarder.resetBuffer(_config.serialBufferLimit);
-  _leds.setPulseDurations(_config.user1PulseDuration, _config.errPulseDuration);
+  _loopProbe.setStateNames(kConnectionStateNames, sizeof(kConnectionStateNames) / sizeof(kConnectionStateNames[0]));
 }
 
 void DeviceController::begin() {
   s_instance = this;
+  Log::begin(_config.logSinks);
+  _logCursor = Log::oldest();
+  RuntimeSettings stored;
+  if (_settingsStore.load(stored)) {
+    adoptSettings(stored);
+  }
   Serial.begin(_config.serialBaud);
+  // Credentials live in CredentialStore; skip the SDK's own flash copy.
+  WiFi.persistent(false);
+  _serialForwarder.begin(Serial, _config.serialRxDepth, _config.offlineQueueBytes);
+  _serialForwarder.setWakeHandler(&Scheduler::wake);
+  bool modbusGateway = _config.modbusRequestTopic && _config.modbusRequestTopic[0] != '\0';
+  if (_config.modbusBlockCount > 0 || modbusGateway) {
+    // Modbus shares the forwarder's UART and baud rate.
+    _modbusBus.begin(Serial, _config.modbusDePin, _config.modbusTimeoutMs);
+    _modbusPoller.begin(_config.modbusBlocks, _config.modbusBlockCount, millis());
+  }
 
   pinMode(_config.pinReset, INPUT_PULLUP);
 
@@ -69,77 +143,507 @@ void DeviceController::begin() {
   initializeCredentials();
 
   _mqttLayer.begin(DeviceController::mqttCallback);
+  _mqttLayer.attachTap(_mqttTap);
+  _commands.add(nullptr, "heartbeat", &DeviceController::onHeartbeatCommand, this);
+  if (_config.configTopic && _config.configTopic[0] != '\0') {
+    // Settings changes are persisted, so they are only taken from their own
+    // topic rather than from every topic the device listens on.
+    _commands.add(_config.configTopic, "config/set", &DeviceController::onConfigSetCommand, this);
+    _commands.add(_config.configTopic, "config/get", &DeviceController::onConfigGetCommand, this);
+    _commands.add(_config.configTopic, "config/reset", &DeviceController::onConfigResetCommand, this);
+  }
+  _commands.add(nullptr, "metrics/get", &DeviceController::onMetricsGetCommand, this);
+  if (AllocTrace::enabled()) {
+    _commands.add(nullptr, "mem/trace", &DeviceController::onAllocTraceCommand, this);
+  }
+  if (_modbusBus.enabled()) {
+    _modbusGateway.begin(_commands);
+  }
 
   if (_credentials.valid) {
-    if (!connectWifi()) {
-      startProvisioning();
-    }
+    startConnection(millis(), ConnectOrigin::Boot);
   } else {
     startProvisioning();
   }
 
-  _lastWifiRetryMs = millis();
   _lastProvisioningCheckMs = millis();
-  _leds.loop(millis(), WiFi.status() == WL_CONNECTED && _mqttLayer.isConnected());
+  _leds.loop(millis(), false);
+  _metrics.begin(millis());
+  registerTasks();
+  _memory.begin();
 }
 
 void DeviceController::loop() {
+  _loopProbe.beginIteration();
   unsigned long now = millis();
+  _scheduler.runDue(now);
+  _loopProbe.endIteration(now, static_cast<uint8_t>(_connectionState));
+  _scheduler.sleep(millis());
+}
+
+void DeviceController::registerTasks() {
+  _scheduler.addTask("reset", &DeviceController::runResetTask, this);
+  _scheduler.addTask("provisioning", &DeviceController::runProvisioningTask, this);
+  _scheduler.addTask("connection", &DeviceController::runConnectionTask, this);
+  _scheduler.addTask("mqtt", &DeviceController::runMqttTask, this, &DeviceController::mqttReady);
+  _scheduler.addTask("serial", &DeviceController::runSerialTask, this, &DeviceController::serialReady);
+  _ledTask = _scheduler.addTask("leds", &DeviceController::runLedTask, this);
+  if (_modbusPoller.enabled() || _modbusGateway.enabled()) {
+    _scheduler.addTask("modbus", &DeviceController::runModbusTask, this, &DeviceController::modbusReady);
+  }
+}
+
+unsigned long DeviceController::runResetTask(void* context, unsigned long now) {
+  DeviceController* self = static_cast<DeviceController*>(context);
+  self->handleResetButton(now);
+  return kResetPollMs;
+}
 
-  handleResetButton(now);
-  handleProvisioning(now);
+unsigned long DeviceController::runProvisioningTask(void* context, unsigned long now) {
+  DeviceController* self = static_cast<DeviceController*>(context);
+  self->handleProvisioning(now);
+  self->scheduleLeds(now);
+  return self->_provisioningManager.isProvisioning() ? kPortalPollMs : kProvisioningIdlePollMs;
+}
+
+unsigned long DeviceController::runConnectionTask(void* context, unsigned long now) {
+  DeviceController* self = static_cast<DeviceController*>(context);
+  self->advanceConnection(now);
+  self->scheduleLeds(now);
+  bool joining = self->_connectionState == ConnectionState::WifiScanning ||
+                 self->_connectionState == ConnectionState::WifiAssociating || self->_mqttLayer.connecting();
+  return joining ? kWifiAssociatingPollMs : kConnectionPollMs;
+}
 
-  bool provisioning = _provisioningManager.isProvisioning();
+unsigned long DeviceController::runMqttTask(void* context, unsigned long now) {
+  DeviceController* self = static_cast<DeviceController*>(context);
+  if (!self->mqttLinkUp()) {
+    return kConnectionPollMs;
+  }
 
-  if (!provisioning && _credentials.valid) {
-    ensureWifiConnected(now);
+  self->_mqttLayer.loop();
+  self->publishLogs();
+  if (self->_mqttLayer.handleHeartbeat(now, self->_heartbeatEnabled)) {
+    self->_leds.requestUserPulse(now);
+    self->scheduleLeds(now);
   }
 
-  bool wifiConnected = (!provisioning && _credentials.valid) ? (WiFi.status() == WL_CONNECTED) : false;
-  bool mqttConnected = false;
+  self->reportMemoryAlarm(now);
+  if (self->_metrics.due(now, self->_config.metricsIntervalMs)) {
+    self->_metrics.publish(now, self->_config.metricsTopic, true);
+  }
 
-  if (wifiConnected) {
-    mqttConnected = _mqttLayer.ensureConnected(now);
-    if (mqttConnected) {
-      _mqttLayer.loop();
-      if (_mqttLayer.handleHeartbeat(now, _heartbeatEnabled)) {
-        _leds.requestUserPulse(now);
-      }
+  unsigned long next = kMqttPollMs;
+  if (self->_heartbeatEnabled) {
+    unsigned long heartbeatIn = self->_mqttLayer.msUntilHeartbeat(now);
+    if (heartbeatIn < next) {
+      next = heartbeatIn;
     }
   }
+  return next;
+}
+
+bool DeviceController::mqttReady(void* context) {
+  DeviceController* self = static_cast<DeviceController*>(context);
+  return self->mqttLinkUp() && self->_mqttTap.available() > 0;
+}
+
+unsigned long DeviceController::runSerialTask(void* context, unsigned long now) {
+  DeviceController* self = static_cast<DeviceController*>(context);
+  unsigned long next = self->_serialForwarder.process(now, self->_config, self->wifiLinkUp(), self->mqttLinkUp(), self->_mqttLayer, self->_leds);
+  self->scheduleLeds(now);
+  return next;
+}
+
+bool DeviceController::serialReady(void* context) {
+  return static_cast<DeviceController*>(context)->_serialForwarder.hasInput();
+}
+
+unsigned long DeviceController::runLedTask(void* context, unsigned long now) {
+  DeviceController* self = static_cast<DeviceController*>(context);
+  self->_ledNetworkReady = self->wifiLinkUp() && self->mqttLinkUp();
+  self->_leds.loop(now, self->_ledNetworkReady);
+  unsigned long next = self->_leds.msUntilNextChange(now);
+  return next < kLedIdleRecheckMs ? next : kLedIdleRecheckMs;
+}
+
+unsigned long DeviceController::runModbusTask(void* context, unsigned long now) {
+  DeviceController* self = static_cast<DeviceController*>(context);
+  // Alternate gateway requests with polling so neither a burst of requests
+  // nor a long block table can monopolise the bus.
+  if (self->_modbusGateway.hasWork() && (!self->_modbusPollNext || !self->_modbusPoller.enabled())) {
+    self->_modbusGateway.run(now);
+    self->_modbusPollNext = true;
+    return 0;
+  }
+  self->_modbusPollNext = false;
+  unsigned long next = self->_modbusPoller.run(now, self->_config, self->_mqttLayer);
+  return self->_modbusGateway.hasWork() ? 0 : next;
+}
+
+bool DeviceController::modbusReady(void* context) {
+  return static_cast<DeviceController*>(context)->_modbusGateway.hasWork();
+}
+
+void DeviceController::publishLogs() {
+  if (!(Log::sinks() & kLogSinkMqtt) || !_config.logTopic || _config.logTopic[0] == '\0') {
+    return;
+  }
+
+  // Bounded per pass so a burst of diagnostics cannot delay forwarding.
+  char line[Log::kLineCapacity];
+  for (size_t i = 0; i < kLogLinesPerPass; ++i) {
+    uint32_t cursor = _logCursor;
+    size_t length = Log::readLine(cursor, line, sizeof(line));
+    if (length == 0) {
+      return;
+    }
+    if (!_mqttLayer.publish(_config.logTopic, reinterpret_cast<const uint8_t*>(line), length)) {
+      return;  // Retried from the same line next pass.
+    }
+    _logCursor = cursor;
+  }
+}
+
+void DeviceController::reportMemoryAlarm(unsigned long now) {
+  _memory.sampleLayout(now);
+  if (_memory.updateAlarm(_config.heapAlarmMinBlock) != MemoryAlarm::None) {
+    _memoryAlarmUnsent = true;
+  }
+  // The alarm payload is small and sent at QoS 0, so it still goes out
+  // while there is room for a segment; a failed send is retried next pass.
+  if (_memoryAlarmUnsent && _metrics.publishMemoryAlarm(_config.metricsTopic)) {
+    _memoryAlarmUnsent = false;
+  }
+}
+
+void DeviceController::scheduleLeds(unsigned long now) {
+  // Pulses requested by other tasks and link changes must not wait for the
+  // LED task's idle recheck.
+  bool networkReady = wifiLinkUp() && mqttLinkUp();
+  unsigned long next = networkReady != _ledNetworkReady ? 0 : _leds.msUntilNextChange(now);
+  if (next < kLedIdleRecheckMs) {
+    _scheduler.runSoon(_ledTask, next);
+  }
+}
 
-  _serialForwarder.process(now, _config, wifiConnected, mqttConnected, _mqttClient, _leds);
-  _leds.loop(now, wifiConnected && mqttConnected);
-  delay(10);
+bool DeviceController::wifiLinkUp() const {
+  return _connectionState == ConnectionState::MqttConnecting || _connectionState == ConnectionState::Online;
+}
+
+bool DeviceController::mqttLinkUp() const {
+  return _connectionState == ConnectionState::Online;
 }
 
 void DeviceController::setHeartbeatEnabled(bool enabled) {
   _heartbeatEnabled = enabled;
 }
 
-void DeviceController::ensureWifiConnected(unsigned long now) {
+void DeviceController::advanceConnection(unsigned long now) {
+  if (_provisioningManager.isProvisioning() || !_credentials.valid || !_config.ssid) {
+    _connectionState = ConnectionState::Idle;
+    return;
+  }
+
+  switch (_connectionState) {
+    case ConnectionState::Idle:
+      if (_wifiReconnect.shouldAttempt(now)) {
+        DC_LOG_INFO("WiFi", "Disconnected, retrying...");
+        startConnection(now, ConnectOrigin::Retry);
+      }
+      break;
+
+    case ConnectionState::WifiScanning:
+      _scanCache.poll(now);
+      if (_scanCache.scanning()) {
+        break;
+      }
+      if (_scanCache.fresh(now, kScanMaxAgeMs)) {
+        if (!connectToBestKnown(now)) {
+          DC_LOG_WARN("WiFi", "No known network in range.");
+          onWifiConnectFailed();
+        }
+      } else {
+        // Scan failed; fall back to an undirected join on the preferred network.
+        beginFullConnect();
+        _connectStartMs = now;
+        _connectionState = ConnectionState::WifiAssociating;
+      }
+      break;
+
+    case ConnectionState::WifiAssociating:
+      if (WiFi.status() == WL_CONNECTED) {
+        DC_LOG_INFO("WiFi", "Connected%s in ms: %lu, RSSI %ld", _fastConnectActive ? " (cached BSSID)" : "",
+                    now - _connectStartMs, static_cast<long>(WiFi.RSSI()));
+        // Network names and addresses stay at DEBUG, off the default sinks.
+        IPAddress ip = WiFi.localIP();
+        DC_LOG_DEBUG("WiFi", "IP %u.%u.%u.%u", static_cast<unsigned>(ip[0]), static_cast<unsigned>(ip[1]),
+                     static_cast<unsigned>(ip[2]), static_cast<unsigned>(ip[3]));
+        rememberWifiConnection();
+        if (_credentialStore.promote(_config.ssid)) {
+          reloadNetworks();
+        }
+        _wifiReconnect.onSuccess(now);
+        _wifiReady = true;
+        _lastRoamCheckMs = now;
+        _connectionState = ConnectionState::MqttConnecting;
+      } else if (_fastConnectActive && now - _connectStartMs >= kFastConnectTimeoutMs) {
+        DC_LOG_INFO("WiFi", "Cached parameters failed, selecting from a scan.");
+        _wifiCache.invalidate();
+        _fastConnectActive = false;
+        _connectStartMs = now;
+        if (_scanCache.request(now, kScanMaxAgeMs)) {
+          if (!connectToBestKnown(now)) {
+            beginFullConnect();
+          }
+        } else {
+          _connectionState = ConnectionState::WifiScanning;
+        }
+      } else if (now - _connectStartMs >= (_directedJoin ? kDirectedConnectTimeoutMs : kWifiConnectTimeoutMs)) {
+        if (_directedJoin && connectToBestKnown(now)) {
+          DC_LOG_WARN("WiFi", "Join timed out, trying next known network.");
+          break;
+        }
+        DC_LOG_WARN("WiFi", "Connection failed.");
+        _wifiReady = false;
+        onWifiConnectFailed();
+      }
+      break;
+
+    case ConnectionState::MqttConnecting:
+      if (WiFi.status() != WL_CONNECTED) {
+        _wifiReady = false;
+        _wifiReconnect.onDisconnected(now);
+        _connectionState = ConnectionState::Idle;
+      } else if (_mqttLayer.ensureConnected(now)) {
+        _connectionState = ConnectionState::Online;
+        onConnectionEstablished();
+      }
+      break;
+
+    case ConnectionState::Online:
+      if (WiFi.status() != WL_CONNECTED) {
+        _wifiReady = false;
+        _wifiReconnect.onDisconnected(now);
+        _connectionState = ConnectionState::Idle;
+      } else if (!_mqttLayer.isConnected()) {
+        _connectionState = ConnectionState::MqttConnecting;
+      } else {
+        maybeRoam(now);
+      }
+      break;
+  }
+}
+
+void DeviceController::startConnection(unsigned long now, ConnectOrigin origin) {
   if (!_credentials.valid || !_config.ssid) {
     return;
   }
 
-  if (WiFi.status() == WL_CONNECTED) {
+  WiFi.softAPdisconnect(true);
+  WiFi.mode(WIFI_STA);
+
+  _connectOrigin = origin;
+  _connectStartMs = now;
+  _triedNetworks = 0;
+  _directedJoin = false;
+  _wifiReconnect.onAttempt(now);
+  _connectionState = ConnectionState::WifiAssociating;
+
+  if (origin == ConnectOrigin::Provisioning && WiFi.status() == WL_CONNECTED) {
+    // The portal's test connect already joined this network; dropping the
+    // soft AP leaves the station association in place.
+    DC_LOG_INFO("WiFi", "Already connected by the provisioning test.");
+    rememberWifiConnection();
+    _wifiReconnect.onSuccess(now);
     _wifiReady = true;
+    _lastRoamCheckMs = now;
+    _connectionState = ConnectionState::MqttConnecting;
+  } else if (origin == ConnectOrigin::Provisioning) {
+    // Join exactly the network that was just entered.
+    beginFullConnect();
+    DC_LOG_INFO("WiFi", "Connecting");
+  } else if (tryFastConnect()) {
+    DC_LOG_INFO("WiFi", "Connecting (cached BSSID)");
+  } else if (_scanCache.request(now, kScanMaxAgeMs)) {
+    if (!connectToBestKnown(now)) {
+      beginFullConnect();
+      DC_LOG_INFO("WiFi", "Connecting");
+    }
+  } else {
+    DC_LOG_INFO("WiFi", "Scanning for known networks...");
+    _connectionState = ConnectionState::WifiScanning;
+  }
+}
+
+void DeviceController::beginFullConnect() {
+  // Zero addresses switch the station back to DHCP.
+  WiFi.config(IPAddress(0U), IPAddress(0U), IPAddress(0U));
+  WiFi.begin(_config.ssid, _config.password);
+  _fastConnectActive = false;
+  _directedJoin = false;
+}
+
+bool DeviceController::tryFastConnect() {
+  for (size_t i = 0; i < _networks.count; ++i) {
+    const StoredCredentials& network = _networks.entries[i];
+    WifiFastConnect cached;
+    if (!_wifiCache.load(network.ssid, network.password, cached)) {
+      continue;
+    }
+    // Directed join on the known channel and BSSID; the address comes from
+    // a fresh DHCP exchange.
+    applyCredentials(network);
+    WiFi.config(IPAddress(0U), IPAddress(0U), IPAddress(0U));
+    WiFi.begin(_config.ssid, _config.password, cached.channel, cached.bssid);
+    _triedNetworks |= static_cast<uint8_t>(1U << i);
+    _fastConnectActive = true;
+    return true;
+  }
+  return false;
+}
+
+bool DeviceController::connectToBestKnown(unsigned long now) {
+  int best = -1;
+  const ScannedNetwork* bestAp = nullptr;
+  for (size_t i = 0; i < _networks.count; ++i) {
+    if (_triedNetworks & (1U << i)) {
+      continue;
+    }
+    const ScannedNetwork* ap = _scanCache.strongest(_networks.entries[i].ssid);
+    if (ap && (!bestAp || ap->rssi > bestAp->rssi)) {
+      best = static_cast<int>(i);
+      bestAp = ap;
+    }
+  }
+  if (best < 0) {
+    return false;
+  }
+
+  joinAccessPoint(static_cast<size_t>(best), *bestAp, now);
+  return true;
+}
+
+void DeviceController::joinAccessPoint(size_t index, const ScannedNetwork& ap, unsigned long now) {
+  _triedNetworks |= static_cast<uint8_t>(1U << index);
+  applyCredentials(_networks.entries[index]);
+  WiFi.config(IPAddress(0U), IPAddress(0U), IPAddress(0U));
+  WiFi.begin(_config.ssid, _config.password, ap.channel, ap.bssid);
+  _fastConnectActive = false;
+  _directedJoin = true;
+  _connectStartMs = now;
+  _connectionState = ConnectionState::WifiAssociating;
+
+  DC_LOG_INFO("WiFi", "Connecting, strongest known AP: RSSI %ld dBm, channel %ld", static_cast<long>(ap.rssi),
+              static_cast<long>(ap.channel));
+}
+
+void DeviceController::maybeRoam(unsigned long now) {
+  if (now - _lastRoamCheckMs < kRoamCheckIntervalMs) {
+    return;
+  }
+  _lastRoamCheckMs = now;
+  if (_lastRoamMs != 0 && now - _lastRoamMs < kRoamCooldownMs) {
+    return;
+  }
+
+  int32_t rssi = WiFi.RSSI();
+  if (rssi >= kRoamRssiThreshold) {
+    return;
+  }
+  // The scan runs in the background while we stay associated; its results
+  // are picked up on a later check.
+  if (!_scanCache.request(now, kRoamScanMaxAgeMs)) {
     return;
   }
 
-  if (now - _lastWifiRetryMs < kWifiRetryIntervalMs) {
+  const uint8_t* currentBssid = WiFi.BSSID();
+  int best = -1;
+  const ScannedNetwork* bestAp = nullptr;
+  for (size_t i = 0; i < _networks.count; ++i) {
+    const ScannedNetwork* ap = _scanCache.strongest(_networks.entries[i].ssid, currentBssid);
+    if (ap && (!bestAp || ap->rssi > bestAp->rssi)) {
+      best = static_cast<int>(i);
+      bestAp = ap;
+    }
+  }
+  if (!bestAp || bestAp->rssi < rssi + kRoamHysteresisDb) {
     return;
   }
 
-  Serial.println("WiFi disconnected, retrying...");
-  _lastWifiRetryMs = now;
-  connectWifi();
+  DC_LOG_INFO("Roam", "RSSI %ld dBm, moving to known AP at %ld dBm", static_cast<long>(rssi), static_cast<long>(bestAp->rssi));
+
+  _lastRoamMs = now;
+  _connectOrigin = ConnectOrigin::Retry;
+  _triedNetworks = 0;
+  _wifiReady = false;
+  _wifiReconnect.onAttempt(now);
+  joinAccessPoint(static_cast<size_t>(best), *bestAp, now);
+}
+
+void DeviceController::reloadNetworks() {
+  StoredNetworks stored;
+  if (_credentialStore.loadAll(stored)) {
+    _networks = stored;
+  }
+}
+
+void DeviceController::rememberWifiConnection() {
+  WifiFastConnect entry;
+  const uint8_t* bssid = WiFi.BSSID();
+  if (bssid) {
+    memcpy(entry.bssid, bssid, sizeof(entry.bssid));
+  }
+  entry.channel = WiFi.channel();
+  _wifiCache.save(_config.ssid, _config.password, entry);
+}
+
+void DeviceController::onWifiConnectFailed() {
+  _connectionState = ConnectionState::Idle;
+  _wifiReconnect.onFailure(millis());
+
+  switch (_connectOrigin) {
+    case ConnectOrigin::Boot:
+      startProvisioning();
+      break;
+    case ConnectOrigin::Provisioning:
+      DC_LOG_WARN("Provisioning", "Connection failed, forgetting network and re-entering provisioning.");
+      _credentialStore.remove(_config.ssid);
+      _networks = StoredNetworks();
+      reloadNetworks();
+      if (_networks.count > 0) {
+        applyCredentials(_networks.entries[0]);
+      } else {
+        clearCredentials();
+      }
+      startProvisioning();
+      break;
+    case ConnectOrigin::Retry:
+      break;
+  }
+}
+
+void DeviceController::onConnectionEstablished() {
+  if (_bootToFirstPublishMs == 0) {
+    // tryConnect() has just published the hello message.
+    _bootToFirstPublishMs = millis();
+    DC_LOG_INFO("Boot", "First publish after ms: %lu", _bootToFirstPublishMs);
+    // Buffers are sized and the session is up; from here on tasks should
+    // not allocate.
+    AllocTrace::markSteadyState();
+  }
+  if (_connectOrigin == ConnectOrigin::Provisioning) {
+    stopProvisioning();
+  } else {
+    _leds.setErrBlinking(false);
+  }
+  _connectOrigin = ConnectOrigin::Retry;
 }
 
 void DeviceController::initializeCredentials() {
-  if (_credentialStore.load(_credentials)) {
-    Serial.println("[Credentials] Loaded from storage.");
-    applyCredentials(_credentials);
+  if (_credentialStore.loadAll(_networks)) {
+    DC_LOG_INFO("Credentials", "Known networks loaded from storage: %u", static_cast<unsigned>(_networks.count));
+    applyCredentials(_networks.entries[0]);
     return;
   }
 
@@ -152,7 +656,9 @@ void DeviceController::initializeCredentials() {
       defaults.password[sizeof(defaults.password) - 1] = '\0';
     }
     defaults.valid = true;
-    Serial.println("[Credentials] Using defaults from configuration.");
+    DC_LOG_INFO("Credentials", "Using defaults from configuration.");
+    _networks.entries[0] = defaults;
+    _networks.count = 1;
     applyCredentials(defaults);
     return;
   }
@@ -173,62 +679,19 @@ void DeviceController::applyCredentials(const StoredCredentials& creds) {
   _wifiReady = false;
 
   if (_credentials.valid) {
-    Serial.print("[Credentials] Active SSID: ");
-    Serial.println(_config.ssid);
+    DC_LOG_DEBUG("Credentials", "Active SSID: %s", _config.ssid);
   }
 }
 
 void DeviceController::clearCredentials() {
+  _wifiCache.invalidate();
   memset(_ssidBuffer, 0, sizeof(_ssidBuffer));
   memset(_passwordBuffer, 0, sizeof(_passwordBuffer));
   _config.ssid = nullptr;
   _config.password = nullptr;
   _credentials = StoredCredentials();
   _credentials.valid = false;
-}
-
-bool DeviceController::connectWifi() {
-  if (!_credentials.valid || !_config.ssid) {
-    return false;
-  }
-
-  WiFi.softAPdisconnect(true);
-  WiFi.mode(WIFI_STA);
-  WiFi.disconnect(true);
-  delay(100);
-  WiFi.begin(_config.ssid, _config.password);
-
-  _lastWifiRetryMs = millis();
-
-  Serial.print("Connecting to WiFi");
-  unsigned long start = millis();
-  while (WiFi.status() != WL_CONNECTED && millis() - start < kWifiConnectTimeoutMs) {
-    Serial.print(".");
-    delay(500);
-  }
-  Serial.println();
-
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("WiFi connected");
-    Serial.println(WiFi.localIP());
-    Serial.print("WiFi RSSI: ");
-    Serial.println(WiFi.RSSI());
-    _wifiReady = true;
-
-    // Ensure MQTT reconnect after Wi-Fi comes up
-    unsigned long now = millis();
-    while (!_mqttLayer.ensureConnected(now)) {
-      delay(kMqttRetryIntervalMs);
-      now = millis();
-    }
-
-    _leds.setErrBlinking(false);
-    return true;
-  }
-
-  Serial.println("WiFi connection failed.");
-  _wifiReady = false;
-  return false;
+  _networks = StoredNetworks();
 }
 
 void DeviceController::startProvisioning() {
@@ -257,16 +720,10 @@ void DeviceController::handleProvisioning(unsigned long now) {
   if (_provisioningManager.hasNewCredentials()) {
     StoredCredentials creds = _provisioningManager.consumeCredentials();
     if (creds.valid) {
-      Serial.println("[Provisioning] Credentials received, attempting connection.");
+      DC_LOG_INFO("Provisioning", "Credentials received, attempting connection.");
+      reloadNetworks();
       applyCredentials(creds);
-      if (connectWifi()) {
-        stopProvisioning();
-      } else {
-        Serial.println("[Provisioning] Connection failed, clearing credentials and re-entering provisioning.");
-        _credentialStore.clear();
-        clearCredentials();
-        startProvisioning();
-      }
+      startConnection(now, ConnectOrigin::Provisioning);
     }
   }
 
@@ -284,8 +741,11 @@ void DeviceController::handleResetButton(unsigned long now) {
       _resetPressStartMs = now;
     }
     if (!_resetTriggered && now - _resetPressStartMs >= kResetHoldDurationMs) {
-      Serial.println("[Reset] Hold detected, clearing credentials.");
+      DC_LOG_WARN("Reset", "Hold detected, clearing credentials and settings.");
       _credentialStore.clear();
+      // A bad baud rate or topic saved over MQTT must be recoverable here.
+      _settingsStore.clear();
+      applySettings(_defaultSettings);
       clearCredentials();
       _resetTriggered = true;
       startProvisioning();
@@ -306,26 +766,122 @@ void DeviceController::mqttCallback(char* topic, byte* payload, unsigned int len
 }
 
 void DeviceController::onMqttMessage(char* topic, byte* payload, unsigned int length) {
-  Serial.print("Message arrived [");
-  Serial.print(topic);
-  Serial.print("]: ");
-
-  String msg;
-  for (unsigned int i = 0; i < length; i++) {
-    Serial.print(static_cast<char>(payload[i]));
-    msg += static_cast<char>(payload[i]);
-  }
-  Serial.println();
-
-  JsonDocument doc;
-  if (deserializeJson(doc, msg) == DeserializationError::Ok) {
-    if (doc["cmd"] == "heartbeat") {
-      bool enable = doc["enable"];
-      setHeartbeatEnabled(enable);
-      Serial.print("[MQTT] Heartbeat switched to: ");
-      Serial.println(enable ? "ON" : "OFF");
-    }
+  DC_LOG_DEBUG("MQTT", "Message arrived [%s]: %.*s", topic, static_cast<int>(length), reinterpret_cast<const char*>(payload));
+
+  _commands.dispatch(topic, payload, length);
+}
+
+void DeviceController::onHeartbeatCommand(void* context, JsonVariantConst message) {
+  DeviceController* self = static_cast<DeviceController*>(context);
+  bool enable = message["enable"];
+  self->setHeartbeatEnabled(enable);
+  DC_LOG_INFO("MQTT", "Heartbeat switched to: %s", enable ? "ON" : "OFF");
+}
+
+void DeviceController::onConfigSetCommand(void* context, JsonVariantConst message) {
+  DeviceController* self = static_cast<DeviceController*>(context);
+  RuntimeSettings staged;
+  const char* badField = nullptr;
+  if (!stageSettings(self->_settings, message, SerialForwarder::kBufferCapacity, staged, badField)) {
+    DC_LOG_WARN("Config", "Rejected change, invalid field: %s", badField);
+    self->publishSettings("rejected", badField);
+    return;
+  }
+
+  self->applySettings(staged);
+  bool persisted = self->_settingsStore.save(self->_settings);
+  if (!persisted) {
+    DC_LOG_ERROR("Config", "Applied, but saving to flash failed.");
+  }
+  self->publishSettings("applied", persisted ? nullptr : "not persisted");
+}
+
+void DeviceController::onConfigGetCommand(void* context, JsonVariantConst message) {
+  static_cast<DeviceController*>(context)->publishSettings("current", nullptr);
+}
+
+void DeviceController::onConfigResetCommand(void* context, JsonVariantConst message) {
+  DeviceController* self = static_cast<DeviceController*>(context);
+  self->applySettings(self->_defaultSettings);
+  self->_settingsStore.clear();
+  DC_LOG_INFO("Config", "Restored compiled-in settings.");
+  self->publishSettings("reset", nullptr);
+}
+
+void DeviceController::onMetricsGetCommand(void* context, JsonVariantConst message) {
+  DeviceController* self = static_cast<DeviceController*>(context);
+  self->_metrics.publish(millis(), self->_config.metricsTopic, false);
+}
+
+void DeviceController::onAllocTraceCommand(void* context, JsonVariantConst message) {
+  DeviceController* self = static_cast<DeviceController*>(context);
+  self->_metrics.publishAllocTrace(self->_config.metricsTopic);
+}
+
+void DeviceController::adoptSettings(const RuntimeSettings& settings) {
+  if (&settings != &_settings) {
+    _settings = settings;
+  }
+  _config.heartbeatInterval = _settings.heartbeatInterval;
+  _config.user1PulseDuration = _settings.user1PulseDuration;
+  _config.errPulseDuration = _settings.errPulseDuration;
+  _config.serialBaud = _settings.serialBaud;
+  _config.serialBatchMaxBytes = _settings.serialBatchMaxBytes;
+  _config.serialBatchMaxLatencyMs = _settings.serialBatchMaxLatencyMs;
+  _config.primaryTopic = _settings.primaryTopic[0] != '\0' ? _settings.primaryTopic : nullptr;
+  _config.serialTopic = _settings.serialTopic[0] != '\0' ? _settings.serialTopic : nullptr;
+  _leds.setPulseDurations(_config.user1PulseDuration, _config.errPulseDuration);
+
+  if (_config.serialBufferLimit != _settings.serialBufferLimit) {
+    _config.serialBufferLimit = _settings.serialBufferLimit;
+    _serialForwarder.resetBuffer(_config.serialBufferLimit);
+  }
+}
+
+void DeviceController::applySettings(const RuntimeSettings& settings) {
+  // adoptSettings() repoints the topics into _settings, so keep the old
+  // names around for the resubscribe.
+  char oldPrimary[RuntimeSettings::kMaxTopicLength + 1];
+  char oldSerial[RuntimeSettings::kMaxTopicLength + 1];
+  memcpy(oldPrimary, _settings.primaryTopic, sizeof(oldPrimary));
+  memcpy(oldSerial, _settings.serialTopic, sizeof(oldSerial));
+  unsigned long oldBaud = _config.serialBaud;
+
+  adoptSettings(settings);
+
+  if (_config.serialBaud != oldBaud) {
+    Serial.flush();
+    Serial.updateBaudRate(_config.serialBaud);
+  }
+  if (strcmp(oldPrimary, _settings.primaryTopic) != 0 || strcmp(oldSerial, _settings.serialTopic) != 0) {
+    _mqttLayer.resubscribe(oldPrimary, oldSerial);
+  }
+}
+
+// Replies go to the config topic the command came in on, which a topic
+// change cannot move.
+void DeviceController::publishSettings(const char* status, const char* detail) {
+  if (!_config.configTopic || !mqttLinkUp()) {
+    return;
+  }
+
+  FixedString<kSettingsReplyCapacity> reply;
+  if (!reply.appendf("{\"config\":\"%s\",\"detail\":\"%s\",\"heartbeatInterval\":%lu,"
+                     "\"user1PulseDuration\":%lu,\"errPulseDuration\":%lu,\"serialBufferLimit\":%lu,"
+                     "\"serialBaud\":%lu,\"serialBatchMaxBytes\":%lu,\"serialBatchMaxLatencyMs\":%lu,"
+                     "\"primaryTopic\":\"%s\",\"serialTopic\":\"%s\"}",
+                     status, detail ? detail : "",
+                     static_cast<unsigned long>(_settings.heartbeatInterval),
+                     static_cast<unsigned long>(_settings.user1PulseDuration),
+                     static_cast<unsigned long>(_settings.errPulseDuration),
+                     static_cast<unsigned long>(_settings.serialBufferLimit),
+                     static_cast<unsigned long>(_settings.serialBaud),
+                     static_cast<unsigned long>(_settings.serialBatchMaxBytes),
+                     static_cast<unsigned long>(_settings.serialBatchMaxLatencyMs),
+                     _settings.primaryTopic, _settings.serialTopic)) {
+    return;
   }
+  _mqttLayer.publish(_config.configTopic, reply);
 }
 
 }  // namespace DeviceCore
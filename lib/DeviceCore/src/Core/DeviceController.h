@@ -5,13 +5,39 @@
 #include <PubSubClient.h>
 #include "../Config/DeviceConfig.h"
 #include "../Storage/CredentialStore.h"
+#include "../Storage/RtcWifiCache.h"
+#include "../Storage/SettingsStore.h"
+#include "../Config/RuntimeSettings.h"
 #include "../Network/ProvisioningManager.h"
 #include "../Network/MqttLayer.h"
+#include "../Network/CommandDispatcher.h"
+#include "../Network/WifiScanCache.h"
 #include "../Hardware/LedSubsystem.h"
 #include "../Hardware/SerialForwarder.h"
+#include "../Hardware/ModbusBus.h"
+#include "../Hardware/ModbusPoller.h"
+#include "../Hardware/ModbusGateway.h"
+#include "LoopProbe.h"
+#include "MemoryMonitor.h"
+#include "MetricsReporter.h"
+#include "Scheduler.h"
 
 namespace DeviceCore {
 
+enum class ConnectionState : uint8_t {
+  Idle,
+  WifiScanning,
+  WifiAssociating,
+  MqttConnecting,
+  Online,
+};
+
+enum class ConnectOrigin : uint8_t {
+  Boot,
+  Provisioning,
+  Retry,
+};
+
 class DeviceController {
 public:
   explicit DeviceController(const DeviceConfig& config);
@@ -21,26 +47,60 @@ public:
 
   void setHeartbeatEnabled(bool enabled);
   bool heartbeatEnabled() const { return _heartbeatEnabled; }
+  ConnectionState connectionState() const { return _connectionState; }
+  unsigned long bootToFirstPublishMs() const { return _bootToFirstPublishMs; }
+  const ReconnectStats& wifiReconnectStats() const { return _wifiReconnect.stats(); }
+  const ReconnectStats& mqttReconnectStats() const { return _mqttLayer.reconnectStats(); }
 
 private:
   static DeviceController* s_instance;
 
   DeviceConfig _config;
-  WiFiClient _wifiClient;
+  AsyncTcpClient _mqttSocket;
+  MqttTapClient _mqttTap;
   PubSubClient _mqttClient;
 
   LedSubsystem _leds;
   SerialForwarder _serialForwarder;
+  ModbusBus _modbusBus;
+  ModbusPoller _modbusPoller;
   MqttLayer _mqttLayer;
+  ModbusGateway _modbusGateway;
+  bool _modbusPollNext;
+  CommandDispatcher _commands;
+  RuntimeSettings _defaultSettings;
+  RuntimeSettings _settings;
+  ConfigJournal _configJournal;
+  SettingsStore _settingsStore;
   CredentialStore _credentialStore;
+  WifiScanCache _scanCache;
   ProvisioningManager _provisioningManager;
   StoredCredentials _credentials;
+  StoredNetworks _networks;
+  uint8_t _triedNetworks;
+  bool _directedJoin;
+  unsigned long _lastRoamCheckMs;
+  unsigned long _lastRoamMs;
   bool _heartbeatEnabled;
-  unsigned long _lastWifiRetryMs;
+  ReconnectPolicy _wifiReconnect;
   unsigned long _lastProvisioningCheckMs;
   unsigned long _resetPressStartMs;
   bool _resetTriggered;
   bool _wifiReady;
+  ConnectionState _connectionState;
+  ConnectOrigin _connectOrigin;
+  unsigned long _connectStartMs;
+  RtcWifiCache _wifiCache;
+  bool _fastConnectActive;
+  unsigned long _bootToFirstPublishMs;
+  Scheduler _scheduler;
+  MemoryMonitor _memory;
+  MetricsReporter _metrics;
+  bool _memoryAlarmUnsent;
+  int _ledTask;
+  bool _ledNetworkReady;
+  uint32_t _logCursor;
+  LoopProbe _loopProbe;
   char _ssidBuffer[33];
   char _passwordBuffer[65];
   const char* _initialSsid;
@@ -48,15 +108,51 @@ private:
 
   static void mqttCallback(char* topic, byte* payload, unsigned int length);
 
+  static unsigned long runResetTask(void* context, unsigned long now);
+  static unsigned long runProvisioningTask(void* context, unsigned long now);
+  static unsigned long runConnectionTask(void* context, unsigned long now);
+  static unsigned long runMqttTask(void* context, unsigned long now);
+  static bool mqttReady(void* context);
+  static unsigned long runSerialTask(void* context, unsigned long now);
+  static bool serialReady(void* context);
+  static unsigned long runLedTask(void* context, unsigned long now);
+  static unsigned long runModbusTask(void* context, unsigned long now);
+  static bool modbusReady(void* context);
+
   void onMqttMessage(char* topic, byte* payload, unsigned int length);
+  static void onHeartbeatCommand(void* context, JsonVariantConst message);
+  static void onConfigSetCommand(void* context, JsonVariantConst message);
+  static void onConfigGetCommand(void* context, JsonVariantConst message);
+  static void onConfigResetCommand(void* context, JsonVariantConst message);
+  static void onMetricsGetCommand(void* context, JsonVariantConst message);
+  static void onAllocTraceCommand(void* context, JsonVariantConst message);
+
+  void adoptSettings(const RuntimeSettings& settings);
+  void applySettings(const RuntimeSettings& settings);
+  void publishSettings(const char* status, const char* detail);
 
-  void ensureWifiConnected(unsigned long now);
+  void registerTasks();
+  void scheduleLeds(unsigned long now);
+  void publishLogs();
+  void reportMemoryAlarm(unsigned long now);
+  bool wifiLinkUp() const;
+  bool mqttLinkUp() const;
+  void advanceConnection(unsigned long now);
+  void startConnection(unsigned long now, ConnectOrigin origin);
+  void beginFullConnect();
+  bool tryFastConnect();
+  bool connectToBestKnown(unsigned long now);
+  void joinAccessPoint(size_t index, const ScannedNetwork& ap, unsigned long now);
+  void maybeRoam(unsigned long now);
+  void reloadNetworks();
+  void rememberWifiConnection();
+  void onWifiConnectFailed();
+  void onConnectionEstablished();
   void initializeCredentials();
   void startProvisioning();
   void stopProvisioning();
   void handleProvisioning(unsigned long now);
   void handleResetButton(unsigned long now);
-  bool connectWifi();
   void applyCredentials(const StoredCredentials& creds);
   void clearCredentials();
 };
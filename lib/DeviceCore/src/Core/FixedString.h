@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Arduino.h>
+#include <cstdarg>
+#include <cstring>
+
+namespace DeviceCore {
+
+// String with its storage inline, used wherever text is built at run time
+// so steady-state operation never touches the heap. Capacity excludes the
+// terminator. An append that does not fit is truncated and sets
+// overflowed(), which stays set until clear(); every append returns false
+// from then on, so callers need only check the last one.
+template <size_t N>
+class FixedString {
+public:
+  static constexpr size_t kCapacity = N;
+
+  FixedString() { clear(); }
+  explicit FixedString(const char* text) {
+    clear();
+    append(text);
+  }
+
+  void clear() {
+    _length = 0;
+    _data[0] = '\0';
+    _overflow = false;
+  }
+
+  bool append(const char* text) { return text ? append(text, strlen(text)) : true; }
+
+  bool append(const char* text, size_t length) {
+    size_t room = N - _length;
+    if (length > room) {
+      length = room;
+      _overflow = true;
+    }
+    memcpy(_data + _length, text, length);
+    _length += length;
+    _data[_length] = '\0';
+    return !_overflow;
+  }
+
+  bool append(char ch) { return append(&ch, 1); }
+
+  bool appendf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    va_list args;
+    va_start(args, format);
+    bool fits = vappendf(format, args);
+    va_end(args);
+    return fits;
+  }
+
+  bool vappendf(const char* format, va_list args) {
+    int written = vsnprintf(_data + _length, N + 1 - _length, format, args);
+    if (written < 0) {
+      _data[_length] = '\0';
+      _overflow = true;
+    } else if (static_cast<size_t>(written) > N - _length) {
+      _length = N;
+      _overflow = true;
+    } else {
+      _length += static_cast<size_t>(written);
+    }
+    return !_overflow;
+  }
+
+  // Cuts back to length characters and clears overflowed(), so a caller can
+  // undo an append that did not fit and publish what it has so far.
+  void truncate(size_t length) {
+    if (length < _length) {
+      _length = length;
+      _data[_length] = '\0';
+    }
+    _overflow = false;
+  }
+
+  const char* c_str() const { return _data; }
+  const uint8_t* bytes() const { return reinterpret_cast<const uint8_t*>(_data); }
+  size_t length() const { return _length; }
+  bool empty() const { return _length == 0; }
+  bool overflowed() const { return _overflow; }
+
+  bool operator==(const char* text) const { return text && strcmp(_data, text) == 0; }
+  bool operator!=(const char* text) const { return !(*this == text); }
+
+private:
+  char _data[N + 1];
+  size_t _length;
+  bool _overflow;
+};
+
+}  // namespace DeviceCore
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace DeviceCore {
+
+// Fixed log2 histogram: bucket i counts samples in [2^i, 2^(i+1)), with 0
+// and 1 both in bucket 0 and everything from 2^(kBuckets-1) up in the last.
+// The unit is the caller's; recording is a count-leading-zeros and an add.
+class LatencyHistogram {
+public:
+  static constexpr size_t kBuckets = 24;
+
+  LatencyHistogram() { reset(); }
+
+  void record(uint32_t value) {
+    size_t bucket = value < 2 ? 0 : 31 - __builtin_clz(value);
+    if (bucket >= kBuckets) {
+      bucket = kBuckets - 1;
+    }
+    ++_counts[bucket];
+    ++_samples;
+    if (value > _max) {
+      _max = value;
+    }
+  }
+
+  void reset() {
+    for (size_t i = 0; i < kBuckets; ++i) {
+      _counts[i] = 0;
+    }
+    _samples = 0;
+    _max = 0;
+  }
+
+  uint32_t count(size_t bucket) const { return bucket < kBuckets ? _counts[bucket] : 0; }
+  uint32_t samples() const { return _samples; }
+  uint32_t max() const { return _max; }
+  // Number of buckets up to and including the highest non-empty one.
+  size_t usedBuckets() const {
+    size_t used = kBuckets;
+    while (used > 0 && _counts[used - 1] == 0) {
+      --used;
+    }
+    return used;
+  }
+
+private:
+  uint32_t _counts[kBuckets];
+  uint32_t _samples;
+  uint32_t _max;
+};
+
+}  // namespace DeviceCore
@@ -0,0 +1,98 @@
+#include "Log.h"
+#include <cstdarg>
+
+namespace DeviceCore {
+
+namespace {
+constexpr unsigned long kSerial1Baud = 115200UL;
+const char kLevelLetters[] = "-EWID";
+}  // namespace
+
+uint8_t Log::s_sinks = 0;
+char Log::s_ring[Log::kRingCapacity];
+uint32_t Log::s_head = 0;
+uint32_t Log::s_tail = 0;
+uint32_t Log::s_serial1Dropped = 0;
+
+void Log::begin(uint8_t sinks) {
+  s_sinks = sinks;
+  if (sinks & kLogSinkSerial1) {
+    Serial1.begin(kSerial1Baud);
+  }
+}
+
+void Log::write(LogLevel level, const char* tag, const char* format, ...) {
+  if (s_sinks == 0) {
+    return;
+  }
+
+  char line[kLineCapacity];
+  uint8_t index = static_cast<uint8_t>(level);
+  int prefix = snprintf(line, sizeof(line), "%lu %c [%s] ", millis(),
+                        index < sizeof(kLevelLetters) - 1 ? kLevelLetters[index] : '?', tag);
+  if (prefix < 0 || static_cast<size_t>(prefix) >= sizeof(line)) {
+    return;
+  }
+  va_list args;
+  va_start(args, format);
+  int body = vsnprintf_P(line + prefix, sizeof(line) - prefix, format, args);
+  va_end(args);
+  size_t length = static_cast<size_t>(prefix);
+  if (body > 0) {
+    size_t room = sizeof(line) - 1 - length;
+    length += static_cast<size_t>(body) < room ? static_cast<size_t>(body) : room;
+  }
+
+  if (s_sinks & kLogSinkSerial1) {
+    // Never stall the loop on the debug UART; a skipped line is cheaper.
+    if (static_cast<size_t>(Serial1.availableForWrite()) > length) {
+      Serial1.write(line, length);
+      Serial1.write('\n');
+    } else {
+      ++s_serial1Dropped;
+    }
+  }
+  if (s_sinks & (kLogSinkRing | kLogSinkMqtt)) {
+    append(line, length);
+  }
+}
+
+void Log::append(const char* line, size_t length) {
+  // Evict whole lines from the tail until the new one fits.
+  while (s_head + length + 1 - s_tail > kRingCapacity) {
+    while (s_tail != s_head && s_ring[s_tail++ & (kRingCapacity - 1)] != '\n') {
+    }
+  }
+  for (size_t i = 0; i < length; ++i) {
+    s_ring[s_head++ & (kRingCapacity - 1)] = line[i];
+  }
+  s_ring[s_head++ & (kRingCapacity - 1)] = '\n';
+}
+
+uint32_t Log::oldest() {
+  return s_tail;
+}
+
+size_t Log::readLine(uint32_t& cursor, char* out, size_t capacity) {
+  if (static_cast<int32_t>(cursor - s_tail) < 0) {
+    cursor = s_tail;
+  }
+  if (cursor == s_head || capacity == 0) {
+    return 0;
+  }
+
+  size_t length = 0;
+  while (cursor != s_head) {
+    char ch = s_ring[cursor++ & (kRingCapacity - 1)];
+    if (ch == '\n') {
+      break;
+    }
+    if (length + 1 < capacity) {
+      out[length++] = ch;
+    }
+  }
+  out[length] = '\0';
+  return length;
+}
+
+}  // namespace DeviceCore
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define DEVICECORE_LOG_LEVEL_NONE 0
+#define DEVICECORE_LOG_LEVEL_ERROR 1
+#define DEVICECORE_LOG_LEVEL_WARN 2
+#define DEVICECORE_LOG_LEVEL_INFO 3
+#define DEVICECORE_LOG_LEVEL_DEBUG 4
+
+// Messages above this level compile to dead code; their arguments are never
+// evaluated and their format strings are not emitted.
+#ifndef DEVICECORE_LOG_LEVEL
+#define DEVICECORE_LOG_LEVEL DEVICECORE_LOG_LEVEL_INFO
+#endif
+
+#ifndef DEVICECORE_LOG_LINE_BYTES
+#define DEVICECORE_LOG_LINE_BYTES 160
+#endif
+
+#ifndef DEVICECORE_LOG_RING_BYTES
+#define DEVICECORE_LOG_RING_BYTES 2048
+#endif
+
+namespace DeviceCore {
+
+enum class LogLevel : uint8_t {
+  Error = DEVICECORE_LOG_LEVEL_ERROR,
+  Warn = DEVICECORE_LOG_LEVEL_WARN,
+  Info = DEVICECORE_LOG_LEVEL_INFO,
+  Debug = DEVICECORE_LOG_LEVEL_DEBUG,
+};
+
+// Bits for DeviceConfig::logSinks.
+enum LogSink : uint8_t {
+  kLogSinkSerial1 = 0x01,  // TX-only UART on GPIO2
+  kLogSinkRing = 0x02,     // in-RAM history, read back with readLine()
+  kLogSinkMqtt = 0x04,     // ring drained to DeviceConfig::logTopic by the MQTT task
+};
+
+// Diagnostics that stay off the forwarded UART. Format strings live in
+// flash; each line is formatted once into a stack buffer and handed to the
+// enabled sinks. Lines are written from loop context only, so the ring
+// needs no locking; lwIP and timer callbacks record what happened and leave
+// the logging to the loop.
+class Log {
+public:
+  static constexpr size_t kLineCapacity = DEVICECORE_LOG_LINE_BYTES;
+  static constexpr size_t kRingCapacity = DEVICECORE_LOG_RING_BYTES;
+  static_assert((kRingCapacity & (kRingCapacity - 1)) == 0, "Log ring capacity must be a power of two");
+
+  static void begin(uint8_t sinks);
+  static uint8_t sinks() { return s_sinks; }
+
+  static void write(LogLevel level, const char* tag, const char* format, ...)
+      __attribute__((format(printf, 3, 4)));
+  // Target of stripped levels: keeps the arguments type-checked and "used"
+  // inside dead code, so nothing reaches the binary.
+  __attribute__((format(printf, 1, 2))) static void discard(const char* format, ...) {}
+
+  // Ring cursors are absolute byte offsets. oldest() is the first line still
+  // held; readLine() copies the line at cursor (skipping ahead if it has
+  // been overwritten) and advances cursor. Returns 0 once caught up.
+  static uint32_t oldest();
+  static uint32_t newest() { return s_head; }
+  static size_t readLine(uint32_t& cursor, char* out, size_t capacity);
+  // Lines skipped on Serial1 rather than blocking on a full TX FIFO.
+  static uint32_t serial1Dropped() { return s_serial1Dropped; }
+
+private:
+  static uint8_t s_sinks;
+  static char s_ring[kRingCapacity];
+  static uint32_t s_head;
+  static uint32_t s_tail;
+  static uint32_t s_serial1Dropped;
+
+  static void append(const char* line, size_t length);
+};
+
+}  // namespace DeviceCore
+
+#define DEVICECORE_LOG_AT(level, tag, format, ...) \
+  ::DeviceCore::Log::write(level, tag, PSTR(format), ##__VA_ARGS__)
+
+#define DEVICECORE_LOG_DISCARD(format, ...)            \
+  do {                                                 \
+    if (false) {                                       \
+      ::DeviceCore::Log::discard(format, ##__VA_ARGS__); \
+    }                                                  \
+  } while (0)
+
+#if DEVICECORE_LOG_LEVEL >= DEVICECORE_LOG_LEVEL_ERROR
+#define DC_LOG_ERROR(tag, format, ...) DEVICECORE_LOG_AT(::DeviceCore::LogLevel::Error, tag, format, ##__VA_ARGS__)
+#else
+#define DC_LOG_ERROR(tag, format, ...) DEVICECORE_LOG_DISCARD(format, ##__VA_ARGS__)
+#endif
+
+#if DEVICECORE_LOG_LEVEL >= DEVICECORE_LOG_LEVEL_WARN
+#define DC_LOG_WARN(tag, format, ...) DEVICECORE_LOG_AT(::DeviceCore::LogLevel::Warn, tag, format, ##__VA_ARGS__)
+#else
+#define DC_LOG_WARN(tag, format, ...) DEVICECORE_LOG_DISCARD(format, ##__VA_ARGS__)
+#endif
+
+#if DEVICECORE_LOG_LEVEL >= DEVICECORE_LOG_LEVEL_INFO
+#define DC_LOG_INFO(tag, format, ...) DEVICECORE_LOG_AT(::DeviceCore::LogLevel::Info, tag, format, ##__VA_ARGS__)
+#else
+#define DC_LOG_INFO(tag, format, ...) DEVICECORE_LOG_DISCARD(format, ##__VA_ARGS__)
+#endif
+
+#if DEVICECORE_LOG_LEVEL >= DEVICECORE_LOG_LEVEL_DEBUG
+#define DC_LOG_DEBUG(tag, format, ...) DEVICECORE_LOG_AT(::DeviceCore::LogLevel::Debug, tag, format, ##__VA_ARGS__)
+#else
+#define DC_LOG_DEBUG(tag, format, ...) DEVICECORE_LOG_DISCARD(format, ##__VA_ARGS__)
+#endif
@@ -0,0 +1,83 @@
+#include "LoopProbe.h"
+#include "Log.h"
+
+namespace DeviceCore {
+
+LoopProbe::LoopProbe(unsigned long reportIntervalMs)
+    : _reportIntervalMs(reportIntervalMs),
+      _windowStartMs(0),
+      _iterationStartUs(0),
+      _stateNames(nullptr),
+      _stateCount(0),
+      _windowIterations(0),
+      _windowTotalUs(0) {
+  reset();
+}
+
+void LoopProbe::setStateNames(const char* const* names, size_t count) {
+  _stateNames = names;
+  _stateCount = count > kMaxStates ? kMaxStates : count;
+}
+
+void LoopProbe::beginIteration() {
+  _iterationStartUs = micros();
+}
+
+void LoopProbe::endIteration(unsigned long now, uint8_t state) {
+  unsigned long elapsed = micros() - _iterationStartUs;
+  if (state >= kMaxStates) {
+    state = kMaxStates - 1;
+  }
+  if (elapsed > _windowWorstUs[state]) {
+    _windowWorstUs[state] = elapsed;
+  }
+  if (elapsed > _allTimeWorstUs[state]) {
+    _allTimeWorstUs[state] = elapsed;
+  }
+  ++_windowIterations;
+  _windowTotalUs += elapsed;
+
+  if (_reportIntervalMs && now - _windowStartMs >= _reportIntervalMs) {
+    report(now);
+  }
+}
+
+unsigned long LoopProbe::worstMicros(uint8_t state) const {
+  return state < kMaxStates ? _allTimeWorstUs[state] : 0;
+}
+
+void LoopProbe::reset() {
+  for (size_t i = 0; i < kMaxStates; ++i) {
+    _windowWorstUs[i] = 0;
+    _allTimeWorstUs[i] = 0;
+  }
+  _windowIterations = 0;
+  _windowTotalUs = 0;
+}
+
+void LoopProbe::report(unsigned long now) {
+  char worst[96];
+  size_t length = 0;
+  worst[0] = '\0';
+  for (size_t i = 0; i < kMaxStates; ++i) {
+    if (_windowWorstUs[i] == 0) {
+      continue;
+    }
+    int written = _stateNames && i < _stateCount
+                      ? snprintf(worst + length, sizeof(worst) - length, ", max us [%s]: %lu", _stateNames[i], _windowWorstUs[i])
+                      : snprintf(worst + length, sizeof(worst) - length, ", max us [%u]: %lu", static_cast<unsigned int>(i), _windowWorstUs[i]);
+    if (written > 0 && length + static_cast<size_t>(written) < sizeof(worst)) {
+      length += static_cast<size_t>(written);
+    }
+    _windowWorstUs[i] = 0;
+  }
+  worst[length] = '\0';
+  DC_LOG_INFO("LoopProbe", "iterations: %lu, avg us: %lu%s", static_cast<unsigned long>(_windowIterations),
+              _windowIterations ? _windowTotalUs / _windowIterations : 0UL, worst);
+
+  _windowStartMs = now;
+  _windowIterations = 0;
+  _windowTotalUs = 0;
+}
+
+}  // namespace DeviceCore
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace DeviceCore {
+
+// Measures how long each DeviceController::loop iteration spends doing work
+// and keeps the worst case per connection state. A summary is printed every
+// reporting window so stalls in a particular state stand out.
+class LoopProbe {
+public:
+  static constexpr size_t kMaxStates = 8;
+
+  explicit LoopProbe(unsigned long reportIntervalMs);
+
+  void setStateNames(const char* const* names, size_t count);
+  void beginIteration();
+  void endIteration(unsigned long now, uint8_t state);
+
+  unsigned long worstMicros(uint8_t state) const;
+  void reset();
+
+private:
+  unsigned long _reportIntervalMs;
+  unsigned long _windowStartMs;
+  unsigned long _iterationStartUs;
+  const char* const* _stateNames;
+  size_t _stateCount;
+  unsigned long _windowWorstUs[kMaxStates];
+  unsigned long _allTimeWorstUs[kMaxStates];
+  uint32_t _windowIterations;
+  unsigned long _windowTotalUs;
+
+  void report(unsigned long now);
+};
+
+}  // namespace DeviceCore
@@ -0,0 +1,111 @@
+#include "MemoryMonitor.h"
+#include "AllocTrace.h"
+#include "Log.h"
+
+namespace DeviceCore {
+
+namespace {
+// Keeps the alarm from flapping on a block size that hovers at the limit.
+constexpr uint32_t kAlarmHysteresisBytes = 1024;
+constexpr unsigned long kLayoutIntervalMs = 1000UL;
+}  // namespace
+
+MemoryMonitor::MemoryMonitor(Scheduler& scheduler)
+    : _scheduler(scheduler),
+      _current(),
+      _low(),
+      _maxFragmentation(0),
+      _lowHeapTask(kNoTask),
+      _lowBlockTask(kNoTask),
+      _lowStackTask(kNoTask),
+      _alarmActive(false),
+      _lastTask(kNoTask),
+      _layoutSampled(false),
+      _layoutSampledMs(0) {}
+
+void MemoryMonitor::begin() {
+  sample(kNoTask);
+  sampleLayout(millis());
+  _low = _current;
+  _scheduler.setTaskHook(&MemoryMonitor::onTask, this);
+}
+
+void MemoryMonitor::onTask(void* context, size_t index, bool finished) {
+  if (!finished) {
+    AllocTrace::enterTask(index);
+    return;
+  }
+  AllocTrace::leaveTask();
+  static_cast<MemoryMonitor*>(context)->sample(static_cast<int>(index));
+}
+
+void MemoryMonitor::sample(int task) {
+  // A counter read, cheap enough for every task run.
+  _current.freeHeap = ESP.getFreeHeap();
+  // Reads the stack-guard watermark, so this is already a high-water mark;
+  // sampling here tells which task pushed it down.
+  _current.freeStack = ESP.getFreeContStack();
+  _lastTask = task;
+
+  if (_current.freeHeap < _low.freeHeap) {
+    _low.freeHeap = _current.freeHeap;
+    _lowHeapTask = task;
+  }
+  if (_current.freeStack < _low.freeStack) {
+    _low.freeStack = _current.freeStack;
+    _lowStackTask = task;
+  }
+}
+
+void MemoryMonitor::sampleLayout(unsigned long now) {
+  if (_layoutSampled && now - _layoutSampledMs < kLayoutIntervalMs) {
+    return;
+  }
+  _layoutSampled = true;
+  _layoutSampledMs = now;
+
+  // One heap walk for both figures.
+  uint32_t freeHeap = 0;
+  uint32_t maxFreeBlock = 0;
+  uint8_t fragmentation = 0;
+  ESP.getHeapStats(&freeHeap, &maxFreeBlock, &fragmentation);
+  _current.freeHeap = freeHeap;
+  _current.maxFreeBlock = maxFreeBlock;
+  _current.fragmentation = fragmentation;
+
+  if (_current.maxFreeBlock < _low.maxFreeBlock) {
+    _low.maxFreeBlock = _current.maxFreeBlock;
+    _lowBlockTask = _lastTask;
+  }
+  if (_current.fragmentation > _maxFragmentation) {
+    _maxFragmentation = _current.fragmentation;
+  }
+}
+
+MemoryAlarm MemoryMonitor::updateAlarm(uint32_t minFreeBlock) {
+  if (minFreeBlock == 0) {
+    return MemoryAlarm::None;
+  }
+  if (!_alarmActive && _current.maxFreeBlock < minFreeBlock) {
+    _alarmActive = true;
+    DC_LOG_WARN("Memory", "Largest free block %lu below %lu (free %lu, frag %u%%).",
+                static_cast<unsigned long>(_current.maxFreeBlock), static_cast<unsigned long>(minFreeBlock),
+                static_cast<unsigned long>(_current.freeHeap), static_cast<unsigned>(_current.fragmentation));
+    return MemoryAlarm::Raised;
+  }
+  if (_alarmActive && _current.maxFreeBlock >= minFreeBlock + kAlarmHysteresisBytes) {
+    _alarmActive = false;
+    DC_LOG_INFO("Memory", "Largest free block recovered to %lu.", static_cast<unsigned long>(_current.maxFreeBlock));
+    return MemoryAlarm::Cleared;
+  }
+  return MemoryAlarm::None;
+}
+
+const char* MemoryMonitor::taskName(int task) const {
+  if (task < 0 || static_cast<size_t>(task) >= _scheduler.taskCount()) {
+    return "boot";
+  }
+  return _scheduler.taskStats(static_cast<size_t>(task)).name;
+}
+
+}  // namespace DeviceCore
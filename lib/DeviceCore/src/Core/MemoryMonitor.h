@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Scheduler.h"
+
+namespace DeviceCore {
+
+struct MemorySample {
+  uint32_t freeHeap;
+  uint32_t maxFreeBlock;
+  uint8_t fragmentation;  // percent, as reported by the SDK
+  uint32_t freeStack;
+};
+
+enum class MemoryAlarm : uint8_t {
+  None,
+  Raised,
+  Cleared,
+};
+
+// Samples free heap and loop-stack headroom after every scheduler task, so
+// each low-water mark is attributed to the task that just ran. The largest
+// free block and fragmentation need a walk of the whole heap with interrupts
+// off, so sampleLayout() takes those at most once a second and credits a
+// new low to the last task that ran. Low-water marks are kept since boot.
+// The fragmentation alarm trips when the largest free block falls below a
+// threshold, i.e. before an allocation of that size (a TCP segment for the
+// next publish) can fail.
+class MemoryMonitor {
+public:
+  static constexpr int kNoTask = -1;
+
+  explicit MemoryMonitor(Scheduler& scheduler);
+
+  // Installs itself as the scheduler's task hook.
+  void begin();
+  void sample(int task);
+  void sampleLayout(unsigned long now);
+
+  const MemorySample& current() const { return _current; }
+  const MemorySample& lowWater() const { return _low; }
+  uint8_t maxFragmentation() const { return _maxFragmentation; }
+  const char* lowHeapTask() const { return taskName(_lowHeapTask); }
+  const char* lowBlockTask() const { return taskName(_lowBlockTask); }
+  const char* lowStackTask() const { return taskName(_lowStackTask); }
+
+  // Re-evaluates the alarm against the latest layout sample; returns a
+  // change.
+  MemoryAlarm updateAlarm(uint32_t minFreeBlock);
+  bool alarmActive() const { return _alarmActive; }
+
+private:
+  Scheduler& _scheduler;
+  MemorySample _current;
+  MemorySample _low;
+  uint8_t _maxFragmentation;
+  int _lowHeapTask;
+  int _lowBlockTask;
+  int _lowStackTask;
+  bool _alarmActive;
+  int _lastTask;
+  bool _layoutSampled;
+  unsigned long _layoutSampledMs;
+
+  static void onTask(void* context, size_t index, bool finished);
+  const char* taskName(int task) const;
+};
+
+}  // namespace DeviceCore
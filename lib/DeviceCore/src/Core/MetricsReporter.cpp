@@ -0,0 +1,131 @@
+#include "MetricsReporter.h"
+#include "AllocTrace.h"
+#include "Log.h"
+
+namespace DeviceCore {
+
+MetricsReporter::MetricsReporter(Scheduler& scheduler, SerialForwarder& forwarder, MemoryMonitor& memory, MqttLayer& mqtt)
+    : _scheduler(scheduler),
+      _forwarder(forwarder),
+      _memory(memory),
+      _mqtt(mqtt),
+      _windowStartMs(0) {}
+
+bool MetricsReporter::due(unsigned long now, unsigned long intervalMs) const {
+  return intervalMs > 0 && now - _windowStartMs >= intervalMs;
+}
+
+unsigned long MetricsReporter::msUntilDue(unsigned long now, unsigned long intervalMs) const {
+  if (intervalMs == 0) {
+    return ~0UL;
+  }
+  unsigned long elapsed = now - _windowStartMs;
+  return elapsed >= intervalMs ? 0 : intervalMs - elapsed;
+}
+
+bool MetricsReporter::publish(unsigned long now, const char* topic, bool startNewWindow) {
+  bool sent = send(now, topic);
+  if (startNewWindow) {
+    _scheduler.resetHistograms();
+    _forwarder.resetPublishLatency();
+    _windowStartMs = now;
+  }
+  return sent;
+}
+
+bool MetricsReporter::send(unsigned long now, const char* topic) {
+  if (!topic || topic[0] == '\0' || !_mqtt.isConnected()) {
+    return false;
+  }
+
+  _payload.clear();
+  _payload.appendf("{\"windowMs\":%lu,\"maxLoopGapMs\":%lu,\"tasksLog2Us\":{",
+                   now - _windowStartMs, _scheduler.maxLoopGapMs());
+  for (size_t i = 0; i < _scheduler.taskCount(); ++i) {
+    _payload.appendf("%s\"%s\":", i == 0 ? "" : ",", _scheduler.taskStats(i).name);
+    appendHistogram(_scheduler.taskHistogram(i));
+  }
+  _payload.appendf("},\"serialToPublishLog2Ms\":");
+  appendHistogram(_forwarder.publishLatency());
+  _payload.appendf(",\"mem\":");
+  appendMemory();
+  if (!_payload.appendf("}")) {
+    DC_LOG_WARN("Metrics", "Report exceeds %lu bytes, not published.", static_cast<unsigned long>(kPayloadCapacity));
+    return false;
+  }
+
+  return _mqtt.publish(topic, _payload);
+}
+
+void MetricsReporter::appendHistogram(const LatencyHistogram& histogram) {
+  _payload.appendf("{\"n\":%lu,\"max\":%lu,\"h\":[",
+                   static_cast<unsigned long>(histogram.samples()), static_cast<unsigned long>(histogram.max()));
+  size_t used = histogram.usedBuckets();
+  for (size_t bucket = 0; bucket < used; ++bucket) {
+    _payload.appendf(bucket == 0 ? "%lu" : ",%lu",
+                     static_cast<unsigned long>(histogram.count(bucket)));
+  }
+  _payload.appendf("]}");
+}
+
+bool MetricsReporter::publishMemoryAlarm(const char* topic) {
+  if (!topic || topic[0] == '\0' || !_mqtt.isConnected()) {
+    return false;
+  }
+  _payload.clear();
+  _payload.appendf("{\"alarm\":\"heap\",\"state\":\"%s\",\"mem\":",
+                   _memory.alarmActive() ? "raised" : "cleared");
+  appendMemory();
+  if (!_payload.appendf("}")) {
+    return false;
+  }
+  return _mqtt.publish(topic, _payload);
+}
+
+bool MetricsReporter::publishAllocTrace(const char* topic) {
+  if (!AllocTrace::enabled() || !topic || topic[0] == '\0' || !_mqtt.isConnected()) {
+    return false;
+  }
+  _payload.clear();
+  _payload.appendf("{\"allocTasks\":{");
+  for (size_t i = 0; i <= AllocTrace::kOutsideTasks; ++i) {
+    const AllocTotals& totals = AllocTrace::totals(i);
+    const char* name = i == AllocTrace::kOutsideTasks ? "system" : (i < _scheduler.taskCount() ? _scheduler.taskStats(i).name : nullptr);
+    if (!name) {
+      continue;
+    }
+    _payload.appendf("%s\"%s\":[%lu,%lu,%lu]", i == 0 ? "" : ",", name,
+                     static_cast<unsigned long>(totals.allocations), static_cast<unsigned long>(totals.bytes),
+                     static_cast<unsigned long>(totals.frees));
+  }
+  _payload.appendf("},\"allocSites\":[");
+  for (size_t i = 0; i < AllocTrace::siteCount(); ++i) {
+    const AllocSite& site = AllocTrace::site(i);
+    _payload.appendf("%s[\"0x%08lx\",%lu,%lu]", i == 0 ? "" : ",",
+                     static_cast<unsigned long>(site.caller), static_cast<unsigned long>(site.allocations),
+                     static_cast<unsigned long>(site.bytes));
+  }
+  if (!_payload.appendf("],\"untracked\":%lu,\"steady\":[%lu,\"0x%08lx\"]}",
+                        static_cast<unsigned long>(AllocTrace::untrackedSites()),
+                        static_cast<unsigned long>(AllocTrace::steadyStateAllocations()),
+                        static_cast<unsigned long>(AllocTrace::firstSteadyStateCaller()))) {
+    return false;
+  }
+  return _mqtt.publish(topic, _payload);
+}
+
+void MetricsReporter::appendMemory() {
+  const MemorySample& current = _memory.current();
+  const MemorySample& low = _memory.lowWater();
+  _payload.appendf(
+          "{\"freeHeap\":%lu,\"maxBlock\":%lu,\"frag\":%u,\"freeStack\":%lu,"
+          "\"minFreeHeap\":[%lu,\"%s\"],\"minMaxBlock\":[%lu,\"%s\"],\"minFreeStack\":[%lu,\"%s\"],\"maxFrag\":%u}",
+          static_cast<unsigned long>(current.freeHeap), static_cast<unsigned long>(current.maxFreeBlock),
+          static_cast<unsigned>(current.fragmentation), static_cast<unsigned long>(current.freeStack),
+          static_cast<unsigned long>(low.freeHeap), _memory.lowHeapTask(),
+          static_cast<unsigned long>(low.maxFreeBlock), _memory.lowBlockTask(),
+          static_cast<unsigned long>(low.freeStack), _memory.lowStackTask(),
+          static_cast<unsigned>(_memory.maxFragmentation()));
+}
+
+}  // namespace DeviceCore
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Arduino.h>
+#include "../Hardware/SerialForwarder.h"
+#include "../Network/MqttLayer.h"
+#include "FixedString.h"
+#include "LatencyHistogram.h"
+#include "MemoryMonitor.h"
+#include "Scheduler.h"
+
+#ifndef DEVICECORE_METRICS_PAYLOAD_BYTES
+#define DEVICECORE_METRICS_PAYLOAD_BYTES 2048
+#endif
+
+namespace DeviceCore {
+
+// Serialises the scheduler's per-task histograms, the longest loop gap, the
+// serial ingest-to-publish histogram and the memory low-water marks into one
+// compact JSON document. Histograms are sent as bucket counts with trailing
+// empty buckets trimmed.
+class MetricsReporter {
+public:
+  static constexpr size_t kPayloadCapacity = DEVICECORE_METRICS_PAYLOAD_BYTES;
+
+  MetricsReporter(Scheduler& scheduler, SerialForwarder& forwarder, MemoryMonitor& memory, MqttLayer& mqtt);
+
+  void begin(unsigned long now) { _windowStartMs = now; }
+  bool due(unsigned long now, unsigned long intervalMs) const;
+  unsigned long msUntilDue(unsigned long now, unsigned long intervalMs) const;
+
+  // Publishes the current window. A periodic report then starts a new
+  // window whether or not it got out; an on-demand one leaves it running.
+  bool publish(unsigned long now, const char* topic, bool startNewWindow);
+  bool publishMemoryAlarm(const char* topic);
+  // Per-task and per-call-site allocation counts; alloc-trace builds only.
+  bool publishAllocTrace(const char* topic);
+
+private:
+  Scheduler& _scheduler;
+  SerialForwarder& _forwarder;
+  MemoryMonitor& _memory;
+  MqttLayer& _mqtt;
+  unsigned long _windowStartMs;
+  FixedString<kPayloadCapacity> _payload;
+
+  bool send(unsigned long now, const char* topic);
+  void appendHistogram(const LatencyHistogram& histogram);
+  void appendMemory();
+};
+
+}  // namespace DeviceCore
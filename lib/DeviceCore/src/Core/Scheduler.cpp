@@ -0,0 +1,171 @@
+#include "Scheduler.h"
+#include "Log.h"
+#include <coredecls.h>
+
+namespace DeviceCore {
+
+namespace {
+// Upper bound on a single sleep so a missed wake() can never stall the loop.
+constexpr unsigned long kMaxSleepMs = 1000UL;
+
+bool deadlineReached(unsigned long now, unsigned long deadline) {
+  return static_cast<long>(now - deadline) >= 0;
+}
+}  // namespace
+
+Scheduler::Scheduler(unsigned long reportIntervalMs)
+    : _taskCount(0),
+      _reportIntervalMs(reportIntervalMs),
+      _windowStartMs(0),
+      _windowWakeups(0),
+      _wakeupsPerSecond(0),
+      _lastPassMs(0),
+      _passed(false),
+      _maxLoopGapMs(0),
+      _hook(nullptr),
+      _hookContext(nullptr) {}
+
+int Scheduler::addTask(const char* name, RunFn run, void* context, ReadyFn ready) {
+  if (_taskCount >= kMaxTasks || !run) {
+    return kInvalidTask;
+  }
+  Task& task = _tasks[_taskCount];
+  task.name = name;
+  task.run = run;
+  task.ready = ready;
+  task.context = context;
+  task.nextRunMs = millis();
+  task.runs = 0;
+  task.totalUs = 0;
+  task.maxUs = 0;
+  task.histogram.reset();
+  return static_cast<int>(_taskCount++);
+}
+
+void Scheduler::runSoon(int task, unsigned long delayMs) {
+  if (task < 0 || static_cast<size_t>(task) >= _taskCount) {
+    return;
+  }
+  unsigned long deadline = millis() + delayMs;
+  if (static_cast<long>(deadline - _tasks[task].nextRunMs) < 0) {
+    _tasks[task].nextRunMs = deadline;
+  }
+}
+
+void Scheduler::setTaskHook(TaskHook hook, void* context) {
+  _hook = hook;
+  _hookContext = context;
+}
+
+void Scheduler::runDue(unsigned long now) {
+  // Includes time asleep, so a healthy loop stays near the shortest task
+  // period; anything longer is time the SDK or a blocking call held the CPU.
+  if (_passed && now - _lastPassMs > _maxLoopGapMs) {
+    _maxLoopGapMs = now - _lastPassMs;
+  }
+  _lastPassMs = now;
+  _passed = true;
+
+  for (size_t i = 0; i < _taskCount; ++i) {
+    Task& task = _tasks[i];
+    bool due = deadlineReached(now, task.nextRunMs) || (task.ready && task.ready(task.context));
+    if (!due) {
+      continue;
+    }
+
+    if (_hook) {
+      _hook(_hookContext, i, false);
+    }
+    unsigned long startUs = micros();
+    unsigned long delayMs = task.run(task.context, now);
+    uint32_t elapsedUs = micros() - startUs;
+    if (_hook) {
+      _hook(_hookContext, i, true);
+    }
+
+    task.nextRunMs = now + (delayMs ? delayMs : 1UL);
+    ++task.runs;
+    task.totalUs += elapsedUs;
+    if (elapsedUs > task.maxUs) {
+      task.maxUs = elapsedUs;
+    }
+    task.histogram.record(elapsedUs);
+  }
+
+  if (_reportIntervalMs && now - _windowStartMs >= _reportIntervalMs) {
+    report(now);
+  }
+}
+
+void Scheduler::sleep(unsigned long now) {
+  ++_windowWakeups;
+  if (anyReady()) {
+    return;
+  }
+
+  unsigned long sleepMs = kMaxSleepMs;
+  for (size_t i = 0; i < _taskCount; ++i) {
+    long remaining = static_cast<long>(_tasks[i].nextRunMs - now);
+    if (remaining <= 0) {
+      return;
+    }
+    if (static_cast<unsigned long>(remaining) < sleepMs) {
+      sleepMs = static_cast<unsigned long>(remaining);
+    }
+  }
+
+  // Suspends the loop task; wake() resumes it early and the predicate is
+  // re-checked before going back to sleep.
+  esp_delay(sleepMs, [this]() { return !anyReady(); }, sleepMs);
+}
+
+void Scheduler::resetHistograms() {
+  for (size_t i = 0; i < _taskCount; ++i) {
+    _tasks[i].histogram.reset();
+  }
+  _maxLoopGapMs = 0;
+}
+
+void Scheduler::wake() {
+  esp_schedule();
+}
+
+Scheduler::TaskStats Scheduler::taskStats(size_t index) const {
+  TaskStats stats = {nullptr, 0, 0, 0};
+  if (index < _taskCount) {
+    stats.name = _tasks[index].name;
+    stats.runs = _tasks[index].runs;
+    stats.totalUs = _tasks[index].totalUs;
+    stats.maxUs = _tasks[index].maxUs;
+  }
+  return stats;
+}
+
+bool Scheduler::anyReady() const {
+  for (size_t i = 0; i < _taskCount; ++i) {
+    if (_tasks[i].ready && _tasks[i].ready(_tasks[i].context)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Scheduler::report(unsigned long now) {
+  unsigned long elapsed = now - _windowStartMs;
+  _wakeupsPerSecond = elapsed ? (_windowWakeups * 1000UL) / elapsed : 0;
+
+  DC_LOG_INFO("Scheduler", "wakeups/s: %lu", static_cast<unsigned long>(_wakeupsPerSecond));
+  for (size_t i = 0; i < _taskCount; ++i) {
+    Task& task = _tasks[i];
+    DC_LOG_INFO("Scheduler", "%s runs: %lu, avg us: %lu, max us: %lu", task.name, static_cast<unsigned long>(task.runs),
+                static_cast<unsigned long>(task.runs ? task.totalUs / task.runs : 0UL), static_cast<unsigned long>(task.maxUs));
+    task.runs = 0;
+    task.totalUs = 0;
+    task.maxUs = 0;
+  }
+
+  _windowStartMs = now;
+  _windowWakeups = 0;
+}
+
+}  // namespace DeviceCore
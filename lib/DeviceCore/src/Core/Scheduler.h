@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Arduino.h>
+#include "LatencyHistogram.h"
+
+namespace DeviceCore {
+
+// Cooperative deadline scheduler for DeviceController. Each task returns the
+// number of milliseconds until it next needs to run and may supply a
+// readiness probe for I/O it cannot predict. Between passes the loop task
+// sleeps until the earliest deadline; wake() (safe from timer context) ends
+// the sleep early when new input arrives.
+class Scheduler {
+public:
+  typedef unsigned long (*RunFn)(void* context, unsigned long now);
+  typedef bool (*ReadyFn)(void* context);
+  // Called just before (finished == false) and after every task run.
+  typedef void (*TaskHook)(void* context, size_t index, bool finished);
+
+  static constexpr size_t kMaxTasks = 8;
+  static constexpr int kInvalidTask = -1;
+
+  struct TaskStats {
+    const char* name;
+    uint32_t runs;
+    uint32_t totalUs;
+    uint32_t maxUs;
+  };
+
+  explicit Scheduler(unsigned long reportIntervalMs);
+
+  int addTask(const char* name, RunFn run, void* context, ReadyFn ready = nullptr);
+  void runSoon(int task, unsigned long delayMs);
+  void setTaskHook(TaskHook hook, void* context);
+
+  void runDue(unsigned long now);
+  void sleep(unsigned long now);
+
+  static void wake();
+
+  size_t taskCount() const { return _taskCount; }
+  TaskStats taskStats(size_t index) const;
+  uint32_t wakeupsPerSecond() const { return _wakeupsPerSecond; }
+
+  // Execution-time histograms (microseconds) and the longest interval
+  // between passes, accumulated until resetHistograms().
+  const LatencyHistogram& taskHistogram(size_t index) const { return _tasks[index].histogram; }
+  unsigned long maxLoopGapMs() const { return _maxLoopGapMs; }
+  void resetHistograms();
+
+private:
+  struct Task {
+    const char* name;
+    RunFn run;
+    ReadyFn ready;
+    void* context;
+    unsigned long nextRunMs;
+    uint32_t runs;
+    uint32_t totalUs;
+    uint32_t maxUs;
+    LatencyHistogram histogram;
+  };
+
+  Task _tasks[kMaxTasks];
+  size_t _taskCount;
+  unsigned long _reportIntervalMs;
+  unsigned long _windowStartMs;
+  uint32_t _windowWakeups;
+  uint32_t _wakeupsPerSecond;
+  unsigned long _lastPassMs;
+  bool _passed;
+  unsigned long _maxLoopGapMs;
+  TaskHook _hook;
+  void* _hookContext;
+
+  bool anyReady() const;
+  void report(unsigned long now);
+};
+
+}  // namespace DeviceCore
@@ -1,9 +1,32 @@
 #pragma once
 
 #include "Config/DeviceConfig.h"
+#include "Config/RuntimeSettings.h"
+#include "Storage/ConfigJournal.h"
 #include "Storage/CredentialStore.h"
+#include "Storage/OfflineQueue.h"
+#include "Storage/RtcWifiCache.h"
+#include "Storage/SettingsStore.h"
 #include "Network/ProvisioningManager.h"
+#include "Network/AsyncTcpClient.h"
+#include "Network/MqttTapClient.h"
+#include "Network/MqttInflightWindow.h"
+#include "Network/ReconnectPolicy.h"
+#include "Network/WifiScanCache.h"
+#include "Network/CommandDispatcher.h"
 #include "Network/MqttLayer.h"
 #include "Hardware/LedSubsystem.h"
+#include "Hardware/SerialIngest.h"
 #include "Hardware/SerialForwarder.h"
+#include "Hardware/ModbusBus.h"
+#include "Hardware/ModbusPoller.h"
+#include "Hardware/ModbusGateway.h"
+#include "Core/FixedString.h"
+#include "Core/Log.h"
+#include "Core/LoopProbe.h"
+#include "Core/LatencyHistogram.h"
+#include "Core/AllocTrace.h"
+#include "Core/MemoryMonitor.h"
+#include "Core/MetricsReporter.h"
+#include "Core/Scheduler.h"
 #include "Core/DeviceController.h"
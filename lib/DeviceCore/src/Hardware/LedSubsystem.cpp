@@ -74,6 +74,28 @@ void LedSubsystem::setPulseDurations(unsigned long userPulseDuration, unsigned l
   _errPulseDuration = errPulseDuration ? errPulseDuration : 150UL;
 }
 
+unsigned long LedSubsystem::msUntilNextChange(unsigned long now) const {
+  unsigned long next = ~0UL;
+  if (_userPulseActive) {
+    unsigned long elapsed = now - _userPulseStartMs;
+    next = elapsed >= _userPulseDuration ? 0 : _userPulseDuration - elapsed;
+  }
+  if (_errPulseActive) {
+    unsigned long elapsed = now - _errPulseStartMs;
+    unsigned long remaining = elapsed >= _errPulseDuration ? 0 : _errPulseDuration - elapsed;
+    if (remaining < next) {
+      next = remaining;
+    }
+  } else if (_errBlinking) {
+    unsigned long elapsed = now - _errBlinkStartMs;
+    unsigned long remaining = elapsed >= kProvisioningBlinkIntervalMs ? 0 : kProvisioningBlinkIntervalMs - elapsed;
+    if (remaining < next) {
+      next = remaining;
+    }
+  }
+  return next;
+}
+
 void LedSubsystem::setErrBlinking(bool blinking) {
   if (_errBlinking == blinking) {
     return;
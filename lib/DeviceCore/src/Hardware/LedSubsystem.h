@@ -17,6 +17,7 @@ public:
   void loop(unsigned long now, bool networkReady);
   void setPulseDurations(unsigned long userPulseDuration, unsigned long errPulseDuration);
   void setErrBlinking(bool blinking);
+  unsigned long msUntilNextChange(unsigned long now) const;
 
 private:
   uint8_t _userPin;
@@ -0,0 +1,142 @@
+#include "ModbusBus.h"
+#include <new>
+
+namespace DeviceCore {
+
+namespace {
+constexpr uint8_t kNoDePin = 0xFF;
+// DFRobot_RTU status codes; 1-4 are the slave's exception codes.
+constexpr uint8_t kRtuOk = 0x00;
+constexpr uint8_t kRtuMaxException = 0x04;
+constexpr uint8_t kRtuRecvError = 0x08;
+constexpr uint8_t kRtuIdError = 0x0A;
+}  // namespace
+
+ModbusBus::ModbusBus(SerialForwarder& forwarder)
+    : _forwarder(forwarder),
+      _rtu(nullptr),
+      _timeoutMs(0),
+      _slaveCount(0) {}
+
+void ModbusBus::begin(HardwareSerial& port, uint8_t dePin, unsigned long timeoutMs) {
+  if (_rtu) {
+    return;
+  }
+  _rtu = dePin == kNoDePin ? new (_rtuStorage) DFRobot_RTU(&port) : new (_rtuStorage) DFRobot_RTU(&port, dePin);
+  _rtu->setTimeoutTimeMs(timeoutMs);
+  _timeoutMs = timeoutMs;
+}
+
+ModbusResult ModbusBus::read(uint8_t slaveId, ModbusFunction function, uint16_t start, uint16_t count, uint16_t* out, uint8_t& exception) {
+  exception = 0;
+  if (!_rtu || count == 0 || count > kMaxRegisters) {
+    return ModbusResult::Error;
+  }
+
+  _forwarder.suspendInput();
+  unsigned long startMs = millis();
+  uint8_t code = function == ModbusFunction::InputRegisters
+                     ? _rtu->readInputRegister(slaveId, start, out, count)
+                     : _rtu->readHoldingRegister(slaveId, start, out, count);
+  ModbusResult result = finish(slaveId, code, startMs, exception);
+  _forwarder.resumeInput();
+  return result;
+}
+
+ModbusResult ModbusBus::write(uint8_t slaveId, uint16_t start, uint16_t* values, uint16_t count, uint8_t& exception) {
+  exception = 0;
+  if (!_rtu || count == 0 || count > kMaxRegisters) {
+    return ModbusResult::Error;
+  }
+
+  _forwarder.suspendInput();
+  unsigned long startMs = millis();
+  uint8_t code = _rtu->writeHoldingRegister(slaveId, start, values, count);
+  ModbusResult result = finish(slaveId, code, startMs, exception);
+  _forwarder.resumeInput();
+  return result;
+}
+
+ModbusResult ModbusBus::finish(uint8_t slaveId, uint8_t code, unsigned long startMs, uint8_t& exception) {
+  unsigned long elapsed = millis() - startMs;
+  ModbusResult result;
+  if (code == kRtuOk) {
+    result = ModbusResult::Ok;
+  } else if (code <= kRtuMaxException) {
+    exception = code;
+    result = ModbusResult::Exception;
+  } else if (code == kRtuRecvError) {
+    // The library reports a silent slave and a corrupted reply the same way;
+    // only a corrupted reply comes back before the timeout expires.
+    result = elapsed >= _timeoutMs ? ModbusResult::Timeout : ModbusResult::CrcError;
+  } else if (code == kRtuIdError) {
+    result = ModbusResult::CrcError;
+  } else {
+    result = ModbusResult::Error;
+  }
+
+  ModbusSlaveStats* stats = statsFor(slaveId);
+  if (!stats) {
+    return result;
+  }
+  ++stats->transactions;
+  switch (result) {
+    case ModbusResult::Ok:
+      ++stats->ok;
+      break;
+    case ModbusResult::Timeout:
+      ++stats->timeouts;
+      break;
+    case ModbusResult::CrcError:
+      ++stats->crcErrors;
+      break;
+    case ModbusResult::Exception:
+      ++stats->exceptions;
+      break;
+    case ModbusResult::Error:
+      break;
+  }
+  // Timeouts would only measure our own deadline; keep latency to replies.
+  if (result != ModbusResult::Timeout) {
+    uint16_t latency = elapsed > 0xFFFFUL ? 0xFFFF : static_cast<uint16_t>(elapsed);
+    stats->lastLatencyMs = latency;
+    stats->totalLatencyMs += latency;
+    if (latency > stats->maxLatencyMs) {
+      stats->maxLatencyMs = latency;
+    }
+  }
+  return result;
+}
+
+ModbusSlaveStats* ModbusBus::statsFor(uint8_t slaveId) {
+  for (size_t i = 0; i < _slaveCount; ++i) {
+    if (_slaves[i].slaveId == slaveId) {
+      return &_slaves[i];
+    }
+  }
+  if (_slaveCount >= kMaxSlaves) {
+    return nullptr;
+  }
+  ModbusSlaveStats& stats = _slaves[_slaveCount++];
+  stats = ModbusSlaveStats();
+  stats.slaveId = slaveId;
+  return &stats;
+}
+
+const char* ModbusBus::resultName(ModbusResult result) {
+  switch (result) {
+    case ModbusResult::Ok:
+      return "ok";
+    case ModbusResult::Timeout:
+      return "timeout";
+    case ModbusResult::CrcError:
+      return "crc";
+    case ModbusResult::Exception:
+      return "exception";
+    case ModbusResult::Error:
+      break;
+  }
+  return "error";
+}
+
+}  // namespace DeviceCore
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Arduino.h>
+#include <DFRobot_RTU.h>
+#include "../Config/DeviceConfig.h"
+#include "SerialForwarder.h"
+
+#ifndef DEVICECORE_MODBUS_MAX_SLAVES
+#define DEVICECORE_MODBUS_MAX_SLAVES 8
+#endif
+
+namespace DeviceCore {
+
+enum class ModbusResult : uint8_t {
+  Ok,
+  Timeout,
+  CrcError,   // reply arrived but failed CRC or framing checks
+  Exception,  // slave answered with an exception code
+  Error,
+};
+
+struct ModbusSlaveStats {
+  uint8_t slaveId;
+  uint32_t transactions;
+  uint32_t ok;
+  uint32_t timeouts;
+  uint32_t crcErrors;
+  uint32_t exceptions;
+  uint32_t totalLatencyMs;
+  uint16_t lastLatencyMs;
+  uint16_t maxLatencyMs;
+};
+
+// Modbus RTU master on the UART shared with SerialForwarder. Every
+// transaction suspends serial ingest so the reply frame reaches DFRobot_RTU
+// instead of the forwarder, and is timed into per-slave counters.
+class ModbusBus {
+public:
+  static constexpr size_t kMaxSlaves = DEVICECORE_MODBUS_MAX_SLAVES;
+  // Largest register count a single read request may ask for.
+  static constexpr uint16_t kMaxRegisters = 125;
+
+  explicit ModbusBus(SerialForwarder& forwarder);
+
+  // dePin 0xFF means the transceiver switches direction on its own.
+  void begin(HardwareSerial& port, uint8_t dePin, unsigned long timeoutMs);
+  bool enabled() const { return _rtu != nullptr; }
+
+  ModbusResult read(uint8_t slaveId, ModbusFunction function, uint16_t start, uint16_t count, uint16_t* out, uint8_t& exception);
+  ModbusResult write(uint8_t slaveId, uint16_t start, uint16_t* values, uint16_t count, uint8_t& exception);
+
+  size_t slaveCount() const { return _slaveCount; }
+  const ModbusSlaveStats& slaveStats(size_t index) const { return _slaves[index]; }
+  static const char* resultName(ModbusResult result);
+
+private:
+  SerialForwarder& _forwarder;
+  // Constructed in begin(): DFRobot_RTU drives the DE pin from its
+  // constructor, which must not run before setup().
+  alignas(DFRobot_RTU) uint8_t _rtuStorage[sizeof(DFRobot_RTU)];
+  DFRobot_RTU* _rtu;
+  unsigned long _timeoutMs;
+  ModbusSlaveStats _slaves[kMaxSlaves];
+  size_t _slaveCount;
+
+  ModbusResult finish(uint8_t slaveId, uint8_t code, unsigned long startMs, uint8_t& exception);
+  ModbusSlaveStats* statsFor(uint8_t slaveId);
+};
+
+}  // namespace DeviceCore
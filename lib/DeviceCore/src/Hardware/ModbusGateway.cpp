@@ -0,0 +1,219 @@
+#include "ModbusGateway.h"
+#include <cstring>
+
+namespace DeviceCore {
+
+namespace {
+constexpr unsigned long kDefaultRequestTimeoutMs = 2000UL;
+constexpr unsigned long kMaxRequestTimeoutMs = 30000UL;
+constexpr uint8_t kMaxSlaveId = 247;
+constexpr uint8_t kWriteMultipleFunction = 16;
+// Header fields plus one "65535," per register; sized so a full read fits.
+constexpr size_t kReplyHeaderBytes = 192;
+constexpr size_t kReplyValueBytes = 6;
+}  // namespace
+
+ModbusGateway::ModbusGateway(ModbusBus& bus, MqttLayer& mqtt, const DeviceConfig& config)
+    : _bus(bus),
+      _mqtt(mqtt),
+      _config(config),
+      _enabled(false),
+      _head(0),
+      _count(0),
+      _rejected(0) {
+  static_assert(kReplyHeaderBytes + ModbusBus::kMaxRegisters * kReplyValueBytes <= kPayloadCapacity,
+                "Modbus reply buffer too small for a full read");
+}
+
+void ModbusGateway::begin(CommandDispatcher& commands) {
+  if (!_config.modbusRequestTopic || _config.modbusRequestTopic[0] == '\0') {
+    return;
+  }
+  commands.add(_config.modbusRequestTopic, "read", &ModbusGateway::onReadCommand, this);
+  commands.add(_config.modbusRequestTopic, "write", &ModbusGateway::onWriteCommand, this);
+  _enabled = true;
+}
+
+void ModbusGateway::onReadCommand(void* context, JsonVariantConst message) {
+  static_cast<ModbusGateway*>(context)->enqueue(message, Operation::Read);
+}
+
+void ModbusGateway::onWriteCommand(void* context, JsonVariantConst message) {
+  static_cast<ModbusGateway*>(context)->enqueue(message, Operation::Write);
+}
+
+void ModbusGateway::enqueue(JsonVariantConst message, Operation operation) {
+  char id[kMaxIdLength + 1];
+  id[0] = '\0';
+  JsonVariantConst idField = message["id"];
+  if (idField.is<const char*>()) {
+    const char* text = idField.as<const char*>();
+    size_t length = strlen(text);
+    bool printable = length <= kMaxIdLength;
+    for (size_t i = 0; printable && i < length; ++i) {
+      // The id is echoed into JSON unescaped.
+      printable = text[i] >= 0x20 && text[i] != '"' && text[i] != '\\';
+    }
+    if (!printable) {
+      replyRejected(nullptr, "invalid", "id");
+      return;
+    }
+    memcpy(id, text, length + 1);
+  } else if (idField.is<uint32_t>()) {
+    snprintf(id, sizeof(id), "%lu", static_cast<unsigned long>(idField.as<uint32_t>()));
+  } else {
+    replyRejected(nullptr, "invalid", "id");
+    return;
+  }
+
+  if (_count >= kQueueDepth) {
+    ++_rejected;
+    replyRejected(id, "busy", nullptr);
+    return;
+  }
+
+  Request& request = _queue[(_head + _count) % kQueueDepth];
+  JsonVariantConst slave = message["slave"];
+  if (!slave.is<uint8_t>() || slave.as<uint8_t>() == 0 || slave.as<uint8_t>() > kMaxSlaveId) {
+    replyRejected(id, "invalid", "slave");
+    return;
+  }
+  JsonVariantConst reg = message["reg"];
+  if (!reg.is<uint16_t>()) {
+    replyRejected(id, "invalid", "reg");
+    return;
+  }
+  request.operation = operation;
+  request.slaveId = slave.as<uint8_t>();
+  request.start = reg.as<uint16_t>();
+
+  if (operation == Operation::Read) {
+    // Only an absent fn defaults to holding registers; a mistyped one must
+    // not turn into a read that reports success.
+    JsonVariantConst fn = message["fn"];
+    if (!fn.isNull() && !fn.is<uint8_t>()) {
+      replyRejected(id, "invalid", "fn");
+      return;
+    }
+    uint8_t function = fn.isNull() ? static_cast<uint8_t>(ModbusFunction::HoldingRegisters) : fn.as<uint8_t>();
+    if (function != static_cast<uint8_t>(ModbusFunction::HoldingRegisters) &&
+        function != static_cast<uint8_t>(ModbusFunction::InputRegisters)) {
+      replyRejected(id, "invalid", "fn");
+      return;
+    }
+    JsonVariantConst count = message["count"];
+    if (!count.is<uint16_t>() || count.as<uint16_t>() == 0 || count.as<uint16_t>() > ModbusBus::kMaxRegisters) {
+      replyRejected(id, "invalid", "count");
+      return;
+    }
+    request.function = static_cast<ModbusFunction>(function);
+    request.count = count.as<uint16_t>();
+  } else {
+    JsonArrayConst values = message["values"];
+    if (values.isNull() || values.size() == 0 || values.size() > kMaxWriteRegisters) {
+      replyRejected(id, "invalid", "values");
+      return;
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+      if (!values[i].is<uint16_t>()) {
+        replyRejected(id, "invalid", "values");
+        return;
+      }
+      request.values[i] = values[i].as<uint16_t>();
+    }
+    request.function = ModbusFunction::HoldingRegisters;
+    request.count = static_cast<uint16_t>(values.size());
+  }
+  if (static_cast<uint32_t>(request.start) + request.count > 0x10000UL) {
+    replyRejected(id, "invalid", "count");
+    return;
+  }
+
+  unsigned long timeoutMs = kDefaultRequestTimeoutMs;
+  JsonVariantConst timeout = message["timeoutMs"];
+  if (!timeout.isNull()) {
+    if (!timeout.is<uint32_t>() || timeout.as<uint32_t>() == 0 || timeout.as<uint32_t>() > kMaxRequestTimeoutMs) {
+      replyRejected(id, "invalid", "timeoutMs");
+      return;
+    }
+    timeoutMs = timeout.as<uint32_t>();
+  }
+  request.deadlineMs = millis() + timeoutMs;
+  memcpy(request.id, id, sizeof(request.id));
+  ++_count;
+}
+
+void ModbusGateway::run(unsigned long now) {
+  // Requests that outlived their timeout in the queue are answered without
+  // touching the bus, so a backlog behind a slow slave drains quickly.
+  while (_count > 0 && static_cast<long>(now - _queue[_head].deadlineMs) >= 0) {
+    ++_rejected;
+    replyResult(_queue[_head], "expired", 0, nullptr);
+    _head = (_head + 1) % kQueueDepth;
+    --_count;
+  }
+  if (_count == 0) {
+    return;
+  }
+
+  execute(_queue[_head]);
+  _head = (_head + 1) % kQueueDepth;
+  --_count;
+}
+
+void ModbusGateway::execute(Request& request) {
+  uint8_t exception = 0;
+  if (request.operation == Operation::Read) {
+    ModbusResult result = _bus.read(request.slaveId, request.function, request.start, request.count, _registers, exception);
+    replyResult(request, ModbusBus::resultName(result), exception, result == ModbusResult::Ok ? _registers : nullptr);
+    return;
+  }
+  ModbusResult result = _bus.write(request.slaveId, request.start, request.values, request.count, exception);
+  replyResult(request, ModbusBus::resultName(result), exception, nullptr);
+}
+
+void ModbusGateway::replyRejected(const char* id, const char* status, const char* field) {
+  const char* topic = responseTopic();
+  if (!topic || !_mqtt.isConnected()) {
+    return;
+  }
+  _payload.clear();
+  if (!_payload.appendf("{\"id\":\"%s\",\"status\":\"%s\",\"field\":\"%s\"}", id ? id : "", status,
+                        field ? field : "")) {
+    return;
+  }
+  _mqtt.publish(topic, _payload);
+}
+
+void ModbusGateway::replyResult(const Request& request, const char* status, uint8_t exception, const uint16_t* values) {
+  const char* topic = responseTopic();
+  if (!topic || !_mqtt.isConnected()) {
+    return;
+  }
+  uint8_t function = request.operation == Operation::Write ? kWriteMultipleFunction : static_cast<uint8_t>(request.function);
+  _payload.clear();
+  _payload.appendf("{\"id\":\"%s\",\"status\":\"%s\",\"slave\":%u,\"fn\":%u,\"reg\":%u,\"count\":%u,\"exception\":%u",
+                   request.id, status, static_cast<unsigned>(request.slaveId), static_cast<unsigned>(function),
+                   static_cast<unsigned>(request.start), static_cast<unsigned>(request.count),
+                   static_cast<unsigned>(exception));
+  if (values) {
+    _payload.append(",\"values\":[");
+    for (uint16_t i = 0; i < request.count; ++i) {
+      _payload.appendf(i == 0 ? "%u" : ",%u", static_cast<unsigned>(values[i]));
+    }
+    _payload.append(']');
+  }
+  if (!_payload.append('}')) {
+    return;
+  }
+  _mqtt.publish(topic, _payload);
+}
+
+const char* ModbusGateway::responseTopic() const {
+  if (_config.modbusResponseTopic && _config.modbusResponseTopic[0] != '\0') {
+    return _config.modbusResponseTopic;
+  }
+  return _config.modbusTopic;
+}
+
+}  // namespace DeviceCore
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../Config/DeviceConfig.h"
+#include "../Core/FixedString.h"
+#include "../Network/CommandDispatcher.h"
+#include "../Network/MqttLayer.h"
+#include "ModbusBus.h"
+
+#ifndef DEVICECORE_MODBUS_GATEWAY_QUEUE
+#define DEVICECORE_MODBUS_GATEWAY_QUEUE 8
+#endif
+
+namespace DeviceCore {
+
+// Ad-hoc Modbus transactions requested over MQTT. "read" and "write"
+// commands on DeviceConfig::modbusRequestTopic are queued and executed one
+// per scheduler pass; each reply echoes the caller's "id" on
+// modbusResponseTopic. A full queue is answered with "busy" straight away,
+// and a request still queued after its timeoutMs is answered with "expired".
+class ModbusGateway {
+public:
+  static constexpr size_t kQueueDepth = DEVICECORE_MODBUS_GATEWAY_QUEUE;
+  static constexpr size_t kMaxIdLength = 32;
+  static constexpr uint16_t kMaxWriteRegisters = 32;
+
+  ModbusGateway(ModbusBus& bus, MqttLayer& mqtt, const DeviceConfig& config);
+
+  void begin(CommandDispatcher& commands);
+  bool enabled() const { return _enabled; }
+  bool hasWork() const { return _count > 0; }
+  uint32_t rejected() const { return _rejected; }
+
+  // Runs at most one queued transaction.
+  void run(unsigned long now);
+
+private:
+  static constexpr size_t kPayloadCapacity = 1024;
+
+  enum class Operation : uint8_t {
+    Read,
+    Write,
+  };
+
+  struct Request {
+    char id[kMaxIdLength + 1];
+    Operation operation;
+    uint8_t slaveId;
+    ModbusFunction function;
+    uint16_t start;
+    uint16_t count;
+    unsigned long deadlineMs;
+    uint16_t values[kMaxWriteRegisters];
+  };
+
+  ModbusBus& _bus;
+  MqttLayer& _mqtt;
+  const DeviceConfig& _config;
+  bool _enabled;
+  Request _queue[kQueueDepth];
+  size_t _head;
+  size_t _count;
+  uint32_t _rejected;
+  uint16_t _registers[ModbusBus::kMaxRegisters];
+  FixedString<kPayloadCapacity> _payload;
+
+  static void onReadCommand(void* context, JsonVariantConst message);
+  static void onWriteCommand(void* context, JsonVariantConst message);
+
+  void enqueue(JsonVariantConst message, Operation operation);
+  void execute(Request& request);
+  void replyRejected(const char* id, const char* status, const char* field);
+  void replyResult(const Request& request, const char* status, uint8_t exception, const uint16_t* values);
+  const char* responseTopic() const;
+};
+
+}  // namespace DeviceCore
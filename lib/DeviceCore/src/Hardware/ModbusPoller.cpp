@@ -0,0 +1,294 @@
+#include "ModbusPoller.h"
+#include "../Core/Log.h"
+#include <cmath>
+#include <cstring>
+
+namespace DeviceCore {
+
+namespace {
+constexpr unsigned long kStatsIntervalMs = 60000UL;
+constexpr unsigned long kIdlePollMs = 1000UL;
+// Room kept for the "]}" that closes every block and stats message.
+constexpr size_t kArrayTrailerLength = 2;
+// Longest value appendValue() writes: a comma and FLT_MAX as "%.4f".
+constexpr size_t kMaxValueLength = 48;
+
+bool isWide(ModbusValueType type) {
+  return type == ModbusValueType::U32 || type == ModbusValueType::S32 || type == ModbusValueType::F32;
+}
+
+bool validBlock(const ModbusBlock& block) {
+  if (block.count == 0 || block.count > ModbusBus::kMaxRegisters || block.intervalMs == 0) {
+    return false;
+  }
+  if (block.function != ModbusFunction::HoldingRegisters && block.function != ModbusFunction::InputRegisters) {
+    return false;
+  }
+  return !isWide(block.type) || (block.count % 2) == 0;
+}
+
+template <size_t N>
+bool appendValue(FixedString<N>& out, ModbusValueType type, const uint16_t* registers, bool first) {
+  const char* separator = first ? "" : ",";
+  uint32_t wide = isWide(type) ? (static_cast<uint32_t>(registers[0]) << 16) | registers[1] : 0;
+  switch (type) {
+    case ModbusValueType::U16:
+      return out.appendf("%s%u", separator, static_cast<unsigned>(registers[0]));
+    case ModbusValueType::S16:
+      return out.appendf("%s%d", separator, static_cast<int>(static_cast<int16_t>(registers[0])));
+    case ModbusValueType::U32:
+      return out.appendf("%s%lu", separator, static_cast<unsigned long>(wide));
+    case ModbusValueType::S32:
+      return out.appendf("%s%ld", separator, static_cast<long>(static_cast<int32_t>(wide)));
+    case ModbusValueType::F32: {
+      float value;
+      memcpy(&value, &wide, sizeof(value));
+      if (std::isfinite(value)) {
+        return out.appendf("%s%.4f", separator, static_cast<double>(value));
+      }
+      return out.appendf("%snull", separator);
+    }
+  }
+  return false;
+}
+
+// Orders blocks so mergeable ones end up adjacent, lowest register first.
+bool sortsBefore(const ModbusBlock& a, const ModbusBlock& b) {
+  if (a.slaveId != b.slaveId) {
+    return a.slaveId < b.slaveId;
+  }
+  if (a.function != b.function) {
+    return a.function < b.function;
+  }
+  if (a.intervalMs != b.intervalMs) {
+    return a.intervalMs < b.intervalMs;
+  }
+  return a.start < b.start;
+}
+}  // namespace
+
+ModbusPoller::ModbusPoller(ModbusBus& bus)
+    : _bus(bus),
+      _blocks(nullptr),
+      _transactionCount(0),
+      _lastStatsMs(0) {}
+
+size_t ModbusPoller::begin(const ModbusBlock* blocks, size_t count, unsigned long now) {
+  _blocks = blocks;
+  _transactionCount = 0;
+  _lastStatsMs = now;
+  if (!blocks) {
+    return 0;
+  }
+  if (count > kMaxBlocks) {
+    DC_LOG_WARN("Modbus", "Ignoring blocks beyond %lu", static_cast<unsigned long>(kMaxBlocks));
+    count = kMaxBlocks;
+  }
+
+  size_t valid = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (!validBlock(blocks[i])) {
+      DC_LOG_WARN("Modbus", "Skipping invalid block %s", blocks[i].name ? blocks[i].name : "");
+      continue;
+    }
+    // Insertion sort; the table is small and only sorted once.
+    size_t j = valid++;
+    while (j > 0 && sortsBefore(blocks[i], blocks[_order[j - 1]])) {
+      _order[j] = _order[j - 1];
+      --j;
+    }
+    _order[j] = static_cast<uint8_t>(i);
+  }
+
+  for (size_t i = 0; i < valid; ++i) {
+    const ModbusBlock& block = blocks[_order[i]];
+    uint32_t blockEnd = static_cast<uint32_t>(block.start) + block.count;
+    if (_transactionCount > 0) {
+      Transaction& last = _transactions[_transactionCount - 1];
+      uint32_t lastEnd = static_cast<uint32_t>(last.start) + last.count;
+      uint32_t mergedEnd = blockEnd > lastEnd ? blockEnd : lastEnd;
+      if (last.slaveId == block.slaveId && last.function == block.function && last.intervalMs == block.intervalMs &&
+          block.start <= lastEnd && mergedEnd - last.start <= ModbusBus::kMaxRegisters) {
+        last.count = static_cast<uint16_t>(mergedEnd - last.start);
+        ++last.blockCount;
+        continue;
+      }
+    }
+    Transaction& transaction = _transactions[_transactionCount++];
+    transaction.slaveId = block.slaveId;
+    transaction.function = block.function;
+    transaction.start = block.start;
+    transaction.count = block.count;
+    transaction.intervalMs = block.intervalMs;
+    transaction.nextDueMs = now;
+    transaction.firstBlock = static_cast<uint8_t>(i);
+    transaction.blockCount = 1;
+  }
+
+  DC_LOG_INFO("Modbus", "Polling %lu blocks in %lu transactions", static_cast<unsigned long>(valid),
+              static_cast<unsigned long>(_transactionCount));
+  return _transactionCount;
+}
+
+unsigned long ModbusPoller::run(unsigned long now, const DeviceConfig& config, MqttLayer& mqtt) {
+  if (_transactionCount == 0 || !_bus.enabled()) {
+    return kIdlePollMs;
+  }
+
+  // Serve the most overdue transaction first so a long block table cannot
+  // starve the entries at its end.
+  Transaction* due = nullptr;
+  unsigned long mostOverdue = 0;
+  for (size_t i = 0; i < _transactionCount; ++i) {
+    Transaction& transaction = _transactions[i];
+    long wait = static_cast<long>(transaction.nextDueMs - now);
+    if (wait > 0) {
+      continue;
+    }
+    unsigned long overdue = static_cast<unsigned long>(-wait);
+    if (!due || overdue > mostOverdue) {
+      due = &transaction;
+      mostOverdue = overdue;
+    }
+  }
+  if (due) {
+    execute(*due, now, config, mqtt);
+  }
+
+  if (now - _lastStatsMs >= kStatsIntervalMs) {
+    _lastStatsMs = now;
+    publishStats(config, mqtt);
+  }
+
+  unsigned long after = millis();
+  unsigned long sinceStats = after - _lastStatsMs;
+  unsigned long next = sinceStats >= kStatsIntervalMs ? 0 : kStatsIntervalMs - sinceStats;
+  for (size_t i = 0; i < _transactionCount; ++i) {
+    long wait = static_cast<long>(_transactions[i].nextDueMs - after);
+    if (wait <= 0) {
+      return 0;
+    }
+    if (static_cast<unsigned long>(wait) < next) {
+      next = static_cast<unsigned long>(wait);
+    }
+  }
+  return next;
+}
+
+void ModbusPoller::execute(Transaction& transaction, unsigned long now, const DeviceConfig& config, MqttLayer& mqtt) {
+  transaction.nextDueMs += transaction.intervalMs;
+  // After a long stall, realign instead of firing a burst of catch-up reads.
+  if (static_cast<long>(transaction.nextDueMs - now) <= 0) {
+    transaction.nextDueMs = now + transaction.intervalMs;
+  }
+
+  uint8_t exception = 0;
+  ModbusResult result = _bus.read(transaction.slaveId, transaction.function, transaction.start, transaction.count, _registers, exception);
+  if (result != ModbusResult::Ok) {
+    publishError(transaction, result, exception, config, mqtt);
+    return;
+  }
+  for (size_t i = 0; i < transaction.blockCount; ++i) {
+    const ModbusBlock& block = _blocks[_order[transaction.firstBlock + i]];
+    publishBlock(block, _registers + (block.start - transaction.start), config, mqtt);
+  }
+}
+
+void ModbusPoller::publishBlock(const ModbusBlock& block, const uint16_t* registers, const DeviceConfig& config, MqttLayer& mqtt) {
+  if (!config.modbusTopic || !mqtt.isConnected()) {
+    return;
+  }
+
+  size_t step = isWide(block.type) ? 2 : 1;
+  size_t messageStart = 0;
+  if (!beginBlockMessage(block, messageStart)) {
+    return;
+  }
+  for (size_t i = 0; i < block.count; i += step) {
+    size_t mark = _payload.length();
+    if (appendValue(_payload, block.type, registers + i, i == messageStart) &&
+        _payload.length() + kArrayTrailerLength <= kPayloadCapacity) {
+      continue;
+    }
+    // Close this message at the last value that fit and carry on in the next.
+    _payload.truncate(mark);
+    _payload.append("]}");
+    mqtt.publish(config.modbusTopic, _payload);
+    messageStart = i;
+    if (!beginBlockMessage(block, messageStart) || !appendValue(_payload, block.type, registers + i, true)) {
+      return;
+    }
+  }
+  _payload.append("]}");
+  mqtt.publish(config.modbusTopic, _payload);
+}
+
+bool ModbusPoller::beginBlockMessage(const ModbusBlock& block, size_t offset) {
+  _payload.clear();
+  if (!_payload.appendf("{\"block\":\"%s\",\"slave\":%u,\"reg\":%u,\"values\":[", block.name ? block.name : "",
+                        static_cast<unsigned>(block.slaveId), static_cast<unsigned>(block.start + offset)) ||
+      _payload.length() + kMaxValueLength + kArrayTrailerLength > kPayloadCapacity) {
+    DC_LOG_WARN("Modbus", "Block name too long: %s", block.name ? block.name : "");
+    return false;
+  }
+  return true;
+}
+
+void ModbusPoller::publishError(const Transaction& transaction, ModbusResult result, uint8_t exception, const DeviceConfig& config, MqttLayer& mqtt) {
+  if (!config.modbusTopic || !mqtt.isConnected()) {
+    return;
+  }
+
+  _payload.clear();
+  if (!_payload.appendf("{\"error\":\"%s\",\"slave\":%u,\"fn\":%u,\"reg\":%u,\"count\":%u,\"exception\":%u}",
+                        ModbusBus::resultName(result), static_cast<unsigned>(transaction.slaveId),
+                        static_cast<unsigned>(transaction.function), static_cast<unsigned>(transaction.start),
+                        static_cast<unsigned>(transaction.count), static_cast<unsigned>(exception))) {
+    return;
+  }
+  mqtt.publish(config.modbusTopic, _payload);
+}
+
+void ModbusPoller::publishStats(const DeviceConfig& config, MqttLayer& mqtt) {
+  if (!config.modbusTopic || !mqtt.isConnected() || _bus.slaveCount() == 0) {
+    return;
+  }
+
+  _payload.clear();
+  _payload.append("{\"modbusStats\":[");
+  size_t messageStart = 0;
+  for (size_t i = 0; i < _bus.slaveCount(); ++i) {
+    const ModbusSlaveStats& stats = _bus.slaveStats(i);
+    uint32_t replies = stats.transactions - stats.timeouts;
+    size_t mark = _payload.length();
+    bool fits = _payload.appendf(
+            "%s{\"slave\":%u,\"transactions\":%lu,\"ok\":%lu,\"timeouts\":%lu,\"crcErrors\":%lu,"
+            "\"exceptions\":%lu,\"lastMs\":%u,\"avgMs\":%lu,\"maxMs\":%u}",
+            i == messageStart ? "" : ",", static_cast<unsigned>(stats.slaveId),
+            static_cast<unsigned long>(stats.transactions), static_cast<unsigned long>(stats.ok),
+            static_cast<unsigned long>(stats.timeouts), static_cast<unsigned long>(stats.crcErrors),
+            static_cast<unsigned long>(stats.exceptions), static_cast<unsigned>(stats.lastLatencyMs),
+            static_cast<unsigned long>(replies ? stats.totalLatencyMs / replies : 0),
+            static_cast<unsigned>(stats.maxLatencyMs));
+    if (fits && _payload.length() + kArrayTrailerLength <= kPayloadCapacity) {
+      continue;
+    }
+    _payload.truncate(mark);
+    if (i == messageStart) {
+      // Cannot happen with kPayloadCapacity as set, but never spin on it.
+      messageStart = i + 1;
+      continue;
+    }
+    _payload.append("]}");
+    mqtt.publish(config.modbusTopic, _payload);
+    _payload.clear();
+    _payload.append("{\"modbusStats\":[");
+    // Retry this slave as the first entry of the next message.
+    messageStart = i;
+    --i;
+  }
+  _payload.append("]}");
+  mqtt.publish(config.modbusTopic, _payload);
+}
+
+}  // namespace DeviceCore
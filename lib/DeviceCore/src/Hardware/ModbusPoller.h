@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Arduino.h>
+#include "../Config/DeviceConfig.h"
+#include "../Core/FixedString.h"
+#include "../Network/MqttLayer.h"
+#include "ModbusBus.h"
+
+#ifndef DEVICECORE_MODBUS_MAX_BLOCKS
+#define DEVICECORE_MODBUS_MAX_BLOCKS 32
+#endif
+
+namespace DeviceCore {
+
+// Polls DeviceConfig::modbusBlocks on their own intervals. Blocks of the same
+// slave, function and interval whose registers touch or overlap are merged
+// into one read, and each block's decoded values are published as JSON on
+// DeviceConfig::modbusTopic. A block or stats report too long for one payload
+// is split across several messages; each block message's "reg" is the
+// register of its first value.
+class ModbusPoller {
+public:
+  static constexpr size_t kMaxBlocks = DEVICECORE_MODBUS_MAX_BLOCKS;
+
+  explicit ModbusPoller(ModbusBus& bus);
+
+  // Returns the number of bus transactions the blocks coalesced into.
+  size_t begin(const ModbusBlock* blocks, size_t count, unsigned long now);
+  bool enabled() const { return _transactionCount > 0; }
+
+  // Runs at most one due transaction so other tasks get the loop between
+  // reads. Returns the number of milliseconds until the next one is due.
+  unsigned long run(unsigned long now, const DeviceConfig& config, MqttLayer& mqtt);
+
+private:
+  static constexpr size_t kPayloadCapacity = 768;
+
+  struct Transaction {
+    uint8_t slaveId;
+    ModbusFunction function;
+    uint16_t start;
+    uint16_t count;
+    unsigned long intervalMs;
+    unsigned long nextDueMs;
+    uint8_t firstBlock;  // index into _order
+    uint8_t blockCount;
+  };
+
+  ModbusBus& _bus;
+  const ModbusBlock* _blocks;
+  uint8_t _order[kMaxBlocks];
+  Transaction _transactions[kMaxBlocks];
+  size_t _transactionCount;
+  uint16_t _registers[ModbusBus::kMaxRegisters];
+  FixedString<kPayloadCapacity> _payload;
+  unsigned long _lastStatsMs;
+
+  void execute(Transaction& transaction, unsigned long now, const DeviceConfig& config, MqttLayer& mqtt);
+  void publishBlock(const ModbusBlock& block, const uint16_t* registers, const DeviceConfig& config, MqttLayer& mqtt);
+  bool beginBlockMessage(const ModbusBlock& block, size_t offset);
+  void publishError(const Transaction& transaction, ModbusResult result, uint8_t exception, const DeviceConfig& config, MqttLayer& mqtt);
+  void publishStats(const DeviceConfig& config, MqttLayer& mqtt);
+};
+
+}  // namespace DeviceCore
@@ -1,45 +1,88 @@
 #include "SerialForwarder.h"
+#include "../Core/Log.h"
 #include <cstring>
 
 namespace DeviceCore {
 
 namespace {
 constexpr size_t kDefaultSerialBufferLimit = 256;
+constexpr unsigned long kReplayIntervalMs = 50UL;
+constexpr size_t kReplayBurst = 4;
+constexpr unsigned long kDefaultBatchLatencyMs = 50UL;
+constexpr unsigned long kIdleRecheckMs = 1000UL;
+
+size_t clampBufferLimit(size_t limit) {
+  if (limit == 0) {
+    limit = kDefaultSerialBufferLimit;
+  }
+  return limit > SerialForwarder::kBufferCapacity ? SerialForwarder::kBufferCapacity : limit;
 }
+}  // namespace
 
 SerialForwarder::SerialForwarder(size_t bufferLimit)
-    : _buffer(),
+    : _reportedDropped(0),
+      _reportedOverrunEvents(0),
+      _length(0),
+      _lineStart(0),
+      _batchEnd(0),
+      _batchLines(0),
+      _batchStartMs(0),
+      _lineArrivalMs(0),
+      _batchArrivalMs(0),
       _escapePending(false),
-      _bufferLimit(bufferLimit ? bufferLimit : kDefaultSerialBufferLimit) {
-  _buffer.reserve(_bufferLimit);
+      _bufferLimit(clampBufferLimit(bufferLimit)),
+      _lastReplayMs(0),
+      _replayActive(false),
+      _replayStartMs(0),
+      _replayStartCount(0) {}
+
+void SerialForwarder::begin(HardwareSerial& port, size_t rxDepth, size_t offlineQueueBytes) {
+  _ingest.begin(port, rxDepth);
+  _reportedDropped = 0;
+  _reportedOverrunEvents = 0;
+  _offlineQueue.begin(offlineQueueBytes);
 }
 
 void SerialForwarder::resetBuffer(size_t newLimit) {
-  _bufferLimit = newLimit ? newLimit : kDefaultSerialBufferLimit;
-  _buffer = "";
+  _bufferLimit = clampBufferLimit(newLimit);
+  _length = 0;
+  _lineStart = 0;
+  _batchEnd = 0;
+  _batchLines = 0;
   _escapePending = false;
-  _buffer.reserve(_bufferLimit);
 }
 
-void SerialForwarder::process(unsigned long now,
-                              const DeviceConfig& config,
-                              bool wifiConnected,
-                              bool mqttConnected,
-                              PubSubClient& client,
-                              LedSubsystem& leds) {
-  while (Serial.available() > 0) {
-    char ch = static_cast<char>(Serial.read());
+unsigned long SerialForwarder::process(unsigned long now,
+                                       const DeviceConfig& config,
+                                       bool wifiConnected,
+                                       bool mqttConnected,
+                                       MqttLayer& mqtt,
+                                       LedSubsystem& leds) {
+  uint32_t dropped = _ingest.droppedBytes();
+  if (dropped != _reportedDropped) {
+    DC_LOG_WARN("Serial", "Ingest ring full, bytes dropped: %lu", static_cast<unsigned long>(dropped - _reportedDropped));
+    _reportedDropped = dropped;
+    leds.requestErrPulse(now);
+  }
+  uint32_t overrunEvents = _ingest.overrunEvents();
+  if (overrunEvents != _reportedOverrunEvents) {
+    DC_LOG_WARN("Serial", "UART RX overrun, events: %lu", static_cast<unsigned long>(overrunEvents - _reportedOverrunEvents));
+    _reportedOverrunEvents = overrunEvents;
+    leds.requestErrPulse(now);
+  }
+
+  while (_ingest.available() > 0) {
+    if (_length == _lineStart && !_escapePending) {
+      _lineArrivalMs = _ingest.arrivalMs();
+    }
+    char ch = static_cast<char>(_ingest.read());
 
     if (_escapePending) {
       if (ch == 'n' || ch == 'N' || ch == 'r' || ch == 'R') {
-        flushBuffer(now, config, wifiConnected, mqttConnected, client, leds);
+        flushBuffer(now, config, wifiConnected, mqttConnected, mqtt, leds);
       } else {
-        if (_buffer.length() < _bufferLimit) {
-          _buffer += '\\';
-        }
-        if (_buffer.length() < _bufferLimit) {
-          _buffer += ch;
-        }
+        append('\\');
+        append(ch);
       }
       _escapePending = false;
       continue;
@@ -51,59 +94,195 @@ void SerialForwarder::process(unsigned long now,
     }
 
     if (ch == '\r' || ch == '\n') {
-      flushBuffer(now, config, wifiConnected, mqttConnected, client, leds);
+      flushBuffer(now, config, wifiConnected, mqttConnected, mqtt, leds);
       continue;
     }
 
-    if (_buffer.length() < _bufferLimit) {
-      _buffer += ch;
+    append(ch);
+  }
+
+  if (_batchLines > 0) {
+    unsigned long latency = config.serialBatchMaxLatencyMs ? config.serialBatchMaxLatencyMs : kDefaultBatchLatencyMs;
+    if (now - _batchStartMs >= latency || !wifiConnected || !mqttConnected) {
+      emitBatch(now, config, wifiConnected, mqttConnected, mqtt, leds);
     }
   }
+
+  _offlineQueue.loop(now);
+  if (wifiConnected && mqttConnected) {
+    replayOffline(now, config, mqtt);
+  }
+
+  unsigned long next = kIdleRecheckMs;
+  if (_batchLines > 0) {
+    unsigned long latency = config.serialBatchMaxLatencyMs ? config.serialBatchMaxLatencyMs : kDefaultBatchLatencyMs;
+    unsigned long elapsed = now - _batchStartMs;
+    next = elapsed >= latency ? 0 : latency - elapsed;
+  }
+  if (wifiConnected && mqttConnected && (_replayActive || !_offlineQueue.empty()) && kReplayIntervalMs < next) {
+    next = kReplayIntervalMs;
+  }
+  unsigned long flushIn = _offlineQueue.msUntilFlush(now);
+  return flushIn < next ? flushIn : next;
+}
+
+void SerialForwarder::append(char ch) {
+  if (_length - _lineStart < _bufferLimit && _length < kBufferCapacity) {
+    _buffer[_length++] = ch;
+  }
 }
 
 void SerialForwarder::flushBuffer(unsigned long now,
                                   const DeviceConfig& config,
                                   bool wifiConnected,
                                   bool mqttConnected,
-                                  PubSubClient& client,
+                                  MqttLayer& mqtt,
                                   LedSubsystem& leds) {
-  if (_buffer.length() == 0) {
+  _escapePending = false;
+  if (_length == _lineStart) {
+    return;
+  }
+
+  if (config.serialBatchMaxBytes > 0 && wifiConnected && mqttConnected) {
+    // Keep the line in place and separate it from the next one with '\n';
+    // the whole window goes out as a single publish. A line that would take
+    // the window past serialBatchMaxBytes sends it first and opens the next
+    // one; only a line longer than the limit by itself goes out over it.
+    if (_batchLines > 0 && _length > config.serialBatchMaxBytes) {
+      emitBatch(now, config, wifiConnected, mqttConnected, mqtt, leds);
+    }
+    if (_batchLines == 0) {
+      _batchStartMs = now;
+      _batchArrivalMs = _lineArrivalMs;
+    }
+    ++_batchLines;
+    _batchEnd = _length;
+    if (_batchEnd >= config.serialBatchMaxBytes || kBufferCapacity - _batchEnd <= _bufferLimit) {
+      _lineStart = _length;
+      emitBatch(now, config, wifiConnected, mqttConnected, mqtt, leds);
+    } else {
+      _buffer[_length++] = '\n';
+      _lineStart = _length;
+    }
     return;
   }
 
-  if (!wifiConnected) {
-    Serial.println("Serial forward skipped: WiFi not connected.");
+  if (_batchLines > 0) {
+    emitBatch(now, config, wifiConnected, mqttConnected, mqtt, leds);
+  }
+  deliver(now, config, wifiConnected, mqttConnected, mqtt, leds, _buffer, _length, 1, _lineArrivalMs);
+  _length = 0;
+  _lineStart = 0;
+}
+
+void SerialForwarder::emitBatch(unsigned long now,
+                                const DeviceConfig& config,
+                                bool wifiConnected,
+                                bool mqttConnected,
+                                MqttLayer& mqtt,
+                                LedSubsystem& leds) {
+  if (_batchLines == 0) {
+    return;
+  }
+
+  deliver(now, config, wifiConnected, mqttConnected, mqtt, leds, _buffer, _batchEnd, _batchLines, _batchArrivalMs);
+
+  // Move a partially received line to the front of the buffer.
+  size_t partial = _length - _lineStart;
+  if (partial > 0 && _lineStart > 0) {
+    memmove(_buffer, _buffer + _lineStart, partial);
+  }
+  _length = partial;
+  _lineStart = 0;
+  _batchEnd = 0;
+  _batchLines = 0;
+}
+
+void SerialForwarder::deliver(unsigned long now,
+                              const DeviceConfig& config,
+                              bool wifiConnected,
+                              bool mqttConnected,
+                              MqttLayer& mqtt,
+                              LedSubsystem& leds,
+                              const char* data,
+                              size_t length,
+                              size_t lines,
+                              unsigned long arrivalMs) {
+  if (!wifiConnected || !mqttConnected) {
+    if (_offlineQueue.push(now, data, length)) {
+      DC_LOG_DEBUG("Serial", "Forward deferred: %s not connected, queued %lu", !wifiConnected ? "WiFi" : "MQTT",
+                   static_cast<unsigned long>(_offlineQueue.depth()));
+    } else {
+      DC_LOG_WARN("Serial", "Forward skipped: %s not connected.", !wifiConnected ? "WiFi" : "MQTT");
+    }
     leds.requestErrPulse(now);
-  } else if (!mqttConnected) {
-    Serial.println("Serial forward skipped: MQTT not connected.");
+  } else if (publishLine(config, mqtt, data, length)) {
+    _publishLatency.record(millis() - arrivalMs);
+    if (lines > 1) {
+      DC_LOG_DEBUG("Serial", "Forwarded batch, lines: %lu, bytes: %lu", static_cast<unsigned long>(lines),
+                   static_cast<unsigned long>(length));
+    } else {
+      DC_LOG_DEBUG("Serial", "Forwarded: %.*s", static_cast<int>(length), data);
+    }
+    leds.requestUserPulse(now);
+  } else if ((!mqtt.isConnected() || mqtt.inflightFull()) && _offlineQueue.push(now, data, length)) {
+    // Socket dropped or QoS 1 window saturated; hold it for replay.
+    DC_LOG_DEBUG("Serial", "Forward deferred: MQTT busy, queued %lu", static_cast<unsigned long>(_offlineQueue.depth()));
     leds.requestErrPulse(now);
   } else {
-    bool serialOk = publishMessage(client, config.serialTopic, _buffer);
-    bool sameTopic = (config.serialTopic && config.primaryTopic && std::strcmp(config.serialTopic, config.primaryTopic) == 0);
-    bool primaryOk = sameTopic ? serialOk : publishMessage(client, config.primaryTopic, _buffer);
+    DC_LOG_ERROR("Serial", "Forward failed: MQTT publish error.");
+    leds.requestErrPulse(now);
+  }
+}
 
-    if (serialOk || primaryOk) {
-      if (!serialOk && primaryOk) {
-        Serial.println("Serial topic publish failed, mirrored via primary topic.");
-      }
-      Serial.print("Forwarded serial: ");
-      Serial.println(_buffer);
-      leds.requestUserPulse(now);
-    } else {
-      Serial.println("Serial forward failed: MQTT publish error.");
-      leds.requestErrPulse(now);
+void SerialForwarder::replayOffline(unsigned long now, const DeviceConfig& config, MqttLayer& mqtt) {
+  if (_offlineQueue.empty()) {
+    if (_replayActive) {
+      OfflineQueueStats stats = _offlineQueue.stats();
+      unsigned long elapsed = now - _replayStartMs;
+      uint32_t count = stats.replayed - _replayStartCount;
+      DC_LOG_INFO("OfflineQueue", "Replay complete, lines: %lu, ms: %lu, lines/s: %lu", static_cast<unsigned long>(count),
+                  elapsed, static_cast<unsigned long>(elapsed ? (count * 1000UL) / elapsed : count));
+      _replayActive = false;
     }
+    return;
   }
 
-  _buffer = "";
-  _escapePending = false;
+  // Drain a few lines per interval so live traffic keeps flowing.
+  if (now - _lastReplayMs < kReplayIntervalMs) {
+    return;
+  }
+  _lastReplayMs = now;
+
+  if (!_replayActive) {
+    _replayActive = true;
+    _replayStartMs = now;
+    _replayStartCount = _offlineQueue.stats().replayed;
+    DC_LOG_INFO("OfflineQueue", "Replaying queued lines: %lu", static_cast<unsigned long>(_offlineQueue.depth()));
+  }
+
+  for (size_t i = 0; i < kReplayBurst; ++i) {
+    size_t length = _offlineQueue.peek(_replayBuffer, sizeof(_replayBuffer));
+    if (length == 0) {
+      break;
+    }
+    if (!publishLine(config, mqtt, _replayBuffer, length)) {
+      break;
+    }
+    _offlineQueue.pop(now);
+  }
 }
 
-bool SerialForwarder::publishMessage(PubSubClient& client, const char* topic, const String& payload) {
-  if (!topic || topic[0] == '\0') {
-    return false;
+bool SerialForwarder::publishLine(const DeviceConfig& config, MqttLayer& mqtt, const char* data, size_t length) {
+  const uint8_t* payload = reinterpret_cast<const uint8_t*>(data);
+  bool serialOk = mqtt.publish(config.serialTopic, payload, length, config.mqttQos);
+  bool sameTopic = (config.serialTopic && config.primaryTopic && std::strcmp(config.serialTopic, config.primaryTopic) == 0);
+  bool primaryOk = sameTopic ? serialOk : mqtt.publish(config.primaryTopic, payload, length, config.mqttQos);
+
+  if (!serialOk && primaryOk) {
+    DC_LOG_WARN("Serial", "Serial topic publish failed, mirrored via primary topic.");
   }
-  return client.publish(topic, payload.c_str());
+  return serialOk || primaryOk;
 }
 
 }  // namespace DeviceCore
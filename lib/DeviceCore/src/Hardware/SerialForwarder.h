@@ -1,36 +1,97 @@
 #pragma once
 
 #include <Arduino.h>
-#include <PubSubClient.h>
 #include "../Config/DeviceConfig.h"
+#include "../Network/MqttLayer.h"
 #include "LedSubsystem.h"
+#include "SerialIngest.h"
+#include "../Core/LatencyHistogram.h"
+#include "../Storage/OfflineQueue.h"
+
+#ifndef DEVICECORE_SERIAL_BUFFER_CAPACITY
+#define DEVICECORE_SERIAL_BUFFER_CAPACITY 1024
+#endif
 
 namespace DeviceCore {
 
 class SerialForwarder {
 public:
+  // Upper bound for DeviceConfig::serialBufferLimit; the line buffer is
+  // statically sized so forwarding never touches the heap.
+  static constexpr size_t kBufferCapacity = DEVICECORE_SERIAL_BUFFER_CAPACITY;
+
   explicit SerialForwarder(size_t bufferLimit);
 
+  void begin(HardwareSerial& port, size_t rxDepth, size_t offlineQueueBytes);
   void resetBuffer(size_t newLimit);
-  void process(unsigned long now,
-               const DeviceConfig& config,
-               bool wifiConnected,
-               bool mqttConnected,
-               PubSubClient& client,
-               LedSubsystem& leds);
+  size_t bufferLimit() const { return _bufferLimit; }
+  uint32_t droppedBytes() const { return _ingest.droppedBytes(); }
+  uint32_t overrunEvents() const { return _ingest.overrunEvents(); }
+  OfflineQueueStats offlineStats() const { return _offlineQueue.stats(); }
+  // Milliseconds from a line's first byte reaching the ingest ring to its
+  // publish being handed to MQTT; offline replays are not included.
+  const LatencyHistogram& publishLatency() const { return _publishLatency; }
+  void resetPublishLatency() { _publishLatency.reset(); }
+  bool hasInput() const { return _ingest.available() > 0; }
+  void setWakeHandler(SerialIngest::WakeFn wake) { _ingest.setWakeHandler(wake); }
+  // Bracket a transaction by another protocol on the same UART.
+  void suspendInput() { _ingest.suspend(); }
+  void resumeInput() { _ingest.resume(); }
+  // Returns the number of milliseconds until process() has timed work again.
+  unsigned long process(unsigned long now,
+                        const DeviceConfig& config,
+                        bool wifiConnected,
+                        bool mqttConnected,
+                        MqttLayer& mqtt,
+                        LedSubsystem& leds);
 
 private:
-  String _buffer;
+  SerialIngest _ingest;
+  uint32_t _reportedDropped;
+  uint32_t _reportedOverrunEvents;
+  char _buffer[kBufferCapacity];
+  size_t _length;
+  size_t _lineStart;
+  size_t _batchEnd;
+  size_t _batchLines;
+  unsigned long _batchStartMs;
+  unsigned long _lineArrivalMs;
+  unsigned long _batchArrivalMs;
+  LatencyHistogram _publishLatency;
   bool _escapePending;
   size_t _bufferLimit;
+  OfflineQueue _offlineQueue;
+  char _replayBuffer[kBufferCapacity];
+  unsigned long _lastReplayMs;
+  bool _replayActive;
+  unsigned long _replayStartMs;
+  uint32_t _replayStartCount;
 
+  void append(char ch);
+  void replayOffline(unsigned long now, const DeviceConfig& config, MqttLayer& mqtt);
+  void emitBatch(unsigned long now,
+                 const DeviceConfig& config,
+                 bool wifiConnected,
+                 bool mqttConnected,
+                 MqttLayer& mqtt,
+                 LedSubsystem& leds);
+  void deliver(unsigned long now,
+               const DeviceConfig& config,
+               bool wifiConnected,
+               bool mqttConnected,
+               MqttLayer& mqtt,
+               LedSubsystem& leds,
+               const char* data,
+               size_t length,
+               size_t lines,
+               unsigned long arrivalMs);
+  bool publishLine(const DeviceConfig& config, MqttLayer& mqtt, const char* data, size_t length);
   void flushBuffer(unsigned long now,
                    const DeviceConfig& config,
                    bool wifiConnected,
                    bool mqttConnected,
-                   PubSubClient& client,
+                   MqttLayer& mqtt,
                    LedSubsystem& leds);
-  bool publishMessage(PubSubClient& client, const char* topic, const String& payload);
 };
 
 }  // namespace DeviceCore
@@ -0,0 +1,141 @@
+#include "SerialIngest.h"
+
+namespace DeviceCore {
+
+namespace {
+constexpr size_t kDefaultSerialRxDepth = 1024;
+constexpr uint32_t kSerialIngestPollMs = 5;
+
+size_t normalizeDepth(size_t depth) {
+  if (depth == 0) {
+    depth = kDefaultSerialRxDepth;
+  }
+  if (depth > SerialIngest::kCapacity) {
+    depth = SerialIngest::kCapacity;
+  }
+  size_t rounded = 1;
+  while (rounded * 2 <= depth) {
+    rounded *= 2;
+  }
+  return rounded;
+}
+}  // namespace
+
+SerialIngest::SerialIngest()
+    : _port(nullptr),
+      _wake(nullptr),
+      _mask(normalizeDepth(0) - 1),
+      _head(0),
+      _tail(0),
+      _droppedBytes(0),
+      _overrunEvents(0),
+      _suspended(false),
+      _markCount(0) {}
+
+void SerialIngest::begin(HardwareSerial& port, size_t depth) {
+  end();
+  _port = &port;
+  _mask = normalizeDepth(depth) - 1;
+  _head.store(0, std::memory_order_relaxed);
+  _tail.store(0, std::memory_order_relaxed);
+  _droppedBytes.store(0, std::memory_order_relaxed);
+  _overrunEvents.store(0, std::memory_order_relaxed);
+  _suspended.store(false, std::memory_order_relaxed);
+  _markCount.store(0, std::memory_order_relaxed);
+  _ticker.attach_ms(kSerialIngestPollMs, &SerialIngest::onTick, this);
+}
+
+void SerialIngest::end() {
+  _ticker.detach();
+  _port = nullptr;
+}
+
+size_t SerialIngest::available() const {
+  return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed);
+}
+
+int SerialIngest::read() {
+  size_t tail = _tail.load(std::memory_order_relaxed);
+  if (tail == _head.load(std::memory_order_acquire)) {
+    return -1;
+  }
+  uint8_t value = _storage[tail & _mask];
+  _tail.store(tail + 1, std::memory_order_release);
+  return value;
+}
+
+unsigned long SerialIngest::arrivalMs() const {
+  uint32_t marks = _markCount.load(std::memory_order_acquire);
+  size_t tail = _tail.load(std::memory_order_relaxed);
+  if (marks == 0) {
+    return millis();
+  }
+  uint32_t held = marks < kArrivalMarks ? marks : kArrivalMarks;
+  size_t slot = 0;
+  // Newest first: the first mark at or before the read position covers it.
+  for (uint32_t i = 1; i <= held; ++i) {
+    slot = (marks - i) % kArrivalMarks;
+    if (static_cast<long>(tail - _markPosition[slot]) >= 0) {
+      break;
+    }
+  }
+  return _markMs[slot];
+}
+
+void SerialIngest::suspend() {
+  // Collect whatever arrived before the hand-over so it is still forwarded.
+  pump();
+  _suspended.store(true, std::memory_order_relaxed);
+}
+
+void SerialIngest::resume() {
+  _suspended.store(false, std::memory_order_relaxed);
+}
+
+void SerialIngest::pump() {
+  if (!_port || _suspended.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  size_t head = _head.load(std::memory_order_relaxed);
+  size_t start = head;
+  size_t tail = _tail.load(std::memory_order_acquire);
+  uint32_t dropped = 0;
+
+  while (_port->available() > 0) {
+    int value = _port->read();
+    if (value < 0) {
+      break;
+    }
+    if (head - tail > _mask) {
+      ++dropped;
+      continue;
+    }
+    _storage[head & _mask] = static_cast<uint8_t>(value);
+    ++head;
+  }
+  if (head != start) {
+    uint32_t mark = _markCount.load(std::memory_order_relaxed);
+    _markPosition[mark % kArrivalMarks] = start;
+    _markMs[mark % kArrivalMarks] = millis();
+    _markCount.store(mark + 1, std::memory_order_release);
+  }
+  _head.store(head, std::memory_order_release);
+  if (head != start && _wake) {
+    _wake();
+  }
+
+  if (dropped) {
+    _droppedBytes.store(_droppedBytes.load(std::memory_order_relaxed) + dropped, std::memory_order_relaxed);
+  }
+  // The core's own ISR buffer may have overflowed before we got scheduled.
+  if (_port->hasOverrun()) {
+    _overrunEvents.store(_overrunEvents.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+}
+
+void SerialIngest::onTick(SerialIngest* self) {
+  self->pump();
+}
+
+}  // namespace DeviceCore
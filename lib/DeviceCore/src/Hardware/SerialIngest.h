@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Ticker.h>
+#include <atomic>
+
+#ifndef DEVICECORE_SERIAL_INGEST_CAPACITY
+#define DEVICECORE_SERIAL_INGEST_CAPACITY 2048
+#endif
+
+namespace DeviceCore {
+
+// Single-producer/single-consumer byte ring fed from a timer callback, so the
+// UART keeps being drained while the main loop is blocked in network code.
+// The timer is the only writer of _head, the loop the only writer of _tail.
+class SerialIngest {
+public:
+  static constexpr size_t kCapacity = DEVICECORE_SERIAL_INGEST_CAPACITY;
+  static constexpr size_t kArrivalMarks = 32;
+  static_assert((kCapacity & (kCapacity - 1)) == 0, "Serial ingest capacity must be a power of two");
+
+  typedef void (*WakeFn)();
+
+  SerialIngest();
+
+  void begin(HardwareSerial& port, size_t depth);
+  void end();
+  // Called from the producer whenever new bytes land in the ring.
+  void setWakeHandler(WakeFn wake) { _wake = wake; }
+
+  size_t available() const;
+  int read();
+  size_t depth() const { return _mask + 1; }
+  // millis() at which the next unread byte was pumped in. Each pump leaves
+  // one mark, so once the backlog spans more than kArrivalMarks pumps this
+  // is the oldest mark still held: a lower bound.
+  unsigned long arrivalMs() const;
+  // Bytes the ring had no room for.
+  uint32_t droppedBytes() const { return _droppedBytes.load(std::memory_order_relaxed); }
+  // RX FIFO overflows the core reported; each lost an unknown number of bytes.
+  uint32_t overrunEvents() const { return _overrunEvents.load(std::memory_order_relaxed); }
+
+  // Hands the UART to another protocol: the ring keeps what it already holds
+  // but pump() leaves the port alone until resume().
+  void suspend();
+  void resume();
+  bool suspended() const { return _suspended.load(std::memory_order_relaxed); }
+
+  // Producer side; runs from the ticker but may also be called inline.
+  void pump();
+
+private:
+  static void onTick(SerialIngest* self);
+
+  Ticker _ticker;
+  HardwareSerial* _port;
+  WakeFn _wake;
+  uint8_t _storage[kCapacity];
+  size_t _mask;
+  std::atomic<size_t> _head;
+  std::atomic<size_t> _tail;
+  std::atomic<uint32_t> _droppedBytes;
+  std::atomic<uint32_t> _overrunEvents;
+  std::atomic<bool> _suspended;
+  // Written by the producer before it publishes _head.
+  size_t _markPosition[kArrivalMarks];
+  unsigned long _markMs[kArrivalMarks];
+  std::atomic<uint32_t> _markCount;
+};
+
+}  // namespace DeviceCore
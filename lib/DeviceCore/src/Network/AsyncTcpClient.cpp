@@ -0,0 +1,171 @@
+#include "AsyncTcpClient.h"
+#include "../Core/Log.h"
+#include <coredecls.h>
+#include <cstring>
+
+namespace DeviceCore {
+
+AsyncTcpClient::AsyncTcpClient()
+    : _state(State::Closed),
+      _rxHead(0),
+      _rxLength(0),
+      _pendingError(0),
+      _pendingOverrun(false) {
+  _client.onConnect(&AsyncTcpClient::onConnect, this);
+  _client.onDisconnect(&AsyncTcpClient::onDisconnect, this);
+  _client.onError(&AsyncTcpClient::onError, this);
+  _client.onData(&AsyncTcpClient::onData, this);
+}
+
+bool AsyncTcpClient::open(const char* host, uint16_t port) {
+  stop();
+  _state = State::Connecting;
+  if (!host || !_client.connect(host, port)) {
+    _state = State::Closed;
+    return false;
+  }
+  return true;
+}
+
+int AsyncTcpClient::connect(IPAddress ip, uint16_t port) {
+  return 0;
+}
+
+int AsyncTcpClient::connect(const char* host, uint16_t port) {
+  return 0;
+}
+
+size_t AsyncTcpClient::write(uint8_t value) {
+  return write(&value, 1);
+}
+
+size_t AsyncTcpClient::write(const uint8_t* buffer, size_t size) {
+  size_t written = 0;
+  unsigned long start = millis();
+  while (written < size && _state == State::Connected) {
+    size_t room = _client.space();
+    if (room == 0) {
+      unsigned long elapsed = millis() - start;
+      if (elapsed >= getTimeout()) {
+        break;
+      }
+      esp_delay(getTimeout() - elapsed, [this]() { return _state == State::Connected && _client.space() == 0; }, 1);
+      continue;
+    }
+    size_t chunk = size - written < room ? size - written : room;
+    size_t added = _client.add(reinterpret_cast<const char*>(buffer + written), chunk, ASYNC_WRITE_FLAG_COPY);
+    if (added == 0) {
+      break;
+    }
+    written += added;
+    _client.send();
+  }
+  return written;
+}
+
+int AsyncTcpClient::available() {
+  reportEvents();
+  if (_rxLength == 0) {
+    // Incoming segments are only processed while the SDK has the CPU.
+    optimistic_yield(100);
+  }
+  return static_cast<int>(_rxLength);
+}
+
+int AsyncTcpClient::read() {
+  uint8_t value;
+  return read(&value, 1) == 1 ? value : -1;
+}
+
+int AsyncTcpClient::read(uint8_t* buffer, size_t size) {
+  size_t count = size < _rxLength ? size : _rxLength;
+  size_t first = kRxCapacity - _rxHead < count ? kRxCapacity - _rxHead : count;
+  memcpy(buffer, _rx + _rxHead, first);
+  memcpy(buffer + first, _rx, count - first);
+  _rxHead = (_rxHead + count) % kRxCapacity;
+  _rxLength -= count;
+  if (count > 0 && _state == State::Connected) {
+    _client.ack(count);
+  }
+  return static_cast<int>(count);
+}
+
+int AsyncTcpClient::peek() {
+  return _rxLength > 0 ? _rx[_rxHead] : -1;
+}
+
+void AsyncTcpClient::stop() {
+  _state = State::Closed;
+  _client.close(true);
+  _rxHead = 0;
+  _rxLength = 0;
+}
+
+// Like WiFiClient, still connected while unread data remains after the peer
+// has closed.
+uint8_t AsyncTcpClient::connected() {
+  reportEvents();
+  return _state == State::Connected || _rxLength > 0;
+}
+
+AsyncTcpClient::operator bool() {
+  return connected();
+}
+
+void AsyncTcpClient::reportEvents() {
+  if (_pendingError != 0) {
+    DC_LOG_DEBUG("TCP", "Connection error %d", static_cast<int>(_pendingError));
+    _pendingError = 0;
+  }
+  if (_pendingOverrun) {
+    DC_LOG_ERROR("TCP", "Receive buffer overrun, closing.");
+    _pendingOverrun = false;
+  }
+}
+
+void AsyncTcpClient::onConnect(void* context, AsyncClient* client) {
+  AsyncTcpClient* self = static_cast<AsyncTcpClient*>(context);
+  if (self->_state != State::Connecting) {
+    // A lookup that outlived stop() went on to connect; nobody wants it.
+    client->close(true);
+    return;
+  }
+  client->setNoDelay(true);
+  self->_state = State::Connected;
+}
+
+void AsyncTcpClient::onDisconnect(void* context, AsyncClient* client) {
+  static_cast<AsyncTcpClient*>(context)->_state = State::Closed;
+}
+
+void AsyncTcpClient::onError(void* context, AsyncClient* client, int8_t error) {
+  AsyncTcpClient* self = static_cast<AsyncTcpClient*>(context);
+  self->_pendingError = error;
+  self->_state = State::Closed;
+}
+
+void AsyncTcpClient::onData(void* context, AsyncClient* client, void* data, size_t length) {
+  AsyncTcpClient* self = static_cast<AsyncTcpClient*>(context);
+  if (self->_state != State::Connected) {
+    return;
+  }
+  if (length > kRxCapacity - self->_rxLength) {
+    // Only possible if lwIP's window is larger than the buffer; the stream
+    // cannot be resumed after a gap.
+    self->_pendingOverrun = true;
+    self->_state = State::Closed;
+    self->_rxLength = 0;
+    client->close();
+    return;
+  }
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  size_t tail = (self->_rxHead + self->_rxLength) % kRxCapacity;
+  size_t first = kRxCapacity - tail < length ? kRxCapacity - tail : length;
+  memcpy(self->_rx + tail, bytes, first);
+  memcpy(self->_rx, bytes + first, length - first);
+  self->_rxLength += length;
+  // Acknowledged from read(), which reopens the window as we consume.
+  client->ackLater();
+}
+
+}  // namespace DeviceCore
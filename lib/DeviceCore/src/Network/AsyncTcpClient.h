@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Client.h>
+#include <ESPAsyncTCP.h>
+
+#ifndef DEVICECORE_TCP_RX_BYTES
+// At least lwIP's TCP_WND: 4 * 536 in the core's default low-memory build.
+#define DEVICECORE_TCP_RX_BYTES 2144
+#endif
+
+namespace DeviceCore {
+
+// Client on an ESPAsyncTCP connection, so the name lookup and the TCP
+// handshake run in the background instead of inside connect(). open()
+// starts both and returns at once; poll connecting() until it settles.
+// Received data is copied into a fixed buffer and acknowledged only as it
+// is read, so the advertised window never lets the peer send more than the
+// buffer holds. write() waits for send buffer space for at most the Stream
+// timeout, as WiFiClient does.
+class AsyncTcpClient : public Client {
+public:
+  static constexpr size_t kRxCapacity = DEVICECORE_TCP_RX_BYTES;
+
+  AsyncTcpClient();
+
+  bool open(const char* host, uint16_t port);
+  bool connecting() const { return _state == State::Connecting; }
+
+  // Blocking connects are not offered; these fail without touching the
+  // socket. Open it first and PubSubClient skips its own connect.
+  int connect(IPAddress ip, uint16_t port) override;
+  int connect(const char* host, uint16_t port) override;
+  size_t write(uint8_t value) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  int available() override;
+  int read() override;
+  int read(uint8_t* buffer, size_t size) override;
+  int peek() override;
+  void flush() override {}
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override;
+
+private:
+  enum class State : uint8_t {
+    Closed,
+    Connecting,
+    Connected,
+  };
+
+  AsyncClient _client;
+  State _state;
+  uint8_t _rx[kRxCapacity];
+  size_t _rxHead;
+  size_t _rxLength;
+  // Set by the lwIP callbacks, which may not log; reported from the loop.
+  int8_t _pendingError;
+  bool _pendingOverrun;
+
+  void reportEvents();
+
+  static void onConnect(void* context, AsyncClient* client);
+  static void onDisconnect(void* context, AsyncClient* client);
+  static void onError(void* context, AsyncClient* client, int8_t error);
+  static void onData(void* context, AsyncClient* client, void* data, size_t length);
+};
+
+}  // namespace DeviceCore
@@ -0,0 +1,198 @@
+#include "CommandDispatcher.h"
+#include "../Core/Log.h"
+
+#include <cstring>
+
+namespace DeviceCore {
+
+namespace {
+constexpr size_t kArenaAlign = 8;
+constexpr uint32_t kFnvOffset = 2166136261UL;
+constexpr uint32_t kFnvPrime = 16777619UL;
+
+static_assert((CommandDispatcher::kSlots & (CommandDispatcher::kSlots - 1)) == 0, "command slots must be a power of two");
+
+size_t alignUp(size_t value) {
+  return (value + kArenaAlign - 1) & ~(kArenaAlign - 1);
+}
+
+uint32_t fnv1a(uint32_t hash, const char* text) {
+  if (!text) {
+    return hash;
+  }
+  while (*text) {
+    hash ^= static_cast<uint8_t>(*text++);
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+bool sameTopic(const char* a, const char* b) {
+  if (!a || !b) {
+    return a == b;
+  }
+  return std::strcmp(a, b) == 0;
+}
+}
+
+CommandArena::CommandArena()
+    : _used(0),
+      _last(kCapacity),
+      _highWater(0) {}
+
+void* CommandArena::allocate(size_t size) {
+  size_t start = alignUp(_used);
+  if (start > kCapacity || size > kCapacity - start) {
+    return nullptr;
+  }
+  _last = start;
+  _used = start + size;
+  if (_used > _highWater) {
+    _highWater = _used;
+  }
+  return _buffer + start;
+}
+
+void CommandArena::deallocate(void* pointer) {
+  // Only the most recent block can be returned; the rest goes on reset().
+  if (pointer && static_cast<uint8_t*>(pointer) == _buffer + _last) {
+    _used = _last;
+    _last = kCapacity;
+  }
+}
+
+void* CommandArena::reallocate(void* pointer, size_t newSize) {
+  if (!pointer) {
+    return allocate(newSize);
+  }
+
+  uint8_t* block = static_cast<uint8_t*>(pointer);
+  if (block == _buffer + _last) {
+    if (newSize > kCapacity - _last) {
+      return nullptr;
+    }
+    _used = _last + newSize;
+    if (_used > _highWater) {
+      _highWater = _used;
+    }
+    return block;
+  }
+
+  // Not the tail block: grow by copying. The old size is unknown, but it
+  // cannot extend past the current end of the arena.
+  size_t oldMax = static_cast<size_t>(_buffer + _used - block);
+  void* moved = allocate(newSize);
+  if (moved) {
+    std::memcpy(moved, block, oldMax < newSize ? oldMax : newSize);
+  }
+  return moved;
+}
+
+void CommandArena::reset() {
+  _used = 0;
+  _last = kCapacity;
+}
+
+CommandDispatcher::CommandDispatcher()
+    : _entries(),
+      _count(0),
+      _topics(),
+      _topicCount(0),
+      _stats() {}
+
+uint32_t CommandDispatcher::hashKey(const char* topic, const char* cmd) {
+  uint32_t hash = fnv1a(kFnvOffset, topic);
+  hash ^= 0xFF;
+  hash *= kFnvPrime;
+  return fnv1a(hash, cmd);
+}
+
+bool CommandDispatcher::add(const char* topic, const char* cmd, Handler handler, void* context) {
+  if (!cmd || !handler || _count >= kSlots - 1) {
+    return false;
+  }
+
+  uint32_t hash = hashKey(topic, cmd);
+  size_t index = hash & (kSlots - 1);
+  while (_entries[index].handler) {
+    Entry& entry = _entries[index];
+    if (entry.hash == hash && sameTopic(entry.topic, topic) && std::strcmp(entry.cmd, cmd) == 0) {
+      entry.handler = handler;
+      entry.context = context;
+      return true;
+    }
+    index = (index + 1) & (kSlots - 1);
+  }
+
+  _entries[index] = {hash, topic, cmd, handler, context};
+  ++_count;
+  if (topic && !hasOwnCommands(topic)) {
+    _topics[_topicCount++] = topic;
+  }
+  return true;
+}
+
+const CommandDispatcher::Entry* CommandDispatcher::find(const char* topic, const char* cmd) const {
+  uint32_t hash = hashKey(topic, cmd);
+  size_t index = hash & (kSlots - 1);
+  while (_entries[index].handler) {
+    const Entry& entry = _entries[index];
+    if (entry.hash == hash && sameTopic(entry.topic, topic) && std::strcmp(entry.cmd, cmd) == 0) {
+      return &entry;
+    }
+    index = (index + 1) & (kSlots - 1);
+  }
+  return nullptr;
+}
+
+bool CommandDispatcher::hasOwnCommands(const char* topic) const {
+  for (size_t i = 0; i < _topicCount; ++i) {
+    if (std::strcmp(_topics[i], topic) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CommandDispatcher::dispatch(const char* topic, const uint8_t* payload, size_t length) {
+  _arena.reset();
+  bool handled = false;
+  {
+    JsonDocument doc(&_arena);
+    DeserializationError err = deserializeJson(doc, payload, length);
+    if (err) {
+      // Plain-text traffic on the subscribed topics is normal; only count
+      // payloads that looked like JSON.
+      if (length > 0 && payload[0] == '{') {
+        ++_stats.parseErrors;
+        DC_LOG_WARN("Cmd", "Parse failed: %s", err.c_str());
+      }
+    } else {
+      const char* cmd = doc["cmd"].as<const char*>();
+      if (cmd) {
+        const Entry* entry = find(topic, cmd);
+        if (!entry && (!topic || !hasOwnCommands(topic))) {
+          entry = find(nullptr, cmd);
+        }
+        if (entry) {
+          entry->handler(entry->context, doc.as<JsonVariantConst>());
+          ++_stats.dispatched;
+          handled = true;
+        } else {
+          ++_stats.unknown;
+          DC_LOG_WARN("Cmd", "Unknown command: %s", cmd);
+        }
+      }
+    }
+  }
+  _arena.reset();
+  return handled;
+}
+
+CommandStats CommandDispatcher::stats() const {
+  CommandStats stats = _stats;
+  stats.arenaHighWater = _arena.highWater();
+  return stats;
+}
+
+}  // namespace DeviceCore
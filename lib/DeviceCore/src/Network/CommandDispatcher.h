@@ -0,0 +1,86 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#ifndef DEVICECORE_COMMAND_ARENA_BYTES
+#define DEVICECORE_COMMAND_ARENA_BYTES 2048
+#endif
+
+#ifndef DEVICECORE_COMMAND_SLOTS
+#define DEVICECORE_COMMAND_SLOTS 16
+#endif
+
+namespace DeviceCore {
+
+// Bump allocator over a fixed buffer for ArduinoJson. Everything handed out
+// is released at once by reset(), so parsing a command never touches the heap.
+class CommandArena : public ArduinoJson::Allocator {
+public:
+  static constexpr size_t kCapacity = DEVICECORE_COMMAND_ARENA_BYTES;
+
+  CommandArena();
+
+  void* allocate(size_t size) override;
+  void deallocate(void* pointer) override;
+  void* reallocate(void* pointer, size_t newSize) override;
+
+  void reset();
+  size_t used() const { return _used; }
+  size_t highWater() const { return _highWater; }
+
+private:
+  alignas(8) uint8_t _buffer[kCapacity];
+  size_t _used;
+  size_t _last;
+  size_t _highWater;
+};
+
+struct CommandStats {
+  uint32_t dispatched;
+  uint32_t unknown;
+  uint32_t parseErrors;
+  size_t arenaHighWater;
+};
+
+// Routes inbound MQTT JSON payloads to handlers keyed by topic and "cmd".
+// Lookup is an open-addressed FNV-1a table; registering with a null topic
+// matches the command on any subscribed topic that has no registrations of
+// its own. A topic with registrations only reaches its own handlers.
+class CommandDispatcher {
+public:
+  using Handler = void (*)(void* context, JsonVariantConst message);
+
+  static constexpr size_t kSlots = DEVICECORE_COMMAND_SLOTS;
+
+  CommandDispatcher();
+
+  // topic and cmd must outlive the dispatcher.
+  bool add(const char* topic, const char* cmd, Handler handler, void* context);
+  bool dispatch(const char* topic, const uint8_t* payload, size_t length);
+
+  CommandStats stats() const;
+
+private:
+  struct Entry {
+    uint32_t hash;
+    const char* topic;
+    const char* cmd;
+    Handler handler;
+    void* context;
+  };
+
+  Entry _entries[kSlots];
+  size_t _count;
+  // Topics with registrations of their own; they skip the null-topic table.
+  const char* _topics[kSlots];
+  size_t _topicCount;
+  CommandArena _arena;
+  CommandStats _stats;
+
+  static uint32_t hashKey(const char* topic, const char* cmd);
+  const Entry* find(const char* topic, const char* cmd) const;
+  bool hasOwnCommands(const char* topic) const;
+};
+
+}  // namespace DeviceCore
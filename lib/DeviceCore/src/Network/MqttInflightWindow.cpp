@@ -0,0 +1,94 @@
+#include "MqttInflightWindow.h"
+#include <cstring>
+
+namespace DeviceCore {
+
+MqttInflightWindow::MqttInflightWindow()
+    : _window(kMaxSlots),
+      _count(0),
+      _nextPacketId(1),
+      _nextSequence(1),
+      _stats() {
+  for (size_t i = 0; i < kMaxSlots; ++i) {
+    _slots[i].used = false;
+  }
+}
+
+void MqttInflightWindow::setWindow(size_t window) {
+  if (window == 0 || window > kMaxSlots) {
+    window = kMaxSlots;
+  }
+  _window = window;
+}
+
+bool MqttInflightWindow::fits(const char* topic, size_t length) {
+  return topic && strlen(topic) <= kMaxTopic && length <= kMaxPayload;
+}
+
+MqttInflightWindow::Entry* MqttInflightWindow::acquire(const char* topic, const uint8_t* payload, size_t length) {
+  if (full() || !fits(topic, length)) {
+    return nullptr;
+  }
+
+  Entry* slot = nullptr;
+  for (size_t i = 0; i < kMaxSlots; ++i) {
+    if (!_slots[i].used) {
+      slot = &_slots[i];
+      break;
+    }
+  }
+  if (!slot) {
+    return nullptr;
+  }
+
+  do {
+    if (++_nextPacketId == 0) {
+      _nextPacketId = 1;
+    }
+  } while (packetIdInUse(_nextPacketId));
+
+  slot->used = true;
+  slot->packetId = _nextPacketId;
+  slot->sequence = _nextSequence++;
+  slot->length = static_cast<uint16_t>(length);
+  strncpy(slot->topic, topic, kMaxTopic);
+  slot->topic[kMaxTopic] = '\0';
+  memcpy(slot->payload, payload, length);
+  ++_count;
+  ++_stats.published;
+  return slot;
+}
+
+bool MqttInflightWindow::release(uint16_t packetId) {
+  for (size_t i = 0; i < kMaxSlots; ++i) {
+    if (_slots[i].used && _slots[i].packetId == packetId) {
+      _slots[i].used = false;
+      --_count;
+      ++_stats.acked;
+      return true;
+    }
+  }
+  return false;
+}
+
+MqttInflightWindow::Entry* MqttInflightWindow::nextPending(uint32_t afterSequence) {
+  Entry* next = nullptr;
+  for (size_t i = 0; i < kMaxSlots; ++i) {
+    Entry& slot = _slots[i];
+    if (slot.used && slot.sequence > afterSequence && (!next || slot.sequence < next->sequence)) {
+      next = &slot;
+    }
+  }
+  return next;
+}
+
+bool MqttInflightWindow::packetIdInUse(uint16_t packetId) const {
+  for (size_t i = 0; i < kMaxSlots; ++i) {
+    if (_slots[i].used && _slots[i].packetId == packetId) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace DeviceCore
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Arduino.h>
+
+#ifndef DEVICECORE_MQTT_INFLIGHT_MAX
+#define DEVICECORE_MQTT_INFLIGHT_MAX 4
+#endif
+
+#ifndef DEVICECORE_MQTT_INFLIGHT_PAYLOAD
+#define DEVICECORE_MQTT_INFLIGHT_PAYLOAD 1024
+#endif
+
+namespace DeviceCore {
+
+struct MqttInflightStats {
+  uint32_t published;
+  uint32_t acked;
+  uint32_t retransmitted;
+  uint32_t rejected;
+};
+
+// Fixed pool of unacknowledged QoS 1 publishes. Each slot owns a copy of the
+// topic and payload so it can be resent after a reconnect; nothing here
+// allocates once the controller is constructed.
+class MqttInflightWindow {
+public:
+  static constexpr size_t kMaxSlots = DEVICECORE_MQTT_INFLIGHT_MAX;
+  static constexpr size_t kMaxPayload = DEVICECORE_MQTT_INFLIGHT_PAYLOAD;
+  static constexpr size_t kMaxTopic = 64;
+
+  struct Entry {
+    bool used;
+    uint16_t packetId;
+    uint32_t sequence;
+    uint16_t length;
+    char topic[kMaxTopic + 1];
+    uint8_t payload[kMaxPayload];
+  };
+
+  MqttInflightWindow();
+
+  void setWindow(size_t window);
+  size_t window() const { return _window; }
+  size_t size() const { return _count; }
+  bool full() const { return _count >= _window; }
+  static bool fits(const char* topic, size_t length);
+
+  Entry* acquire(const char* topic, const uint8_t* payload, size_t length);
+  bool release(uint16_t packetId);
+
+  // Visits pending entries oldest first; returns nullptr when done.
+  Entry* nextPending(uint32_t afterSequence);
+
+  void noteRetransmit() { ++_stats.retransmitted; }
+  void noteRejected() { ++_stats.rejected; }
+  const MqttInflightStats& stats() const { return _stats; }
+
+private:
+  Entry _slots[kMaxSlots];
+  size_t _window;
+  size_t _count;
+  uint16_t _nextPacketId;
+  uint32_t _nextSequence;
+  MqttInflightStats _stats;
+
+  bool packetIdInUse(uint16_t packetId) const;
+};
+
+}  // namespace DeviceCore
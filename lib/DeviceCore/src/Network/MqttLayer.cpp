@@ -1,21 +1,43 @@
 #include "MqttLayer.h"
+#include "../Core/Log.h"
 #include <cstring>
 
 namespace DeviceCore {
 
 namespace {
-constexpr unsigned long kMqttRetryIntervalMs = 2000UL;
+constexpr unsigned long kMqttRetryBaseMs = 2000UL;
+constexpr unsigned long kMqttRetryCapMs = 120000UL;
+constexpr unsigned long kMqttStableSessionMs = 60000UL;
+constexpr uint16_t kMqttSocketTimeoutS = 3;
+// Name lookup plus TCP handshake.
+constexpr unsigned long kMqttConnectTimeoutMs = 3000UL;
+constexpr size_t kStreamChunkSize = 256;
+// Fixed header (up to 5 bytes) plus the 2-byte topic length prefix.
+constexpr size_t kPublishHeaderOverhead = 7;
+constexpr uint8_t kPublishQos1Header = 0x32;
+constexpr uint8_t kPublishDupFlag = 0x08;
 }
 
-MqttLayer::MqttLayer(PubSubClient& client, const DeviceConfig& config)
+MqttLayer::MqttLayer(PubSubClient& client, AsyncTcpClient& socket, const DeviceConfig& config)
     : _client(client),
+      _socket(socket),
       _config(config),
       _lastHeartbeatMs(0),
-      _lastRetryMs(0) {}
+      _reconnect("MQTT", kMqttRetryBaseMs, kMqttRetryCapMs, kMqttStableSessionMs),
+      _wasConnected(false),
+      _connecting(false),
+      _connectStartMs(0) {}
 
 void MqttLayer::begin(MQTT_CALLBACK_SIGNATURE) {
   _client.setServer(_config.mqttServer, _config.mqttPort);
   _client.setCallback(callback);
+  _client.setSocketTimeout(kMqttSocketTimeoutS);
+  _socket.setTimeout(kMqttSocketTimeoutS * 1000UL);
+  _inflight.setWindow(_config.mqttInflightWindow);
+}
+
+void MqttLayer::attachTap(MqttTapClient& tap) {
+  tap.setAckHandler(&MqttLayer::onPuback, this);
 }
 
 bool MqttLayer::ensureConnected(unsigned long now) {
@@ -23,16 +45,44 @@ bool MqttLayer::ensureConnected(unsigned long now) {
     return true;
   }
 
-  if (now - _lastRetryMs < kMqttRetryIntervalMs) {
+  if (_wasConnected) {
+    _wasConnected = false;
+    _reconnect.onDisconnected(now);
+  }
+
+  if (_connecting) {
+    if (_socket.connecting() && now - _connectStartMs < kMqttConnectTimeoutMs) {
+      return false;
+    }
+    _connecting = false;
+    bool linked = _socket.connected();
+    if (linked && tryConnect()) {
+      _reconnect.onSuccess(millis());
+      _wasConnected = true;
+      _lastHeartbeatMs = now;
+      return true;
+    }
+    if (!linked) {
+      DC_LOG_WARN("MQTT", "Broker unreachable.");
+    }
+    _socket.stop();
+    _reconnect.onFailure(millis());
     return false;
   }
 
-  Serial.println("MQTT disconnected, retrying...");
-  _lastRetryMs = now;
-  if (tryConnect()) {
-    _lastHeartbeatMs = now;
-    return true;
+  if (!_reconnect.shouldAttempt(now)) {
+    return false;
   }
+
+  DC_LOG_INFO("MQTT", "Disconnected, retrying...");
+  _reconnect.onAttempt(now);
+  if (!_socket.open(_config.mqttServer, _config.mqttPort)) {
+    DC_LOG_WARN("MQTT", "Cannot open a connection to %s", _config.mqttServer ? _config.mqttServer : "");
+    _reconnect.onFailure(now);
+    return false;
+  }
+  _connecting = true;
+  _connectStartMs = now;
   return false;
 }
 
@@ -51,50 +101,196 @@ bool MqttLayer::handleHeartbeat(unsigned long now, bool heartbeatEnabled) {
     return false;
   }
 
-  String msg = "ESP heartbeat: ";
-  msg += now / 1000UL;
+  FixedString<32> msg;
+  msg.appendf("ESP heartbeat: %lu", now / 1000UL);
   if (_client.publish(_config.primaryTopic, msg.c_str())) {
-    Serial.print("Published: ");
-    Serial.println(msg);
+    DC_LOG_DEBUG("MQTT", "Published: %s", msg.c_str());
     _lastHeartbeatMs = now;
     return true;
   }
-  Serial.println("Heartbeat publish failed.");
+  DC_LOG_WARN("MQTT", "Heartbeat publish failed.");
   return false;
 }
 
-bool MqttLayer::publish(const char* topic, const String& payload) {
+unsigned long MqttLayer::msUntilHeartbeat(unsigned long now) const {
+  unsigned long elapsed = now - _lastHeartbeatMs;
+  return elapsed >= _config.heartbeatInterval ? 0 : _config.heartbeatInterval - elapsed;
+}
+
+bool MqttLayer::publish(const char* topic, const uint8_t* payload, size_t length, uint8_t qos) {
   if (!topic || topic[0] == '\0') {
     return false;
   }
-  return _client.publish(topic, payload.c_str());
+
+  if (qos > 0) {
+    if (MqttInflightWindow::fits(topic, length)) {
+      MqttInflightWindow::Entry* entry = _inflight.acquire(topic, payload, length);
+      if (!entry) {
+        _inflight.noteRejected();
+        return false;
+      }
+      // Once it is in the window the message is ours to deliver; a failed
+      // write is retried when the session is re-established.
+      if (_client.connected()) {
+        writeQos1(*entry, false);
+      }
+      return true;
+    }
+    DC_LOG_WARN("MQTT", "QoS 1 payload exceeds in-flight slot, sent at QoS 0.");
+  }
+
+  return streamPublish(topic, payload, length);
+}
+
+bool MqttLayer::streamPublish(const char* topic, const uint8_t* payload, size_t length) {
+  size_t topicLength = strlen(topic);
+  if (length + topicLength + kPublishHeaderOverhead <= _client.getBufferSize()) {
+    return _client.publish(topic, payload, length);
+  }
+
+  // Too large for PubSubClient's packet buffer: stream the payload straight
+  // from the caller's memory to the socket.
+  if (!_client.beginPublish(topic, length, false)) {
+    return false;
+  }
+  size_t offset = 0;
+  while (offset < length) {
+    size_t chunk = length - offset;
+    if (chunk > kStreamChunkSize) {
+      chunk = kStreamChunkSize;
+    }
+    size_t written = _client.write(payload + offset, chunk);
+    if (written == 0) {
+      break;
+    }
+    offset += written;
+  }
+  return _client.endPublish() == 1 && offset == length;
+}
+
+bool MqttLayer::writeQos1(const MqttInflightWindow::Entry& entry, bool duplicate) {
+  size_t topicLength = strlen(entry.topic);
+  uint32_t remaining = 2 + topicLength + 2 + entry.length;
+
+  uint8_t header[9];
+  size_t headerLength = 0;
+  header[headerLength++] = kPublishQos1Header | (duplicate ? kPublishDupFlag : 0);
+  do {
+    uint8_t digit = remaining & 0x7F;
+    remaining >>= 7;
+    header[headerLength++] = remaining ? (digit | 0x80) : digit;
+  } while (remaining);
+  header[headerLength++] = static_cast<uint8_t>(topicLength >> 8);
+  header[headerLength++] = static_cast<uint8_t>(topicLength & 0xFF);
+
+  uint8_t packetId[2] = {static_cast<uint8_t>(entry.packetId >> 8), static_cast<uint8_t>(entry.packetId & 0xFF)};
+
+  size_t written = _client.write(header, headerLength);
+  written += _client.write(reinterpret_cast<const uint8_t*>(entry.topic), topicLength);
+  written += _client.write(packetId, sizeof(packetId));
+  size_t offset = 0;
+  while (offset < entry.length) {
+    size_t chunk = entry.length - offset;
+    if (chunk > kStreamChunkSize) {
+      chunk = kStreamChunkSize;
+    }
+    size_t sent = _client.write(entry.payload + offset, chunk);
+    if (sent == 0) {
+      break;
+    }
+    offset += sent;
+  }
+  return written == headerLength + topicLength + sizeof(packetId) && offset == entry.length;
+}
+
+void MqttLayer::retransmitInflight() {
+  uint32_t sequence = 0;
+  size_t resent = 0;
+  while (MqttInflightWindow::Entry* entry = _inflight.nextPending(sequence)) {
+    sequence = entry->sequence;
+    if (!writeQos1(*entry, true)) {
+      break;
+    }
+    _inflight.noteRetransmit();
+    ++resent;
+  }
+  if (resent > 0) {
+    DC_LOG_INFO("MQTT", "Retransmitted unacknowledged publishes: %lu", static_cast<unsigned long>(resent));
+  }
+}
+
+void MqttLayer::onPuback(void* context, uint16_t packetId) {
+  static_cast<MqttLayer*>(context)->_inflight.release(packetId);
 }
 
 bool MqttLayer::isConnected() const {
   return _client.connected();
 }
 
+void MqttLayer::resubscribe(const char* oldPrimaryTopic, const char* oldSerialTopic) {
+  if (!_client.connected()) {
+    return;  // tryConnect() subscribes to the new topics.
+  }
+
+  const char* oldTopics[] = {oldPrimaryTopic, oldSerialTopic};
+  const char* newTopics[] = {_config.primaryTopic, _config.serialTopic};
+  for (const char* oldTopic : oldTopics) {
+    if (!oldTopic || oldTopic[0] == '\0') {
+      continue;
+    }
+    bool kept = false;
+    for (const char* newTopic : newTopics) {
+      kept = kept || (newTopic && std::strcmp(oldTopic, newTopic) == 0);
+    }
+    if (!kept) {
+      _client.unsubscribe(oldTopic);
+    }
+  }
+  for (const char* newTopic : newTopics) {
+    if (!newTopic || newTopic[0] == '\0') {
+      continue;
+    }
+    bool existed = false;
+    for (const char* oldTopic : oldTopics) {
+      existed = existed || (oldTopic && std::strcmp(oldTopic, newTopic) == 0);
+    }
+    if (!existed) {
+      _client.subscribe(newTopic);
+      DC_LOG_INFO("MQTT", "Subscribed to topic: %s", newTopic);
+    }
+  }
+}
+
 bool MqttLayer::tryConnect() {
-  Serial.print("Attempting MQTT connection...");
   const char* clientId = (_config.clientId && _config.clientId[0] != '\0') ? _config.clientId : "esp_client";
-  if (_client.connect(clientId)) {
-    Serial.println("connected");
+  // QoS 1 needs a persistent session so the broker keeps our packet ids
+  // across reconnects.
+  bool cleanSession = _config.mqttQos == 0;
+  // The socket is already open, so PubSubClient skips its own connect.
+  if (_client.connect(clientId, nullptr, nullptr, nullptr, 0, false, nullptr, cleanSession)) {
+    DC_LOG_INFO("MQTT", "Connected as %s", clientId);
     if (_config.primaryTopic && _config.primaryTopic[0] != '\0') {
       _client.subscribe(_config.primaryTopic);
-      Serial.print("Subscribed to topic: ");
-      Serial.println(_config.primaryTopic);
+      DC_LOG_INFO("MQTT", "Subscribed to topic: %s", _config.primaryTopic);
       _client.publish(_config.primaryTopic, "Hello from ESP32!");
-      Serial.println("MQTT: Published 'Hello from ESP32!'");
+      DC_LOG_DEBUG("MQTT", "Published 'Hello from ESP32!'");
     }
     if (_config.serialTopic && _config.serialTopic[0] != '\0' && (!_config.primaryTopic || std::strcmp(_config.serialTopic, _config.primaryTopic) != 0)) {
       _client.subscribe(_config.serialTopic);
-      Serial.print("Subscribed to serial topic: ");
-      Serial.println(_config.serialTopic);
+      DC_LOG_INFO("MQTT", "Subscribed to serial topic: %s", _config.serialTopic);
+    }
+    if (_config.modbusRequestTopic && _config.modbusRequestTopic[0] != '\0') {
+      _client.subscribe(_config.modbusRequestTopic);
+      DC_LOG_INFO("MQTT", "Subscribed to Modbus request topic: %s", _config.modbusRequestTopic);
+    }
+    if (_config.configTopic && _config.configTopic[0] != '\0') {
+      _client.subscribe(_config.configTopic);
+      DC_LOG_INFO("MQTT", "Subscribed to config topic: %s", _config.configTopic);
     }
+    retransmitInflight();
     return true;
   }
-  Serial.print("failed, rc=");
-  Serial.println(_client.state());
+  DC_LOG_WARN("MQTT", "Connection failed, rc=%d", _client.state());
   return false;
 }
 
@@ -3,27 +3,60 @@
 #include <Arduino.h>
 #include <PubSubClient.h>
 #include "../Config/DeviceConfig.h"
+#include "../Core/FixedString.h"
+#include "AsyncTcpClient.h"
+#include "MqttInflightWindow.h"
+#include "MqttTapClient.h"
+#include "ReconnectPolicy.h"
 
 namespace DeviceCore {
 
+// The broker's name is resolved and its TCP connection opened on the
+// socket in the background; ensureConnected() hands the established socket
+// to PubSubClient, whose CONNECT/CONNACK exchange is the only step that
+// still waits, for one round trip capped by the socket timeout.
 class MqttLayer {
 public:
-  MqttLayer(PubSubClient& client, const DeviceConfig& config);
+  MqttLayer(PubSubClient& client, AsyncTcpClient& socket, const DeviceConfig& config);
 
   void begin(MQTT_CALLBACK_SIGNATURE);
+  void attachTap(MqttTapClient& tap);
   bool ensureConnected(unsigned long now);
   void loop();
   bool handleHeartbeat(unsigned long now, bool heartbeatEnabled);
-  bool publish(const char* topic, const String& payload);
+  unsigned long msUntilHeartbeat(unsigned long now) const;
+  bool publish(const char* topic, const uint8_t* payload, size_t length, uint8_t qos = 0);
+  template <size_t N>
+  bool publish(const char* topic, const FixedString<N>& payload, uint8_t qos = 0) {
+    return publish(topic, payload.bytes(), payload.length(), qos);
+  }
   bool isConnected() const;
+  // True while the broker's TCP connection is being opened.
+  bool connecting() const { return _connecting; }
+  // Moves subscriptions from the old topics to the ones now in DeviceConfig
+  // on the live session.
+  void resubscribe(const char* oldPrimaryTopic, const char* oldSerialTopic);
+  bool inflightFull() const { return _inflight.full(); }
+  const MqttInflightStats& inflightStats() const { return _inflight.stats(); }
+  const ReconnectStats& reconnectStats() const { return _reconnect.stats(); }
 
 private:
   PubSubClient& _client;
+  AsyncTcpClient& _socket;
   const DeviceConfig& _config;
   unsigned long _lastHeartbeatMs;
-  unsigned long _lastRetryMs;
+  ReconnectPolicy _reconnect;
+  bool _wasConnected;
+  bool _connecting;
+  unsigned long _connectStartMs;
+  MqttInflightWindow _inflight;
+
+  static void onPuback(void* context, uint16_t packetId);
 
   bool tryConnect();
+  bool streamPublish(const char* topic, const uint8_t* payload, size_t length);
+  bool writeQos1(const MqttInflightWindow::Entry& entry, bool duplicate);
+  void retransmitInflight();
 };
 
 }  // namespace DeviceCore
@@ -0,0 +1,134 @@
+#include "MqttTapClient.h"
+
+namespace DeviceCore {
+
+namespace {
+constexpr uint8_t kPacketTypePuback = 4;
+}
+
+MqttTapClient::MqttTapClient(Client& inner)
+    : _inner(inner),
+      _ackHandler(nullptr),
+      _ackContext(nullptr) {
+  resetParser();
+}
+
+void MqttTapClient::setAckHandler(AckHandler handler, void* context) {
+  _ackHandler = handler;
+  _ackContext = context;
+}
+
+int MqttTapClient::connect(IPAddress ip, uint16_t port) {
+  resetParser();
+  return _inner.connect(ip, port);
+}
+
+int MqttTapClient::connect(const char* host, uint16_t port) {
+  resetParser();
+  return _inner.connect(host, port);
+}
+
+size_t MqttTapClient::write(uint8_t value) {
+  return _inner.write(value);
+}
+
+size_t MqttTapClient::write(const uint8_t* buffer, size_t size) {
+  return _inner.write(buffer, size);
+}
+
+int MqttTapClient::available() {
+  return _inner.available();
+}
+
+int MqttTapClient::read() {
+  int value = _inner.read();
+  if (value >= 0) {
+    observe(static_cast<uint8_t>(value));
+  }
+  return value;
+}
+
+int MqttTapClient::read(uint8_t* buffer, size_t size) {
+  int count = _inner.read(buffer, size);
+  for (int i = 0; i < count; ++i) {
+    observe(buffer[i]);
+  }
+  return count;
+}
+
+int MqttTapClient::peek() {
+  return _inner.peek();
+}
+
+void MqttTapClient::flush() {
+  _inner.flush();
+}
+
+void MqttTapClient::stop() {
+  _inner.stop();
+  resetParser();
+}
+
+uint8_t MqttTapClient::connected() {
+  return _inner.connected();
+}
+
+MqttTapClient::operator bool() {
+  return static_cast<bool>(_inner);
+}
+
+void MqttTapClient::resetParser() {
+  _state = ParseState::Header;
+  _packetType = 0;
+  _remaining = 0;
+  _lengthShift = 0;
+  _packetId = 0;
+  _bodyIndex = 0;
+}
+
+void MqttTapClient::observe(uint8_t value) {
+  switch (_state) {
+    case ParseState::Header:
+      _packetType = value >> 4;
+      _remaining = 0;
+      _lengthShift = 0;
+      _packetId = 0;
+      _bodyIndex = 0;
+      _state = ParseState::Length;
+      break;
+
+    case ParseState::Length:
+      _remaining |= static_cast<uint32_t>(value & 0x7F) << _lengthShift;
+      _lengthShift += 7;
+      if ((value & 0x80) == 0) {
+        if (_remaining == 0) {
+          finishPacket();
+        } else {
+          _state = ParseState::Body;
+        }
+      } else if (_lengthShift > 21) {
+        // Malformed length; resynchronise on the next packet.
+        resetParser();
+      }
+      break;
+
+    case ParseState::Body:
+      if (_bodyIndex < 2) {
+        _packetId = static_cast<uint16_t>((_packetId << 8) | value);
+        ++_bodyIndex;
+      }
+      if (--_remaining == 0) {
+        finishPacket();
+      }
+      break;
+  }
+}
+
+void MqttTapClient::finishPacket() {
+  if (_packetType == kPacketTypePuback && _bodyIndex >= 2 && _ackHandler) {
+    _ackHandler(_ackContext, _packetId);
+  }
+  _state = ParseState::Header;
+}
+
+}  // namespace DeviceCore
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Client.h>
+
+namespace DeviceCore {
+
+// Transparent Client wrapper placed between PubSubClient and the socket.
+// PubSubClient silently discards PUBACK packets, so the tap follows the
+// inbound MQTT framing byte by byte and reports acknowledged packet ids.
+class MqttTapClient : public Client {
+public:
+  typedef void (*AckHandler)(void* context, uint16_t packetId);
+
+  explicit MqttTapClient(Client& inner);
+
+  void setAckHandler(AckHandler handler, void* context);
+
+  int connect(IPAddress ip, uint16_t port) override;
+  int connect(const char* host, uint16_t port) override;
+  size_t write(uint8_t value) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  int available() override;
+  int read() override;
+  int read(uint8_t* buffer, size_t size) override;
+  int peek() override;
+  void flush() override;
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override;
+
+private:
+  enum class ParseState : uint8_t {
+    Header,
+    Length,
+    Body,
+  };
+
+  Client& _inner;
+  AckHandler _ackHandler;
+  void* _ackContext;
+  ParseState _state;
+  uint8_t _packetType;
+  uint32_t _remaining;
+  uint8_t _lengthShift;
+  uint16_t _packetId;
+  uint8_t _bodyIndex;
+
+  void resetParser();
+  void observe(uint8_t value);
+  void finishPacket();
+};
+
+}  // namespace DeviceCore
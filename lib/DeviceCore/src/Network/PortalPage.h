@@ -0,0 +1,197 @@
+#pragma once
+
+// Generated by tools/embed_portal.py from web/portal.html; do not edit.
+
+#include <Arduino.h>
+
+namespace DeviceCore {
+
+constexpr size_t kPortalPageGzLength = 2927;
+constexpr char kPortalPageEtag[] = "\"b02c192f\"";
+const uint8_t kPortalPageGz[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x5a, 0x7d, 0x93, 0x14, 0xc5,
+    0x19, 0xff, 0x9f, 0x4f, 0xd1, 0x8e, 0x95, 0x9a, 0x5d, 0xdd, 0x9d, 0xdd, 0x5b, 0x8e, 0x13, 0xf7,
+    0x76, 0x37, 0x85, 0x20, 0x81, 0x2a, 0x51, 0xca, 0xc3, 0x4a, 0xa5, 0x52, 0x29, 0xaa, 0x77, 0xa6,
+    0xf7, 0xa6, 0xb9, 0xd9, 0x99, 0xc9, 0x4c, 0xef, 0xbd, 0xa0, 0x54, 0xa1, 0x11, 0xdf, 0x10, 0x41,
+    0x43, 0xca, 0x68, 0x41, 0xd0, 0x28, 0xd1, 0x8a, 0x85, 0x87, 0xf1, 0x5d, 0x40, 0xbe, 0x4b, 0xc2,
+    0xee, 0x1e, 0x7f, 0x99, 0x8f, 0x90, 0xa7, 0xbb, 0xe7, 0xa5, 0x67, 0x76, 0x66, 0x01, 0x23, 0x57,
+    0x05, 0x33, 0xdd, 0xcf, 0x7b, 0x3f, 0xcf, 0xef, 0x79, 0x7a, 0x8e, 0xce, 0x43, 0x07, 0x9e, 0xd9,
+    0x7f, 0xec, 0x77, 0x47, 0x9f, 0x44, 0x36, 0x1b, 0x3a, 0xbd, 0x5d, 0x1d, 0xfe, 0x0f, 0x72, 0xb0,
+    0xbb, 0xda, 0xd5, 0x4e, 0xda, 0xf5, 0xfd, 0x4f, 0x6b, 0x7c, 0x8d, 0x60, 0xab, 0xb7, 0x0b, 0xa1,
+    0xce, 0x90, 0x30, 0x8c, 0x4c, 0x1b, 0x07, 0x21, 0x61, 0x5d, 0xed, 0xb9, 0x63, 0x07, 0xeb, 0x7b,
+    0xb5, 0x74, 0xc3, 0xc5, 0x43, 0xd2, 0xd5, 0xd6, 0x29, 0xd9, 0xf0, 0xbd, 0x80, 0x69, 0xc8, 0xf4,
+    0x5c, 0x46, 0x5c, 0x20, 0xdc, 0xa0, 0x16, 0xb3, 0xbb, 0x16, 0x59, 0xa7, 0x26, 0xa9, 0x8b, 0x97,
+    0x1a, 0xa2, 0x2e, 0x65, 0x14, 0x3b, 0xf5, 0xd0, 0xc4, 0x0e, 0xe9, 0x2e, 0x48, 0x31, 0x8c, 0x32,
+    0x87, 0xf4, 0x76, 0x3e, 0xff, 0x71, 0xfc, 0xf1, 0xab, 0xd3, 0x5b, 0x6f, 0x4f, 0x6f, 0x5c, 0xba,
+    0x7b, 0xe6, 0xdc, 0xf4, 0xd6, 0xe7, 0x9d, 0x86, 0xdc, 0xe1, 0x34, 0x21, 0xdb, 0x92, 0x4f, 0x08,
+    0xb5, 0x03, 0xcf, 0x63, 0xe8, 0x79, 0xf1, 0x8c, 0x50, 0xbd, 0xde, 0x5f, 0xad, 0x9b, 0x9e, 0xe3,
+    0x05, 0x6d, 0xf4, 0xf0, 0xa0, 0x39, 0x68, 0x0d, 0xf6, 0x2c, 0x27, 0x5b, 0x26, 0x0e, 0x2c, 0xd8,
+    0xe7, 0x3b, 0xe2, 0x4f, 0xba, 0xe3, 0x07, 0x74, 0x88, 0x83, 0xad, 0x84, 0xb3, 0xd9, 0xdc, 0xb3,
+    0xd4, 0xdf, 0xbd, 0x8c, 0x1a, 0x8f, 0xa0, 0xc3, 0xae, 0x35, 0x0a, 0x59, 0x00, 0x66, 0xa2, 0x27,
+    0x9c, 0x11, 0x41, 0x8f, 0x34, 0x12, 0x2e, 0x46, 0x36, 0x59, 0xcc, 0x0a, 0x4c, 0xbb, 0xc5, 0x9f,
+    0xe5, 0xec, 0x76, 0x48, 0x20, 0x02, 0x96, 0x24, 0x58, 0x12, 0x7f, 0x52, 0x82, 0xbe, 0x17, 0x58,
+    0x24, 0x48, 0x94, 0x5a, 0x26, 0xff, 0x49, 0xb7, 0xa9, 0xeb, 0x8f, 0x58, 0x64, 0xef, 0xe3, 0xfc,
+    0x27, 0xde, 0x1a, 0x40, 0x4c, 0xeb, 0x03, 0x3c, 0xa4, 0x0e, 0x48, 0xad, 0x63, 0xdf, 0x77, 0x48,
+    0x3d, 0xdc, 0x0a, 0x19, 0x19, 0xd6, 0xc0, 0x46, 0xea, 0xae, 0x1d, 0xc1, 0xe6, 0x8a, 0x78, 0x3f,
+    0x08, 0x94, 0x35, 0xa4, 0xad, 0x90, 0x55, 0x8f, 0xa0, 0xe7, 0x0e, 0x6b, 0x35, 0xf4, 0xac, 0xd7,
+    0xf7, 0x98, 0x57, 0x43, 0x87, 0x88, 0xb3, 0x4e, 0x18, 0x35, 0x71, 0x0d, 0xed, 0xe3, 0xce, 0xd5,
+    0x50, 0x88, 0xdd, 0x10, 0xcc, 0x0d, 0x68, 0x14, 0x97, 0x53, 0xe2, 0xef, 0xbe, 0x67, 0x6d, 0x25,
+    0xd1, 0xed, 0x63, 0x73, 0x6d, 0x35, 0xf0, 0x46, 0xae, 0x15, 0x1b, 0xbd, 0x8e, 0x83, 0x4a, 0x1a,
+    0xf3, 0x6a, 0x6c, 0x61, 0x66, 0x57, 0x0d, 0x53, 0x42, 0x61, 0xd1, 0xd0, 0x77, 0x30, 0xd8, 0x3f,
+    0x70, 0xc8, 0x66, 0xbc, 0x78, 0x02, 0x22, 0x4d, 0x07, 0xfc, 0x18, 0x44, 0xd2, 0xb4, 0x91, 0x09,
+    0x7f, 0x93, 0x20, 0xde, 0xc6, 0x0e, 0x5d, 0x75, 0xeb, 0x14, 0xfc, 0x0a, 0xf3, 0x5b, 0x43, 0xea,
+    0xd6, 0x6d, 0x42, 0x57, 0x6d, 0x60, 0x5a, 0x68, 0x36, 0xd7, 0xed, 0x64, 0x03, 0x07, 0xab, 0xd4,
+    0x6d, 0xa3, 0x66, 0xbc, 0xe0, 0x63, 0xcb, 0xa2, 0x2e, 0x04, 0xb5, 0xd5, 0xf4, 0x37, 0x55, 0x4f,
+    0x0d, 0xae, 0x15, 0x53, 0x97, 0x04, 0x05, 0xfe, 0xc6, 0xbe, 0x44, 0x29, 0x94, 0xb8, 0x21, 0x12,
+    0x59, 0xa8, 0xfc, 0x55, 0xaa, 0x71, 0xb3, 0x1e, 0x2d, 0x2f, 0x36, 0x13, 0x1d, 0x8a, 0xe2, 0xdd,
+    0xca, 0x62, 0x94, 0x02, 0x01, 0xb6, 0xe8, 0x08, 0x9c, 0xda, 0xab, 0xee, 0x6c, 0xd6, 0x43, 0x1b,
+    0x5b, 0xde, 0x06, 0x18, 0x8f, 0x16, 0xfd, 0x4d, 0xb4, 0xd0, 0x82, 0xbf, 0x82, 0xd5, 0x3e, 0xae,
+    0x34, 0x6b, 0xe2, 0xc7, 0x58, 0xa8, 0xe6, 0xe4, 0x30, 0xcf, 0x6f, 0x0b, 0xda, 0xd0, 0x73, 0xa8,
+    0x15, 0xd9, 0x9c, 0x49, 0xee, 0xaa, 0xea, 0xb2, 0xbd, 0x90, 0xb8, 0x2a, 0x72, 0x2a, 0xa4, 0x27,
+    0x89, 0x1a, 0x98, 0x38, 0x7c, 0x52, 0x6e, 0x33, 0xb7, 0x08, 0x89, 0xc4, 0xbc, 0x61, 0x96, 0x3e,
+    0x73, 0xf0, 0x45, 0x8a, 0x11, 0x12, 0xe9, 0xc0, 0x02, 0xc8, 0xb6, 0x81, 0x17, 0x00, 0xfb, 0xc8,
+    0xf7, 0x49, 0x60, 0xe2, 0x90, 0xc4, 0x04, 0x0e, 0x61, 0x70, 0xb2, 0xf5, 0xd0, 0xc7, 0xa6, 0x88,
+    0x57, 0xd3, 0xd8, 0x33, 0x13, 0xb0, 0x58, 0xf7, 0x42, 0xce, 0x57, 0xb5, 0xa4, 0xaa, 0xb9, 0xc8,
+    0xa7, 0x4c, 0xf9, 0x93, 0xa7, 0xee, 0xc0, 0xab, 0xf3, 0x83, 0xf6, 0x93, 0x78, 0xcc, 0xf1, 0x31,
+    0x39, 0xc8, 0x05, 0xd5, 0xae, 0x99, 0xd2, 0x78, 0x98, 0x90, 0xc1, 0xd2, 0xc0, 0x2c, 0x39, 0xe9,
+    0xc5, 0x94, 0x55, 0x09, 0xfd, 0xc2, 0x62, 0x91, 0x65, 0x3c, 0xe3, 0xcb, 0x0c, 0x53, 0x32, 0xe6,
+    0xfe, 0x4a, 0x8a, 0x87, 0x95, 0xd4, 0xfb, 0x84, 0x6d, 0x10, 0xe2, 0x16, 0xeb, 0x6a, 0x3b, 0x38,
+    0x64, 0x75, 0xd3, 0xa6, 0x8e, 0x55, 0xa6, 0xb6, 0x39, 0xcb, 0xe9, 0xe0, 0x3e, 0x71, 0xb2, 0xf9,
+    0xb4, 0x11, 0x55, 0xe4, 0x52, 0xb3, 0x59, 0x8e, 0x0c, 0x09, 0x42, 0x56, 0x67, 0x65, 0xae, 0x63,
+    0x0e, 0xb9, 0x85, 0x32, 0xf7, 0x34, 0x33, 0x36, 0xf0, 0x5c, 0x4a, 0x08, 0x0b, 0x23, 0xc1, 0x9f,
+    0xeb, 0x16, 0x0d, 0x88, 0xc9, 0xa8, 0x07, 0x88, 0x00, 0x96, 0x8c, 0x86, 0x6e, 0xbc, 0xbb, 0x8a,
+    0x7d, 0xf5, 0x40, 0xa5, 0xd0, 0x02, 0x97, 0xf2, 0xe7, 0x54, 0xee, 0x69, 0x2e, 0x62, 0x8b, 0x05,
+    0x07, 0xd5, 0x77, 0x3c, 0x73, 0x4d, 0x55, 0x28, 0x20, 0x3f, 0x51, 0x58, 0x00, 0x2e, 0x69, 0xee,
+    0xcd, 0x80, 0xc8, 0x7d, 0x16, 0x43, 0x79, 0x1e, 0x96, 0xa1, 0x7b, 0xdc, 0x87, 0xaa, 0x45, 0x09,
+    0xbb, 0x94, 0x43, 0x2c, 0x7a, 0x52, 0x98, 0x97, 0x94, 0xe9, 0xe6, 0x8c, 0x7b, 0xed, 0x81, 0x67,
+    0x8e, 0xc2, 0x14, 0x63, 0x33, 0x4d, 0x70, 0x1e, 0x70, 0x78, 0x23, 0x06, 0xcd, 0x0d, 0x94, 0xba,
+    0x9e, 0x4b, 0x32, 0x3d, 0x6a, 0x04, 0x21, 0x76, 0xef, 0xd9, 0xa5, 0x8a, 0xa5, 0x46, 0x24, 0x1b,
+    0x36, 0x64, 0x7e, 0x3e, 0xa0, 0xa9, 0x22, 0x35, 0xf2, 0xad, 0x52, 0xf8, 0x2e, 0x29, 0xea, 0xa5,
+    0x7b, 0x27, 0x8b, 0x39, 0x0a, 0x42, 0x6e, 0x86, 0xef, 0x51, 0xb5, 0xad, 0x09, 0x98, 0xa4, 0x32,
+    0x5f, 0xf3, 0x6e, 0x01, 0x2e, 0xb6, 0xc2, 0xd9, 0x30, 0xb4, 0x6d, 0x6f, 0xbd, 0xb0, 0x85, 0x29,
+    0xc3, 0xcd, 0xe2, 0xe2, 0xe3, 0x8b, 0x99, 0x62, 0x1b, 0xc0, 0x0c, 0xa5, 0x30, 0xa9, 0xa8, 0xdf,
+    0xda, 0x53, 0xec, 0x54, 0xab, 0x04, 0xf4, 0x0b, 0x6b, 0x3a, 0x42, 0x7d, 0xd1, 0xc0, 0xf3, 0xad,
+    0x5b, 0x6d, 0x5d, 0x0f, 0x04, 0xe7, 0x92, 0x23, 0x57, 0xb2, 0x46, 0xc8, 0x30, 0x53, 0xd2, 0xab,
+    0xa4, 0x68, 0x33, 0xf3, 0x02, 0x19, 0x16, 0x48, 0x30, 0xbc, 0xb5, 0x44, 0x48, 0x1c, 0xb9, 0x05,
+    0xf2, 0x18, 0xd9, 0xbd, 0x58, 0x44, 0x4c, 0x82, 0xc0, 0x0b, 0x66, 0xe8, 0xcd, 0xbd, 0xad, 0x64,
+    0x22, 0x8c, 0xe8, 0x5d, 0x00, 0x5e, 0x2f, 0x58, 0x4b, 0x0d, 0x74, 0x28, 0x60, 0xad, 0x98, 0x67,
+    0xb3, 0xf9, 0x56, 0x3e, 0xb8, 0x34, 0x7f, 0xe1, 0xba, 0xe7, 0x03, 0x4b, 0x12, 0x8b, 0xbd, 0x0a,
+    0xae, 0xf0, 0x44, 0x1a, 0x38, 0xde, 0x46, 0x1d, 0xa0, 0x0a, 0x8f, 0x98, 0x57, 0xec, 0x88, 0x43,
+    0xe7, 0xe3, 0xee, 0xfd, 0x74, 0xa0, 0x12, 0x60, 0x2b, 0x39, 0xbc, 0x92, 0x62, 0x79, 0xf0, 0xd1,
+    0x60, 0xd6, 0x95, 0xa2, 0xd6, 0x97, 0x93, 0x9b, 0x47, 0x1f, 0x95, 0xdd, 0x08, 0x89, 0x03, 0xfd,
+    0x85, 0x58, 0xf3, 0xea, 0x2f, 0x3b, 0x17, 0xdc, 0x13, 0xa2, 0xf2, 0x5a, 0x8c, 0x10, 0x8a, 0x08,
+    0x3b, 0xf9, 0x64, 0xbb, 0x67, 0x47, 0xc5, 0xc5, 0x1c, 0x73, 0x86, 0x34, 0x0b, 0xe4, 0x04, 0x58,
+    0xa2, 0x4f, 0xde, 0x6b, 0x9c, 0xc3, 0x99, 0x19, 0x06, 0xf0, 0x98, 0x04, 0x1c, 0xaf, 0x53, 0xae,
+    0x4e, 0x23, 0xba, 0xb7, 0x75, 0x1a, 0xf2, 0x36, 0xd9, 0xe1, 0xb7, 0x0b, 0x71, 0xa1, 0xb3, 0xe8,
+    0x3a, 0x32, 0x21, 0xf6, 0x61, 0x57, 0x4b, 0xc6, 0x70, 0x4d, 0x5e, 0xf0, 0x3a, 0xf6, 0x42, 0xe1,
+    0x6d, 0x10, 0x96, 0x77, 0x49, 0x02, 0x85, 0x39, 0x9d, 0xe4, 0x22, 0xee, 0x82, 0x6d, 0x3e, 0xe2,
+    0x24, 0xbb, 0xfc, 0x32, 0xe9, 0x63, 0x37, 0x43, 0x20, 0xda, 0xbe, 0xd6, 0x9b, 0xde, 0xf8, 0xea,
+    0xce, 0xed, 0xcb, 0xd3, 0x8b, 0x5f, 0xef, 0x6c, 0x5f, 0x6e, 0x83, 0xed, 0x40, 0x36, 0x8f, 0x4b,
+    0xcc, 0x2a, 0x5a, 0x4f, 0x6e, 0x50, 0xab, 0xab, 0xf9, 0x36, 0xc4, 0x4c, 0xeb, 0x4d, 0xde, 0x7f,
+    0x69, 0xf2, 0xee, 0x07, 0x11, 0x7f, 0x56, 0x4c, 0xa7, 0x01, 0xb6, 0xfd, 0xdf, 0x76, 0xde, 0xb9,
+    0x75, 0x7b, 0x7a, 0xf1, 0xd3, 0xc9, 0xeb, 0x67, 0xc7, 0xaf, 0xbc, 0xf9, 0x00, 0x76, 0x62, 0x61,
+    0xe4, 0x10, 0xbb, 0x23, 0xec, 0x68, 0xc8, 0x0e, 0xc8, 0xa0, 0xab, 0xd9, 0x8c, 0xf9, 0xed, 0x46,
+    0x63, 0x63, 0x63, 0xc3, 0x08, 0xe0, 0x84, 0x86, 0x04, 0x2e, 0x45, 0x43, 0x0d, 0x31, 0xc0, 0x22,
+    0x7e, 0xd9, 0x3f, 0xde, 0x77, 0xb0, 0xbb, 0x06, 0x91, 0x79, 0xe9, 0xfb, 0xf1, 0xab, 0x37, 0x26,
+    0x57, 0xae, 0x4e, 0x2f, 0x9d, 0xed, 0x34, 0x70, 0xb9, 0x57, 0xd1, 0xa3, 0x7c, 0x16, 0x23, 0xda,
+    0x90, 0x30, 0xdb, 0x03, 0xbd, 0x47, 0x9f, 0x59, 0x39, 0xa6, 0x21, 0x2c, 0x66, 0xb1, 0xae, 0xd6,
+    0x08, 0x47, 0xfd, 0x21, 0x65, 0x9a, 0x30, 0x89, 0xd3, 0x65, 0x4e, 0x4f, 0xf1, 0x46, 0xb8, 0xdc,
+    0xbb, 0xfb, 0xde, 0xcb, 0x3b, 0xb7, 0xdf, 0x9e, 0xbe, 0xff, 0x32, 0xfa, 0x2d, 0xad, 0x1f, 0xa4,
+    0x9d, 0x86, 0x5c, 0x4e, 0xc9, 0x46, 0x4e, 0xec, 0x72, 0x5c, 0x36, 0x52, 0x74, 0xf2, 0xd6, 0xeb,
+    0x38, 0xb4, 0x37, 0xb9, 0xf6, 0xd1, 0xf8, 0x12, 0x04, 0xee, 0xb3, 0xc9, 0xf9, 0xf3, 0xff, 0x3e,
+    0xfd, 0x0f, 0x10, 0x43, 0xc1, 0x95, 0x91, 0x53, 0x7a, 0x3c, 0x79, 0x43, 0xf8, 0xd4, 0xd9, 0xd5,
+    0xc2, 0x90, 0x5a, 0x5a, 0x4f, 0x58, 0x82, 0xc6, 0x17, 0xce, 0x4d, 0x3f, 0xb9, 0x8e, 0x2a, 0x2b,
+    0x2b, 0x87, 0x0f, 0x54, 0x67, 0xed, 0x92, 0xf3, 0x1d, 0xdb, 0xf2, 0x49, 0x57, 0xe3, 0x15, 0x23,
+    0xad, 0x12, 0x02, 0xa2, 0x2f, 0x27, 0xf2, 0x39, 0x20, 0x7f, 0x1c, 0xc1, 0xa4, 0x6a, 0x21, 0x80,
+    0x53, 0x93, 0xd8, 0x9e, 0x03, 0xb5, 0xd4, 0xd5, 0x76, 0x7e, 0xfc, 0xf3, 0xf8, 0xcc, 0x55, 0xa4,
+    0x6a, 0xd2, 0x1e, 0xd0, 0x56, 0x1f, 0x82, 0x02, 0x11, 0x48, 0xed, 0xdd, 0x7e, 0x65, 0xfa, 0xc1,
+    0x8b, 0xf3, 0x0d, 0x4d, 0x78, 0x64, 0x56, 0x27, 0x6f, 0xd2, 0xe0, 0xf4, 0x7d, 0x8e, 0xad, 0x42,
+    0x4b, 0x89, 0xad, 0xd1, 0xf4, 0x26, 0x75, 0xa9, 0x79, 0x10, 0x3d, 0xf7, 0x26, 0x5f, 0x9f, 0xdd,
+    0xd9, 0xfe, 0xcb, 0xf8, 0xfb, 0x6f, 0xa0, 0x1a, 0xc7, 0xd7, 0xfe, 0xda, 0x69, 0x48, 0x8e, 0xa2,
+    0xba, 0x91, 0xdd, 0x38, 0x62, 0x97, 0xcf, 0xbd, 0x4c, 0x3a, 0xf2, 0xdc, 0x2a, 0x80, 0x0d, 0x39,
+    0xff, 0xa4, 0x06, 0xfa, 0xbd, 0x9d, 0xed, 0x6f, 0xa7, 0x1f, 0x7e, 0x0e, 0x1a, 0xa5, 0x23, 0x90,
+    0x2a, 0xf0, 0xca, 0x33, 0xae, 0x65, 0x2c, 0xfe, 0xe6, 0xd0, 0x49, 0x24, 0xb1, 0xe8, 0xce, 0xed,
+    0x0f, 0x27, 0x2f, 0x6e, 0xff, 0xe7, 0xf4, 0x4b, 0x9d, 0x86, 0xaf, 0x32, 0x0b, 0xb8, 0x42, 0x87,
+    0x0f, 0xb4, 0x51, 0x0a, 0x07, 0xd0, 0x54, 0x7c, 0xad, 0x97, 0xe0, 0x80, 0x9f, 0xa9, 0x10, 0xf5,
+    0x21, 0x34, 0x03, 0xea, 0x33, 0xb9, 0x3d, 0x20, 0xcc, 0xb4, 0x2b, 0x7a, 0x83, 0x57, 0xae, 0x71,
+    0x22, 0xf4, 0x5c, 0xbd, 0x6a, 0x30, 0x9b, 0xb8, 0x95, 0xc1, 0xc8, 0x15, 0xb5, 0x83, 0x2a, 0x41,
+    0x15, 0x3d, 0x0f, 0x09, 0xc3, 0x46, 0x81, 0x8b, 0x02, 0x41, 0x53, 0xa9, 0x2e, 0xa3, 0x53, 0x33,
+    0x74, 0x5c, 0x44, 0x35, 0xc1, 0x6b, 0x3a, 0x90, 0x2b, 0x86, 0x40, 0x29, 0x2e, 0xc2, 0x82, 0xb1,
+    0x7c, 0x08, 0x0d, 0xda, 0x80, 0x52, 0x7f, 0xd2, 0x21, 0xfc, 0xf1, 0x89, 0xad, 0xc3, 0x56, 0x45,
+    0x17, 0x14, 0x5c, 0x2f, 0x24, 0xec, 0x7e, 0xd9, 0xc4, 0x51, 0x17, 0xa5, 0xcc, 0xcb, 0x51, 0x4b,
+    0x50, 0x84, 0x4a, 0x54, 0x99, 0x2b, 0x55, 0x92, 0x80, 0x58, 0x8e, 0x3c, 0xb1, 0x3c, 0xb9, 0x98,
+    0x0a, 0x2c, 0xe5, 0xe6, 0xc1, 0x2c, 0x36, 0x89, 0xef, 0x1c, 0xb6, 0xd0, 0x0b, 0x2f, 0x20, 0x5d,
+    0x8f, 0x5a, 0x4f, 0xd5, 0x30, 0x31, 0x0f, 0x63, 0x1a, 0x0b, 0xb0, 0xec, 0x14, 0xf4, 0x3a, 0x19,
+    0xe2, 0x78, 0x55, 0xf6, 0xd5, 0x4a, 0x00, 0x25, 0x98, 0xc6, 0x29, 0x0e, 0x2c, 0x2c, 0xa2, 0x5e,
+    0x17, 0xd5, 0x97, 0x9a, 0xe8, 0xd7, 0x48, 0x1f, 0xdf, 0xfc, 0x41, 0x47, 0xed, 0x74, 0xf5, 0xb1,
+    0x3d, 0x7c, 0xf5, 0xce, 0x77, 0xd7, 0xf8, 0x2a, 0xec, 0x7e, 0x11, 0xab, 0xce, 0xa9, 0x08, 0x08,
+    0xef, 0x8a, 0x95, 0x18, 0x86, 0x52, 0x35, 0xd0, 0x8b, 0xc5, 0x24, 0x08, 0x5e, 0x94, 0xfa, 0x1c,
+    0x73, 0xe9, 0x49, 0x97, 0xe6, 0x5c, 0xb2, 0x52, 0xe7, 0xb0, 0x71, 0x44, 0x49, 0x59, 0xb8, 0x12,
+    0xb8, 0x5b, 0x43, 0x7b, 0x3d, 0x74, 0xec, 0xc8, 0x53, 0xc0, 0x17, 0x47, 0x49, 0x9e, 0xde, 0x43,
+    0xb1, 0x12, 0xc3, 0x21, 0xee, 0x2a, 0xb3, 0x53, 0x0b, 0x8b, 0x58, 0x05, 0x88, 0x5e, 0xfa, 0xe7,
+    0xf8, 0xfc, 0xdb, 0xd3, 0xb7, 0xae, 0xcb, 0x8a, 0xf8, 0xe9, 0xe6, 0x9b, 0x50, 0x3a, 0xbc, 0x19,
+    0xbd, 0xf1, 0xa9, 0x2c, 0x1d, 0x01, 0xab, 0x89, 0x92, 0x38, 0xa2, 0xf1, 0x7b, 0x7c, 0xd2, 0x89,
+    0x5e, 0xa8, 0xd0, 0x27, 0x71, 0xe6, 0xb0, 0x60, 0x4b, 0x35, 0x43, 0x38, 0xcd, 0xbf, 0x88, 0x28,
+    0x3e, 0x9b, 0xd0, 0xad, 0x18, 0x89, 0xdc, 0xae, 0xe8, 0x0e, 0x4d, 0x1d, 0x96, 0x0c, 0x1c, 0xab,
+    0xe6, 0x30, 0xf0, 0x9a, 0xcc, 0xb3, 0x38, 0x64, 0x1d, 0x50, 0xf3, 0xfe, 0x79, 0xb8, 0x8a, 0x5c,
+    0x42, 0x72, 0xd3, 0x0d, 0xcf, 0x27, 0x2e, 0xcf, 0x0e, 0x91, 0x1a, 0xff, 0xbd, 0x72, 0xf1, 0x1d,
+    0xa4, 0x57, 0xd1, 0xa3, 0xdc, 0x61, 0x83, 0x1f, 0x4d, 0x2a, 0x40, 0x28, 0xcc, 0x49, 0x88, 0x72,
+    0x92, 0x13, 0xcb, 0xbc, 0x7c, 0x14, 0xe9, 0xa8, 0xa2, 0x47, 0xfc, 0x22, 0xff, 0xf8, 0x8a, 0xf5,
+    0xc4, 0xb0, 0xaa, 0xe7, 0x25, 0x09, 0x6c, 0x7b, 0x5a, 0x3a, 0xae, 0x4b, 0x41, 0x0a, 0x0d, 0x0f,
+    0xa1, 0x81, 0x7d, 0x30, 0xce, 0xda, 0xcf, 0xc7, 0xdd, 0x0a, 0xb7, 0xbf, 0x3a, 0x67, 0x5f, 0x08,
+    0x55, 0x09, 0x06, 0xd2, 0x3f, 0xee, 0x04, 0xea, 0x76, 0xbb, 0x32, 0x13, 0x0d, 0x31, 0x5e, 0xf0,
+    0xca, 0x17, 0x02, 0xb2, 0x36, 0x44, 0xc3, 0xb1, 0x9e, 0x16, 0x78, 0xa4, 0xc7, 0x73, 0x4d, 0x87,
+    0x9a, 0x6b, 0x40, 0x94, 0xa9, 0xd1, 0x84, 0x08, 0xa9, 0xc2, 0x81, 0x6a, 0x36, 0x78, 0x08, 0xed,
+    0x0b, 0x02, 0xbc, 0x65, 0xf8, 0x81, 0xc7, 0x3c, 0xde, 0x4b, 0xe2, 0x44, 0x82, 0xda, 0x77, 0x9c,
+    0x8a, 0xc8, 0x5d, 0x31, 0xd6, 0x43, 0x09, 0xd6, 0x14, 0x2d, 0x0e, 0xaf, 0x75, 0x3e, 0xb9, 0x67,
+    0x2c, 0xe5, 0x16, 0x56, 0x55, 0xe1, 0xf3, 0x9c, 0x51, 0xc8, 0xca, 0x31, 0x34, 0xea, 0x92, 0x80,
+    0x59, 0xe2, 0xf3, 0x47, 0x45, 0x91, 0x7e, 0x6a, 0x39, 0x5b, 0x62, 0x6a, 0xd0, 0xb9, 0xde, 0x84,
+    0xf4, 0x54, 0xb5, 0x18, 0x55, 0x42, 0x13, 0xbb, 0x4a, 0xb8, 0xe2, 0x9e, 0xc1, 0x97, 0x7f, 0x7e,
+    0xbb, 0x08, 0x48, 0x38, 0x72, 0x32, 0x85, 0xc7, 0x0f, 0x5c, 0xae, 0x1a, 0x39, 0x94, 0xe0, 0x68,
+    0xfb, 0x50, 0xb4, 0xc5, 0xb5, 0xba, 0x70, 0x93, 0x93, 0x6a, 0x04, 0xdc, 0xe5, 0x98, 0xaa, 0x99,
+    0xe3, 0x4f, 0x85, 0xaa, 0x9c, 0x21, 0x61, 0xc7, 0xe8, 0x90, 0x78, 0x23, 0x56, 0xe1, 0xcb, 0x35,
+    0xd4, 0x6a, 0x36, 0x9b, 0x0a, 0x63, 0x31, 0xa6, 0xcf, 0xb2, 0x2d, 0x46, 0x6c, 0x99, 0x9b, 0x90,
+    0x8c, 0x57, 0x04, 0xff, 0xbc, 0xd4, 0xa1, 0xb0, 0x21, 0x0e, 0x21, 0x1c, 0x6b, 0xf2, 0xe9, 0x2d,
+    0xf0, 0xdc, 0xd5, 0xe3, 0xf1, 0xa9, 0x71, 0x4c, 0x17, 0x23, 0xcc, 0xdd, 0x8b, 0xef, 0xed, 0x6c,
+    0x6f, 0xeb, 0xb5, 0x18, 0xb4, 0xbc, 0xe3, 0x3c, 0x0b, 0x61, 0x7b, 0xf2, 0xfa, 0x8f, 0x77, 0xbe,
+    0x3b, 0x37, 0x7e, 0xed, 0xfa, 0xce, 0xf6, 0x55, 0x09, 0x84, 0x09, 0x11, 0xdc, 0x67, 0x5c, 0xc8,
+    0x94, 0xe3, 0x03, 0x4c, 0x1d, 0xc2, 0x69, 0x77, 0x6e, 0xff, 0x6d, 0xf2, 0xd6, 0xd5, 0x9d, 0xbf,
+    0x7f, 0x36, 0x39, 0xfb, 0xce, 0xf4, 0xc6, 0xe5, 0x84, 0x90, 0x49, 0xcb, 0x53, 0x8a, 0x6f, 0xce,
+    0x4c, 0xde, 0xfd, 0x26, 0xd9, 0x0e, 0xf1, 0x3a, 0x49, 0x85, 0xc8, 0x59, 0x68, 0xfc, 0xf1, 0x17,
+    0x3b, 0x5f, 0x5d, 0xd5, 0x77, 0x45, 0x69, 0x94, 0x4b, 0x0b, 0xdb, 0xdb, 0x58, 0x11, 0x43, 0x50,
+    0x85, 0x83, 0x4a, 0x0d, 0xad, 0x51, 0xd7, 0xca, 0xb6, 0x9c, 0xe8, 0x63, 0xc9, 0xbc, 0xee, 0x21,
+    0x28, 0x52, 0x9c, 0x8b, 0xbe, 0x77, 0x64, 0x51, 0x8a, 0xbf, 0xe5, 0x08, 0xb2, 0xb5, 0x22, 0x85,
+    0x00, 0x54, 0x55, 0xb8, 0x0d, 0x1c, 0x0d, 0x11, 0x7f, 0x13, 0x2f, 0xe0, 0x8c, 0x5e, 0x92, 0xd8,
+    0xbe, 0x07, 0xa5, 0x5b, 0x90, 0xd8, 0x91, 0x4d, 0x3f, 0x37, 0xb5, 0xc3, 0x7c, 0x56, 0x87, 0xe2,
+    0x33, 0x0e, 0x11, 0x28, 0xa6, 0x47, 0xe7, 0x05, 0x89, 0xa8, 0x67, 0x21, 0x48, 0x89, 0xa7, 0x2e,
+    0xaf, 0x0e, 0xf2, 0x9c, 0x84, 0x2b, 0xa1, 0xc4, 0x41, 0x00, 0x63, 0xb8, 0x49, 0x88, 0x95, 0x23,
+    0x98, 0xd9, 0x86, 0xb8, 0xf9, 0x83, 0x7c, 0xe2, 0x60, 0x3f, 0x24, 0xd6, 0x91, 0x10, 0x35, 0xf8,
+    0xf7, 0xdc, 0xa6, 0x04, 0xf2, 0xe9, 0x27, 0xef, 0xe8, 0x19, 0x98, 0x51, 0xf2, 0x97, 0xfb, 0x5e,
+    0x93, 0xb4, 0x0a, 0x54, 0x20, 0xe2, 0x84, 0xa4, 0xd4, 0x66, 0x40, 0xa3, 0x72, 0x93, 0xa5, 0xb1,
+    0x93, 0xd7, 0x2e, 0x8c, 0xdf, 0xb8, 0x22, 0x5b, 0x48, 0x68, 0x50, 0x9f, 0xdb, 0x51, 0x85, 0xa6,
+    0x2d, 0x6f, 0xd5, 0xe3, 0x6f, 0xff, 0x25, 0x13, 0x0b, 0x56, 0xa6, 0x7f, 0xba, 0xc6, 0xef, 0x79,
+    0xe7, 0xbe, 0x1c, 0x5f, 0x7f, 0x65, 0x7c, 0xe6, 0xcb, 0xbb, 0xef, 0x5e, 0x83, 0x39, 0x57, 0xaf,
+    0x21, 0xdd, 0x5b, 0xd3, 0xef, 0xc3, 0x24, 0x99, 0xa9, 0xf7, 0xb4, 0x47, 0x66, 0xf0, 0x4f, 0x37,
+    0xdf, 0x17, 0xd9, 0x11, 0x15, 0xe2, 0xef, 0x43, 0x43, 0x3e, 0xfd, 0x81, 0x23, 0x4b, 0xfc, 0x22,
+    0x62, 0x16, 0xcd, 0x17, 0x1f, 0x9d, 0x86, 0xdb, 0xe7, 0xf8, 0xc2, 0x5b, 0x77, 0x5f, 0x3d, 0x07,
+    0x77, 0x83, 0xc8, 0x30, 0xf1, 0x11, 0x2e, 0x1b, 0xd0, 0xf2, 0xbc, 0x16, 0x97, 0x0b, 0xc8, 0x21,
+    0x8b, 0x86, 0xb8, 0x0f, 0x96, 0xf2, 0xde, 0x83, 0x9d, 0xf4, 0xb7, 0x50, 0xe8, 0x1e, 0x58, 0x93,
+    0x90, 0x35, 0x1a, 0xe8, 0x98, 0x4d, 0xd0, 0xbe, 0xa3, 0x68, 0x88, 0xb7, 0x90, 0xed, 0xf9, 0xfc,
+    0x97, 0xe3, 0x70, 0x1c, 0x4e, 0xc8, 0x3f, 0x2a, 0x3b, 0x04, 0x41, 0xf6, 0x89, 0xaa, 0xe0, 0x9c,
+    0x27, 0x3c, 0xea, 0x86, 0xcb, 0x68, 0x8d, 0x10, 0x1f, 0xb1, 0x60, 0x0b, 0x92, 0xcc, 0xd8, 0x55,
+    0x7a, 0xf8, 0x2d, 0xf5, 0xf0, 0x73, 0xe0, 0x5f, 0xea, 0x18, 0xbf, 0xe1, 0x80, 0x5b, 0x10, 0x45,
+    0xe1, 0x61, 0xa6, 0xa5, 0x42, 0x07, 0x77, 0x15, 0x48, 0x17, 0xaf, 0xd0, 0x31, 0xc5, 0xbf, 0x07,
+    0xc8, 0x00, 0x03, 0x0a, 0x57, 0x32, 0xc3, 0xa5, 0xf8, 0xed, 0x2f, 0x6f, 0xb7, 0x1b, 0xe8, 0xb9,
+    0x67, 0x9f, 0x5a, 0x21, 0x38, 0x30, 0xed, 0xa3, 0x38, 0xc0, 0xc3, 0xb0, 0xc2, 0xd7, 0x0e, 0x82,
+    0xae, 0x03, 0x98, 0x61, 0x29, 0xd8, 0x90, 0x9f, 0x09, 0xaa, 0xe9, 0xef, 0x78, 0x1f, 0x24, 0xf8,
+    0x2c, 0x18, 0x25, 0xb1, 0x9f, 0xad, 0xb4, 0xc9, 0xf9, 0x0b, 0x77, 0x7e, 0xf8, 0x18, 0x4a, 0x2b,
+    0x3d, 0xde, 0x04, 0x0d, 0xa4, 0xb0, 0x1a, 0xd4, 0xbe, 0xfc, 0xb8, 0x00, 0x80, 0xc2, 0xbf, 0x2e,
+    0xc0, 0x0a, 0x37, 0xbf, 0x2d, 0x9d, 0x38, 0x55, 0x88, 0x16, 0xd9, 0x36, 0x14, 0x7f, 0x3b, 0xe6,
+    0xf9, 0xdb, 0x6a, 0xb6, 0x38, 0x9a, 0x48, 0x04, 0x5a, 0x8e, 0x87, 0x56, 0xa5, 0x71, 0x25, 0x38,
+    0xc3, 0xc1, 0xaf, 0x32, 0x23, 0x9d, 0xaf, 0x96, 0xe6, 0xbe, 0x84, 0xe3, 0x5f, 0x3c, 0x5f, 0x95,
+    0x5c, 0x99, 0x9b, 0xb1, 0x99, 0xf0, 0x8a, 0xc0, 0xc6, 0x55, 0xc8, 0x6b, 0x6b, 0x7e, 0x49, 0xfd,
+    0x7c, 0x03, 0x93, 0x04, 0x5e, 0x96, 0x9f, 0x02, 0xa3, 0x5b, 0x2e, 0x5c, 0xe7, 0xc5, 0x47, 0xc0,
+    0x4e, 0x43, 0xfe, 0xe7, 0x93, 0xff, 0x01, 0x2f, 0x19, 0x2c, 0xb0, 0x8d, 0x22, 0x00, 0x00,
+};
+
+}  // namespace DeviceCore
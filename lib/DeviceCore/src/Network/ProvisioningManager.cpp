@@ -1,5 +1,9 @@
 #include "ProvisioningManager.h"
+#include "../Core/FixedString.h"
+#include "../Core/Log.h"
+#include <cctype>
 #include <functional>
+#include "PortalPage.h"
 
 namespace DeviceCore {
 
@@ -7,14 +11,64 @@ namespace {
 constexpr const char* kProvisioningApSsid = "esp-sta";
 constexpr size_t kMaxStoredSsidLength = 32;
 constexpr size_t kMaxStoredPasswordLength = 64;
+constexpr const char* kPortalUrl = "http://192.168.4.1/";
+const char* kIfNoneMatchHeader = "If-None-Match";
+// Requests are served from the lwIP callback context with per-request
+// buffers; cap how many may be open at once and keep a heap reserve.
+constexpr uint8_t kMaxConcurrentRequests = 4;
+constexpr uint32_t kMinFreeHeapBytes = 8192;
+constexpr size_t kMaxSubmitBytes = 512;
+
+// Copies a form field with surrounding whitespace removed. An absent field
+// reads as empty; false if the trimmed value does not fit.
+template <size_t N>
+bool readTrimmedParam(AsyncWebServerRequest* request, const char* name, FixedString<N>& out) {
+  out.clear();
+  if (!request->hasParam(name, true)) {
+    return true;
+  }
+  const String& value = request->getParam(name, true)->value();
+  const char* text = value.c_str();
+  size_t length = value.length();
+  while (length > 0 && isspace(static_cast<unsigned char>(text[0]))) {
+    ++text;
+    --length;
+  }
+  while (length > 0 && isspace(static_cast<unsigned char>(text[length - 1]))) {
+    --length;
+  }
+  return out.append(text, length);
+}
+// Page reloads within this window reuse the last scan instead of
+// retuning the radio.
+constexpr unsigned long kScanTtlMs = 30000UL;
+constexpr unsigned long kTestConnectTimeoutMs = 20000UL;
+// Keeps the portal up after a confirmed join so the page can show it.
+constexpr unsigned long kHandoffGraceMs = 5000UL;
+const char* const kTestStateNames[] = {"idle", "connecting", "connected", "failed"};
 }
 
-ProvisioningManager::ProvisioningManager(CredentialStore& store, const char* phone, const char* manualUrl)
+ProvisioningManager::ProvisioningManager(CredentialStore& store,
+                                         WifiScanCache& scanCache,
+                                         const char* phone,
+                                         const char* manualUrl)
     : _store(store),
+      _scanCache(scanCache),
       _server(80),
       _provisioning(false),
+      _routesReady(false),
       _hasPending(false),
       _pending(),
+      _submitReady(false),
+      _submitted(),
+      _activeRequests(0),
+      _scanRequested(false),
+      _testing(),
+      _testState(TestConnectState::Idle),
+      _testReason(nullptr),
+      _testStartMs(0),
+      _testDoneMs(0),
+      _testIp(0),
       _maintenancePhone(phone),
       _userManualUrl(manualUrl) {}
 
@@ -27,17 +81,26 @@ void ProvisioningManager::begin() {
   WiFi.mode(WIFI_AP_STA);
   WiFi.softAP(kProvisioningApSsid);
 
-  setupRoutes();
+  if (!_routesReady) {
+    setupRoutes();
+    _routesReady = true;
+  }
   _server.begin();
 
   // 启动 DNS 服务器，将所有域名解析到 AP IP，实现强制门户 (Captive Portal)
+  _dnsServer.setErrorReplyCode(AsyncDNSReplyCode::NoError);
   _dnsServer.start(53, "*", WiFi.softAPIP());
 
   _provisioning = true;
   _hasPending = false;
   _pending = StoredCredentials();
-  Serial.println("[Provisioning] AP started: esp-sta");
-  Serial.println("[Provisioning] Connect and visit http://192.168.4.1");
+  _submitReady = false;
+  _testState = TestConnectState::Idle;
+  _testReason = nullptr;
+  // Warm the cache so the first page load already has a network list.
+  _scanRequested = true;
+  DC_LOG_INFO("Provisioning", "AP started: esp-sta");
+  DC_LOG_INFO("Provisioning", "Connect and visit http://192.168.4.1");
 }
 
 void ProvisioningManager::stop() {
@@ -45,16 +108,39 @@ void ProvisioningManager::stop() {
     return;
   }
   _dnsServer.stop();
-  _server.stop();
+  _server.end();
   WiFi.softAPdisconnect(true);
   _provisioning = false;
+  _testState = TestConnectState::Idle;
 }
 
 void ProvisioningManager::loop() {
-  if (_provisioning) {
-    _dnsServer.processNextRequest();
-    _server.handleClient();
+  // HTTP and DNS are served from lwIP callbacks; radio and flash work is
+  // left for the loop, where it cannot stall the TCP stack.
+  if (!_provisioning) {
+    return;
+  }
+
+  unsigned long now = millis();
+  if (_submitReady) {
+    startTestConnect(now);
   }
+  if (_testState == TestConnectState::Connecting) {
+    pollTestConnect(now);
+    return;  // Scanning would abort the join.
+  }
+  if (_testState == TestConnectState::Connected && now - _testDoneMs >= kHandoffGraceMs) {
+    _pending = _testing;
+    _hasPending = true;
+    stop();
+    return;
+  }
+
+  if (_scanRequested) {
+    _scanRequested = false;
+    _scanCache.request(now, kScanTtlMs);
+  }
+  _scanCache.poll(now);
 }
 
 bool ProvisioningManager::isProvisioning() const {
@@ -71,202 +157,255 @@ StoredCredentials ProvisioningManager::consumeCredentials() {
 }
 
 void ProvisioningManager::setupRoutes() {
-  _server.on("/", HTTP_GET, std::bind(&ProvisioningManager::handleRoot, this));
-  _server.on("/submit", HTTP_POST, std::bind(&ProvisioningManager::handleSubmit, this));
-  _server.onNotFound(std::bind(&ProvisioningManager::handleRoot, this));
+  using std::placeholders::_1;
+  _server.on("/", HTTP_GET, std::bind(&ProvisioningManager::handleRoot, this, _1));
+  _server.on("/info.json", HTTP_GET, std::bind(&ProvisioningManager::handleInfo, this, _1));
+  _server.on("/scan", HTTP_GET, std::bind(&ProvisioningManager::handleScan, this, _1));
+  _server.on("/submit", HTTP_POST, std::bind(&ProvisioningManager::handleSubmit, this, _1));
+  _server.on("/status", HTTP_GET, std::bind(&ProvisioningManager::handleStatus, this, _1));
+  _server.onNotFound(std::bind(&ProvisioningManager::handleNotFound, this, _1));
 }
 
-void ProvisioningManager::handleRoot() {
-  String phone = _maintenancePhone ? _maintenancePhone : "暂无";
-  String manualUrl = _userManualUrl ? _userManualUrl : "http://www.readme.com";
-
-  String page = R"rawliteral(<!DOCTYPE html>
-<html lang="zh-CN">
-<head>
-  <meta charset="UTF-8">
-  <meta name="viewport" content="width=device-width, initial-scale=1">
-  <title>设备网络配置</title>
-  <style>
-    :root {
-      --bg-color: #f0f2f5;
-      --card-bg: #ffffff;
-      --primary-color: #0056b3; /* Industrial Blue */
-      --text-primary: #333333;
-      --text-secondary: #666666;
-      --border-color: #dcdcdc;
-      --input-bg: #f9f9f9;
-      font-family: -apple-system, BlinkMacSystemFont, "Segoe UI", Roboto, Helvetica, Arial, sans-serif;
-    }
-    body {
-      background-color: var(--bg-color);
-      color: var(--text-primary);
-      display: flex;
-      justify-content: center;
-      align-items: center;
-      min-height: 100vh;
-      margin: 0;
-      padding: 20px;
-    }
-    .container {
-      background: var(--card-bg);
-      width: 100%;
-      max-width: 400px;
-      padding: 30px;
-      border-radius: 8px;
-      box-shadow: 0 4px 12px rgba(0,0,0,0.1);
-      border-top: 4px solid var(--primary-color);
-    }
-    h1 {
-      font-size: 20px;
-      margin-top: 0;
-      margin-bottom: 20px;
-      color: var(--primary-color);
-      text-transform: uppercase;
-      letter-spacing: 0.5px;
-      border-bottom: 1px solid var(--border-color);
-      padding-bottom: 10px;
-    }
-    .info-group {
-      margin-bottom: 20px;
-      padding: 15px;
-      background-color: #eef6fc;
-      border-radius: 4px;
-      font-size: 14px;
-    }
-    .info-item {
-      margin-bottom: 8px;
-      display: flex;
-      justify-content: space-between;
-    }
-    .info-item:last-child {
-      margin-bottom: 0;
-    }
-    .info-label {
-      font-weight: 600;
-      color: var(--text-secondary);
-    }
-    .info-value {
-      font-weight: 500;
-    }
-    form {
-      display: flex;
-      flex-direction: column;
-      gap: 15px;
-    }
-    label {
-      font-size: 14px;
-      font-weight: 600;
-      margin-bottom: 4px;
-      display: block;
-    }
-    input {
-      width: 100%;
-      padding: 10px;
-      border: 1px solid var(--border-color);
-      border-radius: 4px;
-      background-color: var(--input-bg);
-      font-size: 16px;
-      box-sizing: border-box;
-    }
-    input:focus {
-      border-color: var(--primary-color);
-      outline: none;
+bool ProvisioningManager::admit(AsyncWebServerRequest* request) {
+  if (_activeRequests >= kMaxConcurrentRequests || ESP.getFreeHeap() < kMinFreeHeapBytes) {
+    AsyncWebServerResponse* response = request->beginResponse(503, "text/plain", "Busy");
+    response->addHeader("Retry-After", "1");
+    request->send(response);
+    return false;
+  }
+  ++_activeRequests;
+  request->onDisconnect([this]() {
+    if (_activeRequests > 0) {
+      --_activeRequests;
     }
-    button {
-      background-color: var(--primary-color);
-      color: white;
-      border: none;
-      padding: 12px;
-      border-radius: 4px;
-      font-size: 16px;
-      font-weight: 600;
-      cursor: pointer;
-      transition: background-color 0.2s;
+  });
+  return true;
+}
+
+void ProvisioningManager::handleRoot(AsyncWebServerRequest* request) {
+  if (!admit(request)) {
+    return;
+  }
+
+  // The page is static; the browser revalidates with If-None-Match and
+  // gets a bodiless 304 once it has a copy.
+  if (request->hasHeader(kIfNoneMatchHeader) && request->getHeader(kIfNoneMatchHeader)->value() == kPortalPageEtag) {
+    AsyncWebServerResponse* response = request->beginResponse(304);
+    response->addHeader("ETag", kPortalPageEtag);
+    request->send(response);
+    return;
+  }
+
+  // Streamed straight from flash as the TCP window allows.
+  AsyncWebServerResponse* response = request->beginResponse_P(200, "text/html", kPortalPageGz, kPortalPageGzLength);
+  response->addHeader("Content-Encoding", "gzip");
+  response->addHeader("ETag", kPortalPageEtag);
+  response->addHeader("Cache-Control", "no-cache");
+  request->send(response);
+}
+
+void ProvisioningManager::handleInfo(AsyncWebServerRequest* request) {
+  if (!admit(request)) {
+    return;
+  }
+
+  char phone[48];
+  char manualUrl[160];
+  escapeJson(_maintenancePhone ? _maintenancePhone : "暂无", phone, sizeof(phone));
+  escapeJson(_userManualUrl ? _userManualUrl : "http://www.readme.com", manualUrl, sizeof(manualUrl));
+
+  char body[256];
+  snprintf(body, sizeof(body), "{\"phone\":\"%s\",\"manual\":\"%s\",\"chipId\":\"%x\"}",
+           phone, manualUrl, static_cast<unsigned>(ESP.getChipId()));
+  AsyncWebServerResponse* response = request->beginResponse(200, "application/json", body);
+  response->addHeader("Cache-Control", "no-store");
+  request->send(response);
+}
+
+void ProvisioningManager::handleNotFound(AsyncWebServerRequest* request) {
+  if (!admit(request)) {
+    return;
+  }
+  // Captive-portal probes land here; a redirect is enough to make the OS
+  // open the portal and costs no page render.
+  request->redirect(kPortalUrl);
+}
+
+void ProvisioningManager::handleScan(AsyncWebServerRequest* request) {
+  if (!admit(request)) {
+    return;
+  }
+
+  unsigned long now = millis();
+  if (!_scanCache.fresh(now, kScanTtlMs)) {
+    _scanRequested = true;
+  }
+
+  AsyncResponseStream* response = request->beginResponseStream("application/json");
+  response->addHeader("Cache-Control", "no-store");
+  response->print("{\"scanning\":");
+  response->print(_scanCache.scanning() || _scanRequested ? "true" : "false");
+  response->print(",\"networks\":[");
+
+  // Results are sorted by RSSI, so the first entry per SSID is the
+  // strongest access point for it.
+  bool first = true;
+  for (size_t i = 0; i < _scanCache.size(); ++i) {
+    const ScannedNetwork& network = _scanCache.at(i);
+    if (network.ssid[0] == '\0') {
+      continue;
     }
-    button:hover {
-      background-color: #004494;
+    bool duplicate = false;
+    for (size_t j = 0; j < i && !duplicate; ++j) {
+      duplicate = strcmp(_scanCache.at(j).ssid, network.ssid) == 0;
     }
-    .footer {
-      margin-top: 25px;
-      font-size: 12px;
-      color: var(--text-secondary);
-      text-align: center;
-      border-top: 1px solid var(--border-color);
-      padding-top: 15px;
+    if (duplicate) {
+      continue;
     }
-    a {
-      color: var(--primary-color);
-      text-decoration: none;
+    response->print(first ? "{\"ssid\":" : ",{\"ssid\":");
+    printJsonString(*response, network.ssid);
+    response->print(",\"rssi\":");
+    response->print(network.rssi);
+    response->print(",\"open\":");
+    response->print(network.open ? "true}" : "false}");
+    first = false;
+  }
+  response->print("]}");
+  request->send(response);
+}
+
+void ProvisioningManager::printJsonString(Print& out, const char* text) {
+  out.print('"');
+  for (; *text; ++text) {
+    if (*text == '"' || *text == '\\') {
+      out.print('\\');
+    } else if (static_cast<uint8_t>(*text) < 0x20) {
+      continue;
     }
-    a:hover {
-      text-decoration: underline;
+    out.print(*text);
+  }
+  out.print('"');
+}
+
+void ProvisioningManager::escapeJson(const char* in, char* out, size_t outSize) {
+  size_t pos = 0;
+  for (; *in && pos + 2 < outSize; ++in) {
+    if (*in == '"' || *in == '\\') {
+      out[pos++] = '\\';
+    } else if (static_cast<uint8_t>(*in) < 0x20) {
+      continue;
     }
-  </style>
-</head>
-<body>
-  <div class="container">
-    <h1>设备网络配置</h1>
-    
-    <div class="info-group">
-      <div class="info-item">
-        <span class="info-label">维保电话:</span>
-        <span class="info-value">)rawliteral" + phone + R"rawliteral(</span>
-      </div>
-      <div class="info-item">
-        <span class="info-label">使用手册:</span>
-        <span class="info-value"><a href=")rawliteral" + manualUrl + R"rawliteral(" target="_blank">点击查看</a></span>
-      </div>
-    </div>
-
-    <form method="POST" action="/submit">
-      <div>
-        <label for="ssid">Wi-Fi 名称 (SSID)</label>
-        <input type="text" id="ssid" name="ssid" required placeholder="输入 Wi-Fi 名称">
-      </div>
-      <div>
-        <label for="password">Wi-Fi 密码</label>
-        <input type="password" id="password" name="password" placeholder="输入 Wi-Fi 密码">
-      </div>
-      <button type="submit">保存并连接</button>
-    </form>
-
-    <div class="footer">
-      <p>请确保输入正确的 2.4GHz 网络信息。</p>
-      <p>设备 ID: )rawliteral" + String(ESP.getChipId(), HEX) + R"rawliteral(</p>
-    </div>
-  </div>
-</body>
-</html>
-)rawliteral";
-  _server.send(200, "text/html", page);
+    out[pos++] = *in;
+  }
+  out[pos] = '\0';
 }
 
-void ProvisioningManager::handleSubmit() {
-  String ssid = _server.arg("ssid");
-  String password = _server.arg("password");
+void ProvisioningManager::handleSubmit(AsyncWebServerRequest* request) {
+  if (!admit(request)) {
+    return;
+  }
+  if (request->contentLength() > kMaxSubmitBytes) {
+    request->send(413, "text/plain", "Request too large.");
+    return;
+  }
+  if (_submitReady || _testState == TestConnectState::Connecting || _testState == TestConnectState::Connected) {
+    request->send(409, "text/plain", "A connection test is already running.");
+    return;
+  }
 
-  ssid.trim();
-  password.trim();
+  FixedString<kMaxStoredSsidLength> ssid;
+  FixedString<kMaxStoredPasswordLength> password;
+  if (!readTrimmedParam(request, "ssid", ssid) || !readTrimmedParam(request, "password", password) || ssid.empty()) {
+    request->send(400, "text/plain", "Invalid SSID or password length.");
+    return;
+  }
+
+  memset(_submitted.ssid, 0, sizeof(_submitted.ssid));
+  memset(_submitted.password, 0, sizeof(_submitted.password));
+  memcpy(_submitted.ssid, ssid.c_str(), ssid.length());
+  memcpy(_submitted.password, password.c_str(), password.length());
+  _submitted.valid = true;
+  _submitReady = true;
 
-  if (ssid.length() == 0 || ssid.length() > kMaxStoredSsidLength ||
-      password.length() > kMaxStoredPasswordLength) {
-    _server.send(400, "text/plain", "Invalid SSID or password length.");
+  // Progress is reported through /status while loop() runs the test.
+  request->send(202, "application/json", "{\"state\":\"connecting\"}");
+}
+
+void ProvisioningManager::handleStatus(AsyncWebServerRequest* request) {
+  if (!admit(request)) {
     return;
   }
 
-  memset(_pending.ssid, 0, sizeof(_pending.ssid));
-  memset(_pending.password, 0, sizeof(_pending.password));
-  ssid.toCharArray(_pending.ssid, sizeof(_pending.ssid));
-  password.toCharArray(_pending.password, sizeof(_pending.password));
-  _pending.valid = true;
+  TestConnectState state = _submitReady ? TestConnectState::Connecting : _testState;
+  unsigned long elapsed = state == TestConnectState::Connecting && !_submitReady ? millis() - _testStartMs : 0;
+  IPAddress ip(_testIp);
+  char ssid[72];
+  escapeJson(_testing.ssid, ssid, sizeof(ssid));
 
-  if (_store.save(_pending)) {
-    _server.send(200, "text/html", "<html><body><h2>保存成功</h2><p>设备正在尝试连接新的 Wi-Fi，请断开此热点。</p></body></html>");
-    _hasPending = true;
-    stop();
-  } else {
-    _server.send(500, "text/plain", "保存凭据失败。");
+  char body[192];
+  snprintf(body, sizeof(body),
+           "{\"state\":\"%s\",\"ssid\":\"%s\",\"elapsedMs\":%lu,\"reason\":\"%s\",\"ip\":\"%u.%u.%u.%u\"}",
+           kTestStateNames[static_cast<uint8_t>(state)], ssid, elapsed, _testReason ? _testReason : "",
+           ip[0], ip[1], ip[2], ip[3]);
+  AsyncWebServerResponse* response = request->beginResponse(200, "application/json", body);
+  response->addHeader("Cache-Control", "no-store");
+  request->send(response);
+}
+
+void ProvisioningManager::startTestConnect(unsigned long now) {
+  _testing = _submitted;
+  _testReason = nullptr;
+  _testIp = 0;
+  _testStartMs = now;
+  _testState = TestConnectState::Connecting;
+  _submitReady = false;
+
+  // The soft AP stays up in WIFI_AP_STA; it follows the STA's channel if
+  // the target AP is on a different one.
+  WiFi.config(IPAddress(0U), IPAddress(0U), IPAddress(0U));
+  WiFi.begin(_testing.ssid, _testing.password);
+  DC_LOG_INFO("Provisioning", "Testing connection.");
+  DC_LOG_DEBUG("Provisioning", "Test SSID: %s", _testing.ssid);
+}
+
+void ProvisioningManager::pollTestConnect(unsigned long now) {
+  switch (WiFi.status()) {
+    case WL_CONNECTED:
+      // Only a confirmed join is worth a flash write.
+      if (!_store.save(_testing)) {
+        failTestConnect(now, "save_failed");
+        return;
+      }
+      _testIp = WiFi.localIP();
+      _testDoneMs = now;
+      _testState = TestConnectState::Connected;
+      DC_LOG_INFO("Provisioning", "Test connection succeeded in ms: %lu", now - _testStartMs);
+      return;
+    case WL_WRONG_PASSWORD:
+      failTestConnect(now, "wrong_password");
+      return;
+    case WL_NO_SSID_AVAIL:
+      failTestConnect(now, "no_ssid");
+      return;
+    case WL_CONNECT_FAILED:
+      failTestConnect(now, "connect_failed");
+      return;
+    default:
+      break;
+  }
+
+  if (now - _testStartMs >= kTestConnectTimeoutMs) {
+    failTestConnect(now, "timeout");
   }
 }
 
+void ProvisioningManager::failTestConnect(unsigned long now, const char* reason) {
+  // Drop the STA side only; the portal keeps running for another attempt.
+  WiFi.disconnect(false);
+  _testReason = reason;
+  _testDoneMs = now;
+  _testState = TestConnectState::Failed;
+  DC_LOG_WARN("Provisioning", "Test connection failed: %s", reason);
+}
+
 }  // namespace DeviceCore
@@ -2,15 +2,26 @@
 
 #include <Arduino.h>
 #include <ESP8266WiFi.h>
-#include <ESP8266WebServer.h>
-#include <DNSServer.h>
+#include <ESPAsyncWebServer.h>
+#include <ESPAsyncDNSServer.h>
 #include "../Storage/CredentialStore.h"
+#include "WifiScanCache.h"
 
 namespace DeviceCore {
 
+enum class TestConnectState : uint8_t {
+  Idle,
+  Connecting,
+  Connected,
+  Failed,
+};
+
 class ProvisioningManager {
 public:
-  ProvisioningManager(CredentialStore& store, const char* phone = nullptr, const char* manualUrl = nullptr);
+  ProvisioningManager(CredentialStore& store,
+                      WifiScanCache& scanCache,
+                      const char* phone = nullptr,
+                      const char* manualUrl = nullptr);
 
   void begin();
   void stop();
@@ -18,20 +29,46 @@ public:
   bool isProvisioning() const;
   bool hasNewCredentials() const;
   StoredCredentials consumeCredentials();
+  TestConnectState testState() const { return _testState; }
 
 private:
   CredentialStore& _store;
-  ESP8266WebServer _server;
-  DNSServer _dnsServer;
+  WifiScanCache& _scanCache;
+  AsyncWebServer _server;
+  AsyncDNSServer _dnsServer;
   bool _provisioning;
+  bool _routesReady;
   bool _hasPending;
   StoredCredentials _pending;
+  // Written by the async server callbacks, consumed by loop().
+  volatile bool _submitReady;
+  StoredCredentials _submitted;
+  volatile uint8_t _activeRequests;
+  volatile bool _scanRequested;
+  // Credentials under test; only persisted once the STA join succeeds.
+  StoredCredentials _testing;
+  volatile TestConnectState _testState;
+  const char* _testReason;
+  unsigned long _testStartMs;
+  unsigned long _testDoneMs;
+  uint32_t _testIp;
   const char* _maintenancePhone;
   const char* _userManualUrl;
 
   void setupRoutes();
-  void handleRoot();
-  void handleSubmit();
+  bool admit(AsyncWebServerRequest* request);
+  void handleRoot(AsyncWebServerRequest* request);
+  void handleInfo(AsyncWebServerRequest* request);
+  void handleNotFound(AsyncWebServerRequest* request);
+  void handleScan(AsyncWebServerRequest* request);
+  void handleSubmit(AsyncWebServerRequest* request);
+  void handleStatus(AsyncWebServerRequest* request);
+  void startTestConnect(unsigned long now);
+  void pollTestConnect(unsigned long now);
+  void failTestConnect(unsigned long now, const char* reason);
+
+  static void escapeJson(const char* in, char* out, size_t outSize);
+  static void printJsonString(Print& out, const char* text);
 };
 
 }  // namespace DeviceCore
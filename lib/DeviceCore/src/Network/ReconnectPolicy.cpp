@@ -0,0 +1,99 @@
+#include "ReconnectPolicy.h"
+#include "../Core/Log.h"
+
+namespace DeviceCore {
+
+ReconnectPolicy::ReconnectPolicy(const char* name,
+                                 unsigned long baseDelayMs,
+                                 unsigned long maxDelayMs,
+                                 unsigned long stableSessionMs)
+    : _name(name),
+      _baseDelayMs(baseDelayMs ? baseDelayMs : 1UL),
+      _maxDelayMs(maxDelayMs > baseDelayMs ? maxDelayMs : baseDelayMs),
+      _stableSessionMs(stableSessionMs),
+      _nextAttemptMs(0),
+      _outageStartMs(0),
+      _sessionStartMs(0),
+      _consecutiveFailures(0),
+      _outageAttempts(0),
+      _inOutage(false),
+      _connected(false),
+      _stats() {}
+
+bool ReconnectPolicy::shouldAttempt(unsigned long now) const {
+  return static_cast<long>(now - _nextAttemptMs) >= 0;
+}
+
+void ReconnectPolicy::onAttempt(unsigned long now) {
+  if (!_inOutage) {
+    _inOutage = true;
+    _outageStartMs = now;
+  }
+  ++_outageAttempts;
+  ++_stats.attempts;
+  // Until the outcome is known, do not allow another attempt straight away.
+  _nextAttemptMs = now + _baseDelayMs;
+}
+
+void ReconnectPolicy::onFailure(unsigned long now) {
+  ++_stats.failures;
+  if (_consecutiveFailures < 0xFF) {
+    ++_consecutiveFailures;
+  }
+  if (_consecutiveFailures == kBreakerThreshold) {
+    ++_stats.breakerTrips;
+    DC_LOG_WARN("Reconnect", "%s breaker open, backing off to the cap.", _name);
+  }
+  _nextAttemptMs = now + nextDelay();
+}
+
+void ReconnectPolicy::onSuccess(unsigned long now) {
+  ++_stats.successes;
+  if (_inOutage) {
+    _stats.lastTimeToReconnectMs = now - _outageStartMs;
+    if (_stats.lastTimeToReconnectMs > _stats.maxTimeToReconnectMs) {
+      _stats.maxTimeToReconnectMs = _stats.lastTimeToReconnectMs;
+    }
+    DC_LOG_INFO("Reconnect", "%s up after ms: %lu, attempts: %lu", _name, _stats.lastTimeToReconnectMs,
+                static_cast<unsigned long>(_outageAttempts));
+  }
+  _outageAttempts = 0;
+  _inOutage = false;
+  _connected = true;
+  _sessionStartMs = now;
+}
+
+void ReconnectPolicy::onDisconnected(unsigned long now) {
+  if (!_connected) {
+    return;
+  }
+  _connected = false;
+  _inOutage = true;
+  _outageStartMs = now;
+
+  // A healthy session earns a fast first retry; a flapping one keeps its
+  // backoff level (and an open breaker stays open).
+  if (now - _sessionStartMs >= _stableSessionMs) {
+    _consecutiveFailures = 0;
+  }
+  _nextAttemptMs = now + nextDelay();
+}
+
+// random() reads the hardware RNG until someone calls randomSeed(), which
+// would switch it to a seeded rand(); nothing in DeviceCore does.
+unsigned long ReconnectPolicy::nextDelay() {
+  if (breakerOpen()) {
+    return _maxDelayMs / 2 + static_cast<unsigned long>(random(static_cast<long>(_maxDelayMs / 2) + 1));
+  }
+
+  unsigned long ceiling = _baseDelayMs;
+  for (uint8_t i = 0; i < _consecutiveFailures && ceiling < _maxDelayMs; ++i) {
+    ceiling *= 2;
+  }
+  if (ceiling > _maxDelayMs) {
+    ceiling = _maxDelayMs;
+  }
+  return static_cast<unsigned long>(random(static_cast<long>(ceiling) + 1));
+}
+
+}  // namespace DeviceCore
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace DeviceCore {
+
+struct ReconnectStats {
+  uint32_t attempts;
+  uint32_t successes;
+  uint32_t failures;
+  uint32_t breakerTrips;
+  unsigned long lastTimeToReconnectMs;
+  unsigned long maxTimeToReconnectMs;
+};
+
+// Decides when the next reconnect attempt may run. Delays grow exponentially
+// with "full jitter" (uniform in [0, min(cap, base * 2^n))) so a fleet that
+// lost its broker at the same moment does not come back in lockstep. After
+// kBreakerThreshold consecutive failures the breaker opens and attempts are
+// spaced at the cap until one succeeds. A session that stayed up for
+// stableSessionMs resets the backoff so the next outage starts fast again.
+class ReconnectPolicy {
+public:
+  static constexpr uint8_t kBreakerThreshold = 8;
+
+  ReconnectPolicy(const char* name, unsigned long baseDelayMs, unsigned long maxDelayMs, unsigned long stableSessionMs);
+
+  bool shouldAttempt(unsigned long now) const;
+  void onAttempt(unsigned long now);
+  void onFailure(unsigned long now);
+  void onSuccess(unsigned long now);
+  void onDisconnected(unsigned long now);
+
+  bool breakerOpen() const { return _consecutiveFailures >= kBreakerThreshold; }
+  unsigned long nextAttemptMs() const { return _nextAttemptMs; }
+  const ReconnectStats& stats() const { return _stats; }
+
+private:
+  const char* _name;
+  unsigned long _baseDelayMs;
+  unsigned long _maxDelayMs;
+  unsigned long _stableSessionMs;
+  unsigned long _nextAttemptMs;
+  unsigned long _outageStartMs;
+  unsigned long _sessionStartMs;
+  uint8_t _consecutiveFailures;
+  uint32_t _outageAttempts;
+  bool _inOutage;
+  bool _connected;
+  ReconnectStats _stats;
+
+  unsigned long nextDelay();
+};
+
+}  // namespace DeviceCore
@@ -0,0 +1,138 @@
+#include "WifiScanCache.h"
+#include "../Core/Log.h"
+
+#include <ESP8266WiFi.h>
+#include <cstring>
+
+namespace DeviceCore {
+
+namespace {
+constexpr int kNoPendingScan = WIFI_SCAN_RUNNING;
+// The SDK normally finishes a full-channel scan in ~2 s; give up well after.
+constexpr unsigned long kScanTimeoutMs = 10000UL;
+}
+
+WifiScanCache::WifiScanCache()
+    : _count(0),
+      _valid(false),
+      _scanning(false),
+      _pendingCount(kNoPendingScan),
+      _completedMs(0),
+      _startedMs(0) {}
+
+bool WifiScanCache::request(unsigned long now, unsigned long maxAgeMs) {
+  poll(now);
+  if (fresh(now, maxAgeMs)) {
+    return true;
+  }
+  if (_scanning) {
+    return false;
+  }
+
+  _scanning = true;
+  _startedMs = now;
+  _pendingCount = kNoPendingScan;
+  WiFi.scanNetworksAsync([this](int found) { _pendingCount = found; });
+  return false;
+}
+
+void WifiScanCache::poll(unsigned long now) {
+  if (!_scanning) {
+    return;
+  }
+
+  int found = _pendingCount;
+  if (found == kNoPendingScan) {
+    if (now - _startedMs >= kScanTimeoutMs) {
+      DC_LOG_WARN("Scan", "Timed out.");
+      _scanning = false;
+      WiFi.scanDelete();
+    }
+    return;
+  }
+
+  collect(found, now);
+  _scanning = false;
+  _pendingCount = kNoPendingScan;
+}
+
+bool WifiScanCache::fresh(unsigned long now, unsigned long maxAgeMs) const {
+  return _valid && now - _completedMs < maxAgeMs;
+}
+
+unsigned long WifiScanCache::ageMs(unsigned long now) const {
+  return _valid ? now - _completedMs : ~0UL;
+}
+
+const ScannedNetwork* WifiScanCache::strongest(const char* ssid, const uint8_t* excludeBssid) const {
+  if (!ssid) {
+    return nullptr;
+  }
+  // Results are sorted, so the first match is the strongest.
+  for (size_t i = 0; i < _count; ++i) {
+    if (excludeBssid && memcmp(_results[i].bssid, excludeBssid, sizeof(_results[i].bssid)) == 0) {
+      continue;
+    }
+    if (strcmp(_results[i].ssid, ssid) == 0) {
+      return &_results[i];
+    }
+  }
+  return nullptr;
+}
+
+void WifiScanCache::collect(int found, unsigned long now) {
+  _count = 0;
+  for (int i = 0; i < found; ++i) {
+    uint8_t index = static_cast<uint8_t>(i);
+    if (WiFi.isHidden(index)) {
+      continue;
+    }
+    ScannedNetwork entry;
+    // The SDK record, not WiFi.SSID(), so no String is built per result.
+    const bss_info* info = WiFi.getScanInfoByIndex(index);
+    size_t ssidLength = info ? info->ssid_len : 0;
+    if (ssidLength > sizeof(entry.ssid) - 1) {
+      ssidLength = sizeof(entry.ssid) - 1;
+    }
+    if (ssidLength > 0) {
+      memcpy(entry.ssid, info->ssid, ssidLength);
+    }
+    entry.ssid[ssidLength] = '\0';
+    const uint8_t* bssid = WiFi.BSSID(index);
+    if (bssid) {
+      memcpy(entry.bssid, bssid, sizeof(entry.bssid));
+    } else {
+      memset(entry.bssid, 0, sizeof(entry.bssid));
+    }
+    entry.channel = WiFi.channel(index);
+    entry.rssi = WiFi.RSSI(index);
+    entry.open = WiFi.encryptionType(index) == ENC_TYPE_NONE;
+    insert(entry);
+  }
+  WiFi.scanDelete();
+
+  _valid = found >= 0;
+  _completedMs = now;
+  DC_LOG_INFO("Scan", "Networks seen: %d", found < 0 ? 0 : static_cast<int>(found));
+}
+
+void WifiScanCache::insert(const ScannedNetwork& entry) {
+  // Insertion sort by RSSI, keeping the strongest kMaxResults.
+  size_t pos = _count;
+  while (pos > 0 && _results[pos - 1].rssi < entry.rssi) {
+    --pos;
+  }
+  if (pos >= kMaxResults) {
+    return;
+  }
+  size_t last = _count < kMaxResults ? _count : kMaxResults - 1;
+  for (size_t i = last; i > pos; --i) {
+    _results[i] = _results[i - 1];
+  }
+  _results[pos] = entry;
+  if (_count < kMaxResults) {
+    ++_count;
+  }
+}
+
+}  // namespace DeviceCore
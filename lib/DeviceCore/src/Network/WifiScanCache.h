@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Arduino.h>
+
+#ifndef DEVICECORE_WIFI_SCAN_MAX
+#define DEVICECORE_WIFI_SCAN_MAX 16
+#endif
+
+namespace DeviceCore {
+
+struct ScannedNetwork {
+  char ssid[33];
+  uint8_t bssid[6];
+  int32_t channel;
+  int32_t rssi;
+  bool open;
+};
+
+// Results of the last background WiFi scan, strongest first. The radio is
+// only asked to scan again once the cached results are older than the
+// caller's limit, so connection selection, roaming and the portal can all
+// share one scan.
+class WifiScanCache {
+public:
+  static constexpr size_t kMaxResults = DEVICECORE_WIFI_SCAN_MAX;
+
+  WifiScanCache();
+
+  // Starts an async scan unless one is running or the cache is younger than
+  // maxAgeMs. Returns true when fresh results are already available.
+  bool request(unsigned long now, unsigned long maxAgeMs);
+  // Copies finished results in; call from the loop, not the SDK callback.
+  void poll(unsigned long now);
+
+  bool scanning() const { return _scanning; }
+  bool fresh(unsigned long now, unsigned long maxAgeMs) const;
+  unsigned long ageMs(unsigned long now) const;
+  size_t size() const { return _count; }
+  const ScannedNetwork& at(size_t index) const { return _results[index]; }
+  // Strongest access point for ssid, optionally skipping one BSSID.
+  const ScannedNetwork* strongest(const char* ssid, const uint8_t* excludeBssid = nullptr) const;
+
+private:
+  ScannedNetwork _results[kMaxResults];
+  size_t _count;
+  bool _valid;
+  bool _scanning;
+  volatile int _pendingCount;
+  unsigned long _completedMs;
+  unsigned long _startedMs;
+
+  void collect(int found, unsigned long now);
+  void insert(const ScannedNetwork& entry);
+};
+
+}  // namespace DeviceCore
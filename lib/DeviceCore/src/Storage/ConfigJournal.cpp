@@ -0,0 +1,286 @@
+#include "ConfigJournal.h"
+#include "../Core/Log.h"
+
+#include <EEPROM.h>
+#include <LittleFS.h>
+#include <cstddef>
+#include <cstring>
+#include "Crc32.h"
+
+namespace DeviceCore {
+
+namespace {
+constexpr char kJournalPath[] = "/cfg.jnl";
+constexpr char kJournalTempPath[] = "/cfg.jnl.new";
+constexpr uint32_t kRecordMagic = 0x314C4E4AUL;  // "JNL1"
+constexpr uint16_t kRecordVersion = 1;
+
+// Pre-journal EEPROM credential layout, read once for migration.
+constexpr size_t kLegacySsidLength = 32;
+constexpr size_t kLegacyPasswordLength = 64;
+constexpr size_t kLegacyEepromSize = 1 + kLegacySsidLength + kLegacyPasswordLength;
+constexpr uint8_t kLegacyCredentialMagic = 0xA5;
+
+struct JournalRecord {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t length;
+  uint32_t sequence;
+  PersistedConfig config;
+  uint32_t crc;
+};
+
+constexpr size_t kRecordSize = sizeof(JournalRecord);
+
+uint32_t recordCrc(const JournalRecord& record) {
+  return crc32(&record, offsetof(JournalRecord, crc));
+}
+
+size_t fileSize(const char* path) {
+  if (!LittleFS.exists(path)) {
+    return 0;
+  }
+  File file = LittleFS.open(path, "r");
+  if (!file) {
+    return 0;
+  }
+  size_t size = file.size();
+  file.close();
+  return size;
+}
+
+// Reads the newest valid record of the journal. Its offset comes straight
+// from the file length; earlier records are only looked at to step back past
+// a torn append. count receives the number of records up to and including it.
+bool readLastRecord(JournalRecord& out, size_t& count) {
+  count = fileSize(kJournalPath) / kRecordSize;
+  if (count == 0) {
+    return false;
+  }
+
+  File file = LittleFS.open(kJournalPath, "r");
+  if (!file) {
+    return false;
+  }
+
+  bool found = false;
+  while (count > 0 && !found) {
+    --count;
+    if (!file.seek(static_cast<uint32_t>(count * kRecordSize), SeekSet) ||
+        file.read(reinterpret_cast<uint8_t*>(&out), kRecordSize) != kRecordSize) {
+      continue;
+    }
+    found = out.magic == kRecordMagic && out.version == kRecordVersion &&
+            out.length == sizeof(out.config) && out.crc == recordCrc(out);
+  }
+  file.close();
+
+  if (found) {
+    ++count;
+  }
+  return found;
+}
+
+void terminate(RuntimeSettings& settings) {
+  settings.primaryTopic[RuntimeSettings::kMaxTopicLength] = '\0';
+  settings.serialTopic[RuntimeSettings::kMaxTopicLength] = '\0';
+}
+
+void terminate(StoredNetwork& network) {
+  network.ssid[sizeof(network.ssid) - 1] = '\0';
+  network.password[sizeof(network.password) - 1] = '\0';
+}
+
+void fillRecord(JournalRecord& record, const PersistedConfig& config, uint32_t sequence) {
+  // Zero the record, padding included, and copy the config in member by
+  // member: assigning whole structs would carry over the source's padding,
+  // and the CRC should only ever cover defined bytes.
+  uint8_t* raw = reinterpret_cast<uint8_t*>(&record);
+  for (size_t i = 0; i < sizeof(record); ++i) {
+    raw[i] = 0;
+  }
+  record.magic = kRecordMagic;
+  record.version = kRecordVersion;
+  record.length = sizeof(PersistedConfig);
+  record.sequence = sequence;
+  record.config.flags = config.flags;
+  record.config.networkCount = config.networkCount;
+  memcpy(record.config.networks, config.networks, sizeof(config.networks));
+  RuntimeSettings& settings = record.config.settings;
+  settings.heartbeatInterval = config.settings.heartbeatInterval;
+  settings.user1PulseDuration = config.settings.user1PulseDuration;
+  settings.errPulseDuration = config.settings.errPulseDuration;
+  settings.serialBufferLimit = config.settings.serialBufferLimit;
+  settings.serialBaud = config.settings.serialBaud;
+  settings.serialBatchMaxBytes = config.settings.serialBatchMaxBytes;
+  settings.serialBatchMaxLatencyMs = config.settings.serialBatchMaxLatencyMs;
+  memcpy(settings.primaryTopic, config.settings.primaryTopic, sizeof(settings.primaryTopic));
+  memcpy(settings.serialTopic, config.settings.serialTopic, sizeof(settings.serialTopic));
+  record.crc = recordCrc(record);
+}
+
+bool writeRecord(File& file, const PersistedConfig& config, uint32_t sequence) {
+  JournalRecord record;
+  fillRecord(record, config, sequence);
+  return file.write(reinterpret_cast<const uint8_t*>(&record), kRecordSize) == kRecordSize;
+}
+}  // namespace
+
+PersistedConfig::PersistedConfig() : flags(0), networkCount(0), settings() {
+  memset(networks, 0, sizeof(networks));
+}
+
+bool PersistedConfig::operator==(const PersistedConfig& other) const {
+  if (flags != other.flags || networkCount != other.networkCount) {
+    return false;
+  }
+  for (size_t i = 0; i < networkCount; ++i) {
+    if (strcmp(networks[i].ssid, other.networks[i].ssid) != 0 ||
+        strcmp(networks[i].password, other.networks[i].password) != 0) {
+      return false;
+    }
+  }
+  return !(flags & kHasSettings) || settings == other.settings;
+}
+
+ConfigJournal::ConfigJournal()
+    : _started(false),
+      _mounted(false),
+      _current(),
+      _sequence(0),
+      _records(0) {}
+
+bool ConfigJournal::begin() {
+  if (_started) {
+    return _mounted;
+  }
+  _started = true;
+  _mounted = LittleFS.begin();
+  if (!_mounted) {
+    DC_LOG_ERROR("Journal", "LittleFS mount failed, configuration will not persist.");
+    return false;
+  }
+
+  size_t size = fileSize(kJournalPath);
+  if (readLatest()) {
+    // A torn or corrupt tail would misalign later appends; rewrite it away.
+    if (size != _records * kRecordSize) {
+      compact(_current, _sequence);
+    }
+    return true;
+  }
+
+  if (size > 0) {
+    DC_LOG_INFO("Journal", "No valid record found, starting fresh.");
+    LittleFS.remove(kJournalPath);
+  }
+  _records = 0;
+  migrateLegacy();
+  return true;
+}
+
+bool ConfigJournal::readLatest() {
+  JournalRecord record;
+  size_t count = 0;
+  if (!readLastRecord(record, count)) {
+    return false;
+  }
+
+  _current = record.config;
+  if (_current.networkCount > PersistedConfig::kMaxNetworks) {
+    _current.networkCount = PersistedConfig::kMaxNetworks;
+  }
+  for (StoredNetwork& network : _current.networks) {
+    terminate(network);
+  }
+  terminate(_current.settings);
+  _sequence = record.sequence;
+  _records = count;
+  return true;
+}
+
+bool ConfigJournal::commit(const PersistedConfig& next) {
+  if (!begin()) {
+    return false;
+  }
+  if (_records > 0 && next == _current) {
+    return true;
+  }
+
+  uint32_t sequence = _sequence + 1;
+  bool ok = _records >= kMaxRecords ? compact(next, sequence) : append(next, sequence);
+  if (!ok) {
+    DC_LOG_ERROR("Journal", "Write failed.");
+    return false;
+  }
+  _current = next;
+  _sequence = sequence;
+  return true;
+}
+
+bool ConfigJournal::append(const PersistedConfig& config, uint32_t sequence) {
+  File file = LittleFS.open(kJournalPath, "a");
+  if (!file) {
+    return false;
+  }
+  bool ok = writeRecord(file, config, sequence);
+  file.close();
+  if (ok) {
+    ++_records;
+  }
+  return ok;
+}
+
+bool ConfigJournal::compact(const PersistedConfig& config, uint32_t sequence) {
+  File file = LittleFS.open(kJournalTempPath, "w");
+  if (!file) {
+    return false;
+  }
+  bool ok = writeRecord(file, config, sequence);
+  file.close();
+  if (!ok || !LittleFS.rename(kJournalTempPath, kJournalPath)) {
+    LittleFS.remove(kJournalTempPath);
+    return false;
+  }
+  _records = 1;
+  return true;
+}
+
+bool ConfigJournal::migrateLegacy() {
+  PersistedConfig migrated;
+
+  EEPROM.begin(kLegacyEepromSize);
+  bool legacyCredentials = EEPROM.read(0) == kLegacyCredentialMagic;
+  if (legacyCredentials) {
+    StoredNetwork& network = migrated.networks[0];
+    for (size_t i = 0; i < kLegacySsidLength; ++i) {
+      network.ssid[i] = static_cast<char>(EEPROM.read(1 + i));
+    }
+    for (size_t i = 0; i < kLegacyPasswordLength; ++i) {
+      network.password[i] = static_cast<char>(EEPROM.read(1 + kLegacySsidLength + i));
+    }
+    if (network.ssid[0] != '\0') {
+      migrated.networkCount = 1;
+    }
+  }
+
+  bool ok = true;
+  if (migrated.networkCount > 0) {
+    ok = commit(migrated);
+    if (ok) {
+      DC_LOG_INFO("Journal", "Migrated legacy configuration.");
+    } else {
+      DC_LOG_ERROR("Journal", "Legacy migration failed.");
+    }
+  }
+
+  // Only retire the old copy once the journal holds it.
+  if (ok && legacyCredentials) {
+    EEPROM.write(0, 0x00);
+    EEPROM.commit();
+  }
+  EEPROM.end();
+  return ok;
+}
+
+}  // namespace DeviceCore
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Arduino.h>
+#include "../Config/RuntimeSettings.h"
+
+namespace DeviceCore {
+
+#ifndef DEVICECORE_MAX_NETWORKS
+#define DEVICECORE_MAX_NETWORKS 4
+#endif
+
+struct StoredNetwork {
+  char ssid[33];
+  char password[65];
+};
+
+// Everything the device keeps across power cycles, written as one record.
+// Networks are kept in preference order, most recently used first.
+struct PersistedConfig {
+  static constexpr uint8_t kHasSettings = 0x02;
+  static constexpr size_t kMaxNetworks = DEVICECORE_MAX_NETWORKS;
+
+  PersistedConfig();
+
+  uint8_t flags;
+  uint8_t networkCount;
+  StoredNetwork networks[kMaxNetworks];
+  RuntimeSettings settings;
+
+  bool operator==(const PersistedConfig& other) const;
+};
+
+// Append-only journal of PersistedConfig records in LittleFS. Records are a
+// fixed size and carry a format version, sequence number and CRC32, so the
+// newest one sits at a position computed from the file length and a torn
+// append only ever costs the record being written. Once the journal holds
+// kMaxRecords it is compacted into a fresh file holding just the newest one.
+class ConfigJournal {
+public:
+  static constexpr size_t kMaxRecords = 16;
+
+  ConfigJournal();
+
+  bool begin();
+  const PersistedConfig& current() const { return _current; }
+  // Returns true without touching flash when next matches the stored record.
+  bool commit(const PersistedConfig& next);
+  uint32_t sequence() const { return _sequence; }
+
+private:
+  bool _started;
+  bool _mounted;
+  PersistedConfig _current;
+  uint32_t _sequence;
+  size_t _records;
+
+  bool readLatest();
+  bool append(const PersistedConfig& config, uint32_t sequence);
+  bool compact(const PersistedConfig& config, uint32_t sequence);
+  bool migrateLegacy();
+};
+
+}  // namespace DeviceCore
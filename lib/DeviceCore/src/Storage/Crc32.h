@@ -0,0 +1,25 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace DeviceCore {
+
+// Bitwise CRC-32 (IEEE 802.3, reflected). Used for the small records kept in
+// RTC memory and flash, where a lookup table would cost more RAM than it saves.
+inline uint32_t crc32Update(uint32_t crc, const void* data, size_t length) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  crc = ~crc;
+  while (length--) {
+    crc ^= *bytes++;
+    for (uint8_t bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1UL)));
+    }
+  }
+  return ~crc;
+}
+
+inline uint32_t crc32(const void* data, size_t length) {
+  return crc32Update(0, data, length);
+}
+
+}  // namespace DeviceCore
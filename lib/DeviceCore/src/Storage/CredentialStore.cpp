@@ -3,10 +3,13 @@
 namespace DeviceCore {
 
 namespace {
-constexpr size_t kMaxStoredSsidLength = 32;
-constexpr size_t kMaxStoredPasswordLength = 64;
-constexpr size_t kCredentialEepromSize = 1 + kMaxStoredSsidLength + kMaxStoredPasswordLength;
-constexpr uint8_t kCredentialMagic = 0xA5;
+void copyNetwork(StoredCredentials& out, const StoredNetwork& network) {
+  strncpy(out.ssid, network.ssid, sizeof(out.ssid) - 1);
+  out.ssid[sizeof(out.ssid) - 1] = '\0';
+  strncpy(out.password, network.password, sizeof(out.password) - 1);
+  out.password[sizeof(out.password) - 1] = '\0';
+  out.valid = (out.ssid[0] != '\0');
+}
 }  // namespace
 
 StoredCredentials::StoredCredentials() : valid(false) {
@@ -14,83 +17,129 @@ StoredCredentials::StoredCredentials() : valid(false) {
   password[0] = '\0';
 }
 
-CredentialStore::CredentialStore() : _initialized(false) {}
+StoredNetworks::StoredNetworks() : count(0) {}
+
+CredentialStore::CredentialStore(ConfigJournal& journal) : _journal(journal) {}
 
 bool CredentialStore::begin() {
-  if (_initialized) {
-    return true;
-  }
-  EEPROM.begin(kCredentialEepromSize);
-  _initialized = true;
-  return true;
+  return _journal.begin();
 }
 
 bool CredentialStore::load(StoredCredentials& out) {
+  out.valid = false;
   if (!begin()) {
-    out.valid = false;
     return false;
   }
 
-  uint8_t magic = EEPROM.read(0);
-  if (magic != kCredentialMagic) {
-    out.valid = false;
+  const PersistedConfig& stored = _journal.current();
+  if (stored.networkCount == 0) {
     return false;
   }
+  copyNetwork(out, stored.networks[0]);
+  return out.valid;
+}
 
-  for (size_t i = 0; i < kMaxStoredSsidLength; ++i) {
-    out.ssid[i] = static_cast<char>(EEPROM.read(1 + i));
+bool CredentialStore::loadAll(StoredNetworks& out) {
+  out.count = 0;
+  if (!begin()) {
+    return false;
   }
-  out.ssid[kMaxStoredSsidLength] = '\0';
 
-  for (size_t i = 0; i < kMaxStoredPasswordLength; ++i) {
-    out.password[i] = static_cast<char>(EEPROM.read(1 + kMaxStoredSsidLength + i));
+  const PersistedConfig& stored = _journal.current();
+  for (size_t i = 0; i < stored.networkCount; ++i) {
+    copyNetwork(out.entries[out.count], stored.networks[i]);
+    if (out.entries[out.count].valid) {
+      ++out.count;
+    }
   }
-  out.password[kMaxStoredPasswordLength] = '\0';
-
-  out.valid = (out.ssid[0] != '\0');
-  return out.valid;
+  return out.count > 0;
 }
 
 bool CredentialStore::save(const StoredCredentials& creds) {
-  if (!begin()) {
+  if (!begin() || creds.ssid[0] == '\0') {
     return false;
   }
 
-  EEPROM.write(0, kCredentialMagic);
-
-  size_t ssidLen = strlen(creds.ssid);
-  if (ssidLen > kMaxStoredSsidLength) {
-    ssidLen = kMaxStoredSsidLength;
+  PersistedConfig next = _journal.current();
+  int index = indexOf(next, creds.ssid);
+  if (index < 0) {
+    // Reuse the last slot; when the set is full that drops the least
+    // recently used network.
+    if (next.networkCount < PersistedConfig::kMaxNetworks) {
+      ++next.networkCount;
+    }
+    index = static_cast<int>(next.networkCount) - 1;
   }
 
-  for (size_t i = 0; i < kMaxStoredSsidLength; ++i) {
-    char ch = (i < ssidLen) ? creds.ssid[i] : '\0';
-    EEPROM.write(1 + i, ch);
+  StoredNetwork& network = next.networks[index];
+  memset(&network, 0, sizeof(network));
+  strncpy(network.ssid, creds.ssid, sizeof(network.ssid) - 1);
+  strncpy(network.password, creds.password, sizeof(network.password) - 1);
+  moveToFront(next, index);
+  return _journal.commit(next);
+}
+
+bool CredentialStore::promote(const char* ssid) {
+  if (!begin()) {
+    return false;
   }
 
-  size_t pwdLen = strlen(creds.password);
-  if (pwdLen > kMaxStoredPasswordLength) {
-    pwdLen = kMaxStoredPasswordLength;
+  PersistedConfig next = _journal.current();
+  int index = indexOf(next, ssid);
+  if (index <= 0) {
+    return index == 0;
   }
+  moveToFront(next, index);
+  return _journal.commit(next);
+}
 
-  for (size_t i = 0; i < kMaxStoredPasswordLength; ++i) {
-    char ch = (i < pwdLen) ? creds.password[i] : '\0';
-    EEPROM.write(1 + kMaxStoredSsidLength + i, ch);
+bool CredentialStore::remove(const char* ssid) {
+  if (!begin()) {
+    return false;
   }
 
-  EEPROM.commit();
-  return true;
+  PersistedConfig next = _journal.current();
+  int index = indexOf(next, ssid);
+  if (index < 0) {
+    return false;
+  }
+  for (size_t i = static_cast<size_t>(index); i + 1 < next.networkCount; ++i) {
+    next.networks[i] = next.networks[i + 1];
+  }
+  --next.networkCount;
+  memset(&next.networks[next.networkCount], 0, sizeof(StoredNetwork));
+  return _journal.commit(next);
 }
 
 void CredentialStore::clear() {
   if (!begin()) {
     return;
   }
-  EEPROM.write(0, 0x00);
-  for (size_t i = 0; i < kMaxStoredSsidLength + kMaxStoredPasswordLength; ++i) {
-    EEPROM.write(1 + i, 0x00);
+
+  PersistedConfig next = _journal.current();
+  memset(next.networks, 0, sizeof(next.networks));
+  next.networkCount = 0;
+  _journal.commit(next);
+}
+
+int CredentialStore::indexOf(const PersistedConfig& config, const char* ssid) {
+  if (!ssid) {
+    return -1;
+  }
+  for (size_t i = 0; i < config.networkCount; ++i) {
+    if (strcmp(config.networks[i].ssid, ssid) == 0) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+void CredentialStore::moveToFront(PersistedConfig& config, int index) {
+  StoredNetwork chosen = config.networks[index];
+  for (int i = index; i > 0; --i) {
+    config.networks[i] = config.networks[i - 1];
   }
-  EEPROM.commit();
+  config.networks[0] = chosen;
 }
 
 }  // namespace DeviceCore
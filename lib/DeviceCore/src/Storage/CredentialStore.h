@@ -1,7 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
-#include <EEPROM.h>
+#include "ConfigJournal.h"
 
 namespace DeviceCore {
 
@@ -12,17 +12,33 @@ struct StoredCredentials {
   bool valid;
 };
 
+struct StoredNetworks {
+  StoredNetworks();
+  StoredCredentials entries[PersistedConfig::kMaxNetworks];
+  size_t count;
+};
+
+// Known WiFi networks in preference order, kept in the shared configuration
+// journal. save() and promote() move a network to the front; when the set
+// is full the least recently used one is dropped.
 class CredentialStore {
 public:
-  CredentialStore();
+  explicit CredentialStore(ConfigJournal& journal);
 
   bool begin();
+  // Loads the preferred network.
   bool load(StoredCredentials& out);
+  bool loadAll(StoredNetworks& out);
   bool save(const StoredCredentials& creds);
+  bool promote(const char* ssid);
+  bool remove(const char* ssid);
   void clear();
 
 private:
-  bool _initialized;
+  ConfigJournal& _journal;
+
+  static int indexOf(const PersistedConfig& config, const char* ssid);
+  static void moveToFront(PersistedConfig& config, int index);
 };
 
 }  // namespace DeviceCore
@@ -0,0 +1,385 @@
+#include "OfflineQueue.h"
+#include "../Core/Log.h"
+#include <LittleFS.h>
+#include <cstring>
+
+namespace DeviceCore {
+
+namespace {
+constexpr const char* kQueueDir = "/fwdq";
+constexpr size_t kDefaultQueueBytes = 64UL * 1024UL;
+constexpr size_t kRecordHeaderSize = 2;
+constexpr unsigned long kPageFlushDelayMs = 2000UL;
+constexpr unsigned long kReplayRateWindowMs = 1000UL;
+}  // namespace
+
+OfflineQueue::OfflineQueue()
+    : _ready(false),
+      _maxSegments(0),
+      _segmentCount(0),
+      _nextSeq(0),
+      _pageLength(0),
+      _pageRecords(0),
+      _pageStartMs(0),
+      _readOffset(0),
+      _readRecords(0),
+      _peekedLength(0),
+      _dropped(0),
+      _replayed(0),
+      _replayWindowCount(0),
+      _replayWindowStartMs(0),
+      _replayRatePerSec(0) {}
+
+bool OfflineQueue::begin(size_t maxBytes) {
+  if (_ready) {
+    return true;
+  }
+  if (!LittleFS.begin()) {
+    DC_LOG_ERROR("OfflineQueue", "LittleFS mount failed, offline queue disabled.");
+    return false;
+  }
+  if (!LittleFS.exists(kQueueDir)) {
+    LittleFS.mkdir(kQueueDir);
+  }
+
+  size_t budget = maxBytes ? maxBytes : kDefaultQueueBytes;
+  _maxSegments = budget / kSegmentSize;
+  if (_maxSegments < 2) {
+    _maxSegments = 2;
+  }
+  if (_maxSegments > kMaxSegments) {
+    _maxSegments = kMaxSegments;
+  }
+
+  scanSegments();
+  _ready = true;
+
+  uint32_t pending = depth();
+  if (pending > 0) {
+    DC_LOG_INFO("OfflineQueue", "Recovered queued lines: %lu", static_cast<unsigned long>(pending));
+  }
+  return true;
+}
+
+void OfflineQueue::loop(unsigned long now) {
+  if (_pageLength > 0 && now - _pageStartMs >= kPageFlushDelayMs) {
+    flush();
+  }
+}
+
+unsigned long OfflineQueue::msUntilFlush(unsigned long now) const {
+  if (_pageLength == 0) {
+    return ~0UL;
+  }
+  unsigned long elapsed = now - _pageStartMs;
+  return elapsed >= kPageFlushDelayMs ? 0 : kPageFlushDelayMs - elapsed;
+}
+
+bool OfflineQueue::push(unsigned long now, const char* data, size_t length) {
+  if (!_ready || length == 0 || length > 0xFFFF) {
+    return false;
+  }
+
+  size_t recordSize = kRecordHeaderSize + length;
+  if (_pageLength + recordSize > kPageSize) {
+    flush();
+  }
+
+  if (recordSize > kPageSize) {
+    // Oversized lines bypass the staging page and go straight to flash.
+    uint8_t header[kRecordHeaderSize] = {static_cast<uint8_t>(length & 0xFF), static_cast<uint8_t>(length >> 8)};
+    return writeToSegment(header, kRecordHeaderSize, reinterpret_cast<const uint8_t*>(data), length, 1);
+  }
+
+  if (_pageLength == 0) {
+    _pageStartMs = now;
+  }
+  _page[_pageLength++] = static_cast<uint8_t>(length & 0xFF);
+  _page[_pageLength++] = static_cast<uint8_t>(length >> 8);
+  memcpy(_page + _pageLength, data, length);
+  _pageLength += length;
+  ++_pageRecords;
+  return true;
+}
+
+size_t OfflineQueue::peek(char* out, size_t capacity) {
+  if (!_ready) {
+    return 0;
+  }
+
+  while (true) {
+    if (_segmentCount == 0 || (_segmentCount == 1 && _readRecords >= _segments[0].records)) {
+      if (_pageLength == 0) {
+        return 0;
+      }
+      flush();
+    }
+    if (_segmentCount == 0) {
+      return 0;
+    }
+
+    Segment& oldest = _segments[0];
+    if (_readRecords >= oldest.records) {
+      retireOldestSegment();
+      continue;
+    }
+
+    if (!_reader) {
+      char path[32];
+      segmentPath(oldest.seq, path, sizeof(path));
+      _reader = LittleFS.open(path, "r");
+      if (!_reader || !_reader.seek(_readOffset, SeekSet)) {
+        retireOldestSegment();
+        continue;
+      }
+    }
+
+    uint8_t header[kRecordHeaderSize];
+    if (_reader.read(header, kRecordHeaderSize) != kRecordHeaderSize) {
+      retireOldestSegment();
+      continue;
+    }
+    size_t length = static_cast<size_t>(header[0]) | (static_cast<size_t>(header[1]) << 8);
+    if (length > capacity) {
+      // Cannot be delivered through the caller's buffer; skip it.
+      _reader.seek(length, SeekCur);
+      _readOffset += kRecordHeaderSize + length;
+      ++_readRecords;
+      ++_dropped;
+      continue;
+    }
+    if (_reader.read(reinterpret_cast<uint8_t*>(out), length) != length) {
+      retireOldestSegment();
+      continue;
+    }
+    _peekedLength = length;
+    // Rewind so a failed publish can peek the same record again.
+    _reader.seek(_readOffset, SeekSet);
+    return length;
+  }
+}
+
+void OfflineQueue::pop(unsigned long now) {
+  if (_peekedLength == 0 || _segmentCount == 0) {
+    return;
+  }
+  _readOffset += kRecordHeaderSize + _peekedLength;
+  ++_readRecords;
+  _peekedLength = 0;
+  if (_reader) {
+    _reader.seek(_readOffset, SeekSet);
+  }
+  if (_readRecords >= _segments[0].records && _segmentCount > 1) {
+    retireOldestSegment();
+  }
+
+  ++_replayed;
+  if (_replayWindowCount == 0) {
+    _replayWindowStartMs = now;
+  }
+  ++_replayWindowCount;
+  if (now - _replayWindowStartMs >= kReplayRateWindowMs) {
+    _replayRatePerSec = (_replayWindowCount * 1000UL) / (now - _replayWindowStartMs);
+    _replayWindowCount = 0;
+  }
+}
+
+void OfflineQueue::flush() {
+  if (_pageLength == 0) {
+    return;
+  }
+  writeToSegment(nullptr, 0, _page, _pageLength, _pageRecords);
+  _pageLength = 0;
+  _pageRecords = 0;
+}
+
+uint32_t OfflineQueue::depth() const {
+  uint32_t total = _pageRecords;
+  for (size_t i = 0; i < _segmentCount; ++i) {
+    total += _segments[i].records;
+  }
+  return total - (_segmentCount ? _readRecords : 0);
+}
+
+OfflineQueueStats OfflineQueue::stats() const {
+  OfflineQueueStats out;
+  out.depth = depth();
+  out.bytes = _pageLength;
+  for (size_t i = 0; i < _segmentCount; ++i) {
+    out.bytes += _segments[i].bytes;
+  }
+  if (_segmentCount) {
+    out.bytes -= _readOffset;
+  }
+  out.dropped = _dropped;
+  out.replayed = _replayed;
+  out.replayRatePerSec = _replayRatePerSec;
+  return out;
+}
+
+void OfflineQueue::scanSegments() {
+  _segmentCount = 0;
+  _nextSeq = 0;
+
+  Dir dir = LittleFS.openDir(kQueueDir);
+  while (dir.next()) {
+    String name = dir.fileName();
+    char* end = nullptr;
+    uint32_t seq = strtoul(name.c_str(), &end, 16);
+    if (!end || strcmp(end, ".log") != 0) {
+      continue;
+    }
+
+    char path[32];
+    segmentPath(seq, path, sizeof(path));
+    uint32_t validBytes = 0;
+    bool torn = false;
+    uint32_t records = scanRecords(path, validBytes, torn);
+    if (records == 0) {
+      LittleFS.remove(path);
+      continue;
+    }
+
+    // Insertion sort by sequence so replay stays in order.
+    size_t pos = _segmentCount;
+    while (pos > 0 && _segments[pos - 1].seq > seq) {
+      _segments[pos] = _segments[pos - 1];
+      --pos;
+    }
+    _segments[pos].seq = seq;
+    // Never append behind a record torn by power loss; the same seal the
+    // write-failure path applies.
+    _segments[pos].bytes = torn ? kSegmentSize : validBytes;
+    _segments[pos].records = records;
+    ++_segmentCount;
+    // Directory order is arbitrary, so trim only once the new segment is
+    // sorted in; the spare slot holds it until then.
+    if (_segmentCount > kMaxSegments) {
+      dropOldestSegment();
+    }
+
+    if (seq >= _nextSeq) {
+      _nextSeq = seq + 1;
+    }
+  }
+
+  while (_segmentCount > _maxSegments) {
+    dropOldestSegment();
+  }
+}
+
+uint32_t OfflineQueue::scanRecords(const char* path, uint32_t& validBytes, bool& torn) {
+  File file = LittleFS.open(path, "r");
+  if (!file) {
+    validBytes = 0;
+    torn = false;
+    return 0;
+  }
+
+  uint32_t size = file.size();
+  uint32_t offset = 0;
+  uint32_t records = 0;
+  uint8_t header[kRecordHeaderSize];
+  while (offset + kRecordHeaderSize <= size) {
+    if (file.read(header, kRecordHeaderSize) != kRecordHeaderSize) {
+      break;
+    }
+    uint32_t length = static_cast<uint32_t>(header[0]) | (static_cast<uint32_t>(header[1]) << 8);
+    // A record cut short by power loss ends the segment.
+    if (length == 0 || offset + kRecordHeaderSize + length > size) {
+      break;
+    }
+    file.seek(length, SeekCur);
+    offset += kRecordHeaderSize + length;
+    ++records;
+  }
+  file.close();
+  validBytes = offset;
+  torn = offset < size;
+  return records;
+}
+
+bool OfflineQueue::writeToSegment(const uint8_t* prefix,
+                                  size_t prefixLength,
+                                  const uint8_t* data,
+                                  size_t length,
+                                  uint32_t records) {
+  size_t total = prefixLength + length;
+  if (_segmentCount == 0 ||
+      (_segments[_segmentCount - 1].bytes > 0 && _segments[_segmentCount - 1].bytes + total > kSegmentSize)) {
+    if (!openNewSegment()) {
+      return false;
+    }
+  }
+
+  Segment& head = _segments[_segmentCount - 1];
+  char path[32];
+  segmentPath(head.seq, path, sizeof(path));
+  File file = LittleFS.open(path, "a");
+  if (!file) {
+    return false;
+  }
+  size_t written = prefixLength ? file.write(prefix, prefixLength) : 0;
+  written += file.write(data, length);
+  file.close();
+
+  if (_segmentCount == 1 && _reader) {
+    // The reader handle will not see data appended behind its back.
+    _reader.close();
+  }
+
+  if (written != total) {
+    // Never append behind a torn record; start a fresh segment next time.
+    head.bytes = kSegmentSize;
+    return false;
+  }
+  head.bytes += written;
+  head.records += records;
+  return true;
+}
+
+bool OfflineQueue::openNewSegment() {
+  while (_segmentCount >= _maxSegments) {
+    dropOldestSegment();
+  }
+  _segments[_segmentCount].seq = _nextSeq++;
+  _segments[_segmentCount].bytes = 0;
+  _segments[_segmentCount].records = 0;
+  ++_segmentCount;
+  return true;
+}
+
+void OfflineQueue::dropOldestSegment() {
+  if (_segmentCount == 0) {
+    return;
+  }
+  uint32_t lost = _segments[0].records - _readRecords;
+  _dropped += lost;
+  DC_LOG_WARN("OfflineQueue", "Budget exceeded, dropped oldest lines: %lu", static_cast<unsigned long>(lost));
+  retireOldestSegment();
+}
+
+void OfflineQueue::retireOldestSegment() {
+  if (_segmentCount == 0) {
+    return;
+  }
+  if (_reader) {
+    _reader.close();
+  }
+  char path[32];
+  segmentPath(_segments[0].seq, path, sizeof(path));
+  LittleFS.remove(path);
+  for (size_t i = 1; i < _segmentCount; ++i) {
+    _segments[i - 1] = _segments[i];
+  }
+  --_segmentCount;
+  _readOffset = 0;
+  _readRecords = 0;
+  _peekedLength = 0;
+}
+
+void OfflineQueue::segmentPath(uint32_t seq, char* out, size_t capacity) {
+  snprintf(out, capacity, "%s/%08lx.log", kQueueDir, static_cast<unsigned long>(seq));
+}
+
+}  // namespace DeviceCore
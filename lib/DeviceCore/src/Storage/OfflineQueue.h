@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+
+namespace DeviceCore {
+
+struct OfflineQueueStats {
+  uint32_t depth;
+  uint32_t bytes;
+  uint32_t dropped;
+  uint32_t replayed;
+  uint32_t replayRatePerSec;
+};
+
+// Append-only segment log on LittleFS used to hold serial lines while the
+// network is down. Records are staged in RAM and written a page at a time;
+// once the byte budget is exhausted the oldest segment is discarded.
+// Delivery is at-least-once: the read position inside the oldest segment is
+// not persisted, so a reboot may replay part of a segment again.
+class OfflineQueue {
+public:
+  static constexpr size_t kPageSize = 256;
+  static constexpr size_t kSegmentSize = 4096;
+  static constexpr size_t kMaxSegments = 64;
+
+  OfflineQueue();
+
+  bool begin(size_t maxBytes);
+  void loop(unsigned long now);
+
+  bool push(unsigned long now, const char* data, size_t length);
+  size_t peek(char* out, size_t capacity);
+  void pop(unsigned long now);
+  void flush();
+  unsigned long msUntilFlush(unsigned long now) const;
+
+  bool empty() const { return depth() == 0; }
+  uint32_t depth() const;
+  OfflineQueueStats stats() const;
+
+private:
+  struct Segment {
+    uint32_t seq;
+    uint32_t bytes;
+    uint32_t records;
+  };
+
+  bool _ready;
+  size_t _maxSegments;
+  // One spare slot: scanSegments() sorts a segment in before trimming.
+  Segment _segments[kMaxSegments + 1];
+  size_t _segmentCount;
+  uint32_t _nextSeq;
+
+  uint8_t _page[kPageSize];
+  size_t _pageLength;
+  uint32_t _pageRecords;
+  unsigned long _pageStartMs;
+
+  File _reader;
+  uint32_t _readOffset;
+  uint32_t _readRecords;
+  size_t _peekedLength;
+
+  uint32_t _dropped;
+  uint32_t _replayed;
+  uint32_t _replayWindowCount;
+  unsigned long _replayWindowStartMs;
+  uint32_t _replayRatePerSec;
+
+  void scanSegments();
+  uint32_t scanRecords(const char* path, uint32_t& validBytes, bool& torn);
+  bool writeToSegment(const uint8_t* prefix,
+                      size_t prefixLength,
+                      const uint8_t* data,
+                      size_t length,
+                      uint32_t records);
+  bool openNewSegment();
+  void dropOldestSegment();
+  void retireOldestSegment();
+  static void segmentPath(uint32_t seq, char* out, size_t capacity);
+};
+
+}  // namespace DeviceCore
@@ -0,0 +1,68 @@
+#include "RtcWifiCache.h"
+#include "Crc32.h"
+#include <cstring>
+
+namespace DeviceCore {
+
+namespace {
+// RTC user memory is addressed in 4-byte blocks; keep clear of the first
+// blocks in case the OTA updater uses them.
+constexpr uint32_t kRtcCacheOffsetBlocks = 32;
+constexpr uint32_t kRtcCacheMagic = 0x57464332UL;  // "WFC2"
+
+struct RtcRecord {
+  uint32_t crc;
+  uint32_t magic;
+  uint32_t credentialHash;
+  WifiFastConnect entry;
+};
+
+static_assert(sizeof(RtcRecord) % 4 == 0, "RTC record must be a whole number of blocks");
+
+uint32_t recordCrc(const RtcRecord& record) {
+  return crc32(reinterpret_cast<const uint8_t*>(&record) + sizeof(record.crc), sizeof(record) - sizeof(record.crc));
+}
+}  // namespace
+
+WifiFastConnect::WifiFastConnect() : channel(0) {
+  memset(bssid, 0, sizeof(bssid));
+}
+
+bool RtcWifiCache::load(const char* ssid, const char* password, WifiFastConnect& out) const {
+  RtcRecord record;
+  if (!ESP.rtcUserMemoryRead(kRtcCacheOffsetBlocks, reinterpret_cast<uint32_t*>(&record), sizeof(record))) {
+    return false;
+  }
+  if (record.magic != kRtcCacheMagic || record.crc != recordCrc(record)) {
+    return false;
+  }
+  if (record.credentialHash != credentialHash(ssid, password)) {
+    return false;
+  }
+  if (record.entry.channel <= 0) {
+    return false;
+  }
+  out = record.entry;
+  return true;
+}
+
+void RtcWifiCache::save(const char* ssid, const char* password, const WifiFastConnect& entry) {
+  RtcRecord record;
+  record.magic = kRtcCacheMagic;
+  record.credentialHash = credentialHash(ssid, password);
+  record.entry = entry;
+  record.crc = recordCrc(record);
+  ESP.rtcUserMemoryWrite(kRtcCacheOffsetBlocks, reinterpret_cast<uint32_t*>(&record), sizeof(record));
+}
+
+void RtcWifiCache::invalidate() {
+  uint32_t blank[sizeof(RtcRecord) / 4] = {0};
+  ESP.rtcUserMemoryWrite(kRtcCacheOffsetBlocks, blank, sizeof(blank));
+}
+
+uint32_t RtcWifiCache::credentialHash(const char* ssid, const char* password) {
+  uint32_t crc = crc32(ssid ? ssid : "", ssid ? strlen(ssid) : 0);
+  return crc32Update(crc, password ? password : "", password ? strlen(password) : 0);
+}
+
+}  // namespace DeviceCore
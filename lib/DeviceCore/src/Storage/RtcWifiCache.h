@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace DeviceCore {
+
+struct WifiFastConnect {
+  WifiFastConnect();
+  uint8_t bssid[6];
+  int32_t channel;
+};
+
+// Keeps the last good BSSID and channel in RTC user memory so a reset or
+// deep-sleep wake can skip the channel scan. The address still comes from
+// DHCP: a cached lease reused as a static IP would outlive the router's
+// lease. The entry is tied to the credentials it was learned with.
+class RtcWifiCache {
+public:
+  bool load(const char* ssid, const char* password, WifiFastConnect& out) const;
+  void save(const char* ssid, const char* password, const WifiFastConnect& entry);
+  void invalidate();
+
+private:
+  static uint32_t credentialHash(const char* ssid, const char* password);
+};
+
+}  // namespace DeviceCore
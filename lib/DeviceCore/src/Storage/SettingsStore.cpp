@@ -0,0 +1,42 @@
+#include "SettingsStore.h"
+
+namespace DeviceCore {
+
+SettingsStore::SettingsStore(ConfigJournal& journal) : _journal(journal) {}
+
+bool SettingsStore::load(RuntimeSettings& out) {
+  if (!_journal.begin()) {
+    return false;
+  }
+
+  const PersistedConfig& stored = _journal.current();
+  if (!(stored.flags & PersistedConfig::kHasSettings)) {
+    return false;
+  }
+  out = stored.settings;
+  return true;
+}
+
+bool SettingsStore::save(const RuntimeSettings& settings) {
+  if (!_journal.begin()) {
+    return false;
+  }
+
+  PersistedConfig next = _journal.current();
+  next.settings = settings;
+  next.flags |= PersistedConfig::kHasSettings;
+  return _journal.commit(next);
+}
+
+void SettingsStore::clear() {
+  if (!_journal.begin()) {
+    return;
+  }
+
+  PersistedConfig next = _journal.current();
+  next.settings = RuntimeSettings();
+  next.flags &= ~PersistedConfig::kHasSettings;
+  _journal.commit(next);
+}
+
+}  // namespace DeviceCore
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <Arduino.h>
+#include "../Config/RuntimeSettings.h"
+#include "ConfigJournal.h"
+
+namespace DeviceCore {
+
+// RuntimeSettings overrides, kept in the shared configuration journal next
+// to the credentials.
+class SettingsStore {
+public:
+  explicit SettingsStore(ConfigJournal& journal);
+
+  bool load(RuntimeSettings& out);
+  bool save(const RuntimeSettings& settings);
+  void clear();
+
+private:
+  ConfigJournal& _journal;
+};
+
+}  // namespace DeviceCore
@@ -0,0 +1,81 @@
+#include <Arduino.h>
+#include "NativeHal.h"
+#include "coredecls.h"
+
+namespace {
+constexpr uint8_t kPinCount = 17;
+
+uint8_t s_pinMode[kPinCount];
+uint8_t s_pinLevel[kPinCount];
+bool s_pinWritten[kPinCount];
+}  // namespace
+
+unsigned long millis() {
+  return static_cast<unsigned long>(NativeHal::clock().nowUs() / 1000ULL);
+}
+
+unsigned long micros() {
+  return static_cast<unsigned long>(NativeHal::clock().nowUs());
+}
+
+void delay(unsigned long ms) {
+  esp_delay(ms);
+}
+
+void esp_delay(unsigned long ms) {
+  esp_delay(static_cast<uint32_t>(ms), []() { return true; }, static_cast<uint32_t>(ms));
+}
+
+// Busy-waits on the device, so no timers run.
+void delayMicroseconds(unsigned int us) {
+  NativeHal::clock().sleepUs(us);
+}
+
+void yield() {
+  NativeHal::service();
+}
+
+// The device yields only once the loop has run for interval_us; on the host
+// servicing is cheap, so always do it.
+void optimistic_yield(uint32_t interval_us) {
+  NativeHal::service();
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < kPinCount) {
+    s_pinMode[pin] = mode;
+  }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin < kPinCount) {
+    s_pinLevel[pin] = value ? HIGH : LOW;
+    s_pinWritten[pin] = true;
+  }
+}
+
+// Nothing drives the inputs, so a pulled-up pin reads high (a button that is
+// never pressed) and an output reads back what was written.
+int digitalRead(uint8_t pin) {
+  if (pin >= kPinCount) {
+    return LOW;
+  }
+  if (!s_pinWritten[pin] && s_pinMode[pin] == INPUT_PULLUP) {
+    return HIGH;
+  }
+  return s_pinLevel[pin];
+}
+
+long random(long howbig) {
+  return howbig <= 0 ? 0 : ::random() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) {
+    srandom(static_cast<unsigned>(seed));
+  }
+}
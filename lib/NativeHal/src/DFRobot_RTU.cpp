@@ -0,0 +1,159 @@
+#include "DFRobot_RTU.h"
+
+namespace {
+constexpr int kNoDePin = -1;
+constexpr uint8_t kReadHolding = 0x03;
+constexpr uint8_t kReadInput = 0x04;
+constexpr uint8_t kWriteSingle = 0x06;
+constexpr uint8_t kWriteMultiple = 0x10;
+constexpr uint8_t kExceptionFlag = 0x80;
+constexpr uint16_t kMaxReadRegisters = 125;
+constexpr uint16_t kMaxWriteRegisters = 123;
+constexpr size_t kExceptionLength = 5;
+
+void putWord(uint8_t* out, uint16_t value) {
+  out[0] = static_cast<uint8_t>(value >> 8);
+  out[1] = static_cast<uint8_t>(value);
+}
+
+uint16_t getWord(const uint8_t* in) {
+  return static_cast<uint16_t>(in[0] << 8 | in[1]);
+}
+}  // namespace
+
+DFRobot_RTU::DFRobot_RTU(Stream* s, int dePin) : _stream(s), _dePin(dePin), _timeoutMs(100) {
+  pinMode(static_cast<uint8_t>(_dePin), OUTPUT);
+  digitalWrite(static_cast<uint8_t>(_dePin), LOW);
+}
+
+DFRobot_RTU::DFRobot_RTU(Stream* s) : _stream(s), _dePin(kNoDePin), _timeoutMs(100) {}
+
+uint8_t DFRobot_RTU::readHoldingRegister(uint8_t id, uint16_t reg, uint16_t* data, uint16_t regNum) {
+  return readRegisters(kReadHolding, id, reg, data, regNum);
+}
+
+uint8_t DFRobot_RTU::readInputRegister(uint8_t id, uint16_t reg, uint16_t* data, uint16_t regNum) {
+  return readRegisters(kReadInput, id, reg, data, regNum);
+}
+
+uint8_t DFRobot_RTU::writeHoldingRegister(uint8_t id, uint16_t reg, uint16_t* data, uint16_t regNum) {
+  if (!data || regNum == 0 || regNum > kMaxWriteRegisters) {
+    return eRTU_MEMORY_ERROR;
+  }
+  // Header, byte count, payload and CRC.
+  uint8_t request[7 + 2 * kMaxWriteRegisters + 2];
+  request[0] = id;
+  request[1] = kWriteMultiple;
+  putWord(request + 2, reg);
+  putWord(request + 4, regNum);
+  request[6] = static_cast<uint8_t>(regNum * 2);
+  for (uint16_t i = 0; i < regNum; ++i) {
+    putWord(request + 7 + 2 * i, data[i]);
+  }
+  return transact(request, 7 + 2 * regNum, 8);
+}
+
+uint8_t DFRobot_RTU::writeHoldingRegister(uint8_t id, uint16_t reg, uint16_t val) {
+  uint8_t request[8];
+  request[0] = id;
+  request[1] = kWriteSingle;
+  putWord(request + 2, reg);
+  putWord(request + 4, val);
+  return transact(request, 6, 8);
+}
+
+uint8_t DFRobot_RTU::readRegisters(uint8_t function, uint8_t id, uint16_t reg, uint16_t* data, uint16_t regNum) {
+  if (!data || regNum == 0 || regNum > kMaxReadRegisters) {
+    return eRTU_MEMORY_ERROR;
+  }
+  uint8_t request[8];
+  request[0] = id;
+  request[1] = function;
+  putWord(request + 2, reg);
+  putWord(request + 4, regNum);
+  uint8_t code = transact(request, 6, 5 + 2 * regNum);
+  if (code != eRTU_OK) {
+    return code;
+  }
+  if (_frame[2] != regNum * 2) {
+    return eRTU_RECV_ERROR;
+  }
+  for (uint16_t i = 0; i < regNum; ++i) {
+    data[i] = getWord(_frame + 3 + 2 * i);
+  }
+  return eRTU_OK;
+}
+
+uint8_t DFRobot_RTU::transact(uint8_t* request, size_t requestLength, size_t replyLength) {
+  send(request, requestLength);
+  if (request[0] == 0) {
+    // Broadcasts are never answered.
+    return eRTU_OK;
+  }
+
+  size_t received = receive(replyLength);
+  if (received < kExceptionLength || crc16(_frame, received) != 0) {
+    return eRTU_RECV_ERROR;
+  }
+  if (_frame[0] != request[0]) {
+    return eRTU_ID_ERROR;
+  }
+  if (_frame[1] == (request[1] | kExceptionFlag)) {
+    return _frame[2];
+  }
+  if (_frame[1] != request[1] || received != replyLength) {
+    return eRTU_RECV_ERROR;
+  }
+  return eRTU_OK;
+}
+
+void DFRobot_RTU::send(uint8_t* request, size_t length) {
+  while (_stream->available() > 0) {
+    _stream->read();
+  }
+  uint16_t crc = crc16(request, length);
+  request[length] = static_cast<uint8_t>(crc);
+  request[length + 1] = static_cast<uint8_t>(crc >> 8);
+
+  if (_dePin != kNoDePin) {
+    digitalWrite(static_cast<uint8_t>(_dePin), HIGH);
+  }
+  _stream->write(request, length + 2);
+  _stream->flush();
+  if (_dePin != kNoDePin) {
+    digitalWrite(static_cast<uint8_t>(_dePin), LOW);
+  }
+}
+
+size_t DFRobot_RTU::receive(size_t expected) {
+  size_t received = 0;
+  unsigned long startMs = millis();
+  while (received < expected && received < sizeof(_frame)) {
+    int value = _stream->read();
+    if (value >= 0) {
+      _frame[received++] = static_cast<uint8_t>(value);
+      // An exception reply is shorter than the one asked for.
+      if (received == kExceptionLength && (_frame[1] & kExceptionFlag)) {
+        break;
+      }
+      continue;
+    }
+    if (millis() - startMs >= _timeoutMs) {
+      break;
+    }
+    // Lets the clock, and with it a paced replay, move on.
+    delay(1);
+  }
+  return received;
+}
+
+uint16_t DFRobot_RTU::crc16(const uint8_t* data, size_t length) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < length; ++i) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 1) ? static_cast<uint16_t>((crc >> 1) ^ 0xA001) : static_cast<uint16_t>(crc >> 1);
+    }
+  }
+  return crc;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <Arduino.h>
+
+// A Modbus RTU master with DFRobot_RTU's interface and status codes, so
+// ModbusBus can run against a slave simulator on the UART's pseudo-terminal.
+// Only the function codes ModbusBus issues are implemented: 0x03, 0x04, 0x06
+// and 0x10.
+class DFRobot_RTU {
+public:
+  enum {
+    eRTU_OK = 0x00,
+    eRTU_RECV_ERROR = 0x08,
+    eRTU_MEMORY_ERROR = 0x09,
+    eRTU_ID_ERROR = 0x0A,
+  };
+
+  DFRobot_RTU(Stream* s, int dePin);
+  explicit DFRobot_RTU(Stream* s);
+
+  void setTimeoutTimeMs(uint32_t timeout) { _timeoutMs = timeout; }
+  uint8_t readHoldingRegister(uint8_t id, uint16_t reg, uint16_t* data, uint16_t regNum);
+  uint8_t readInputRegister(uint8_t id, uint16_t reg, uint16_t* data, uint16_t regNum);
+  uint8_t writeHoldingRegister(uint8_t id, uint16_t reg, uint16_t* data, uint16_t regNum);
+  uint8_t writeHoldingRegister(uint8_t id, uint16_t reg, uint16_t val);
+
+private:
+  static constexpr size_t kMaxFrame = 256;
+
+  Stream* _stream;
+  int _dePin;
+  uint32_t _timeoutMs;
+  uint8_t _frame[kMaxFrame];
+
+  uint8_t readRegisters(uint8_t function, uint8_t id, uint16_t reg, uint16_t* data, uint16_t regNum);
+  uint8_t transact(uint8_t* request, size_t requestLength, size_t replyLength);
+  void send(uint8_t* request, size_t length);
+  size_t receive(size_t expected);
+  static uint16_t crc16(const uint8_t* data, size_t length);
+};
@@ -0,0 +1,73 @@
+#include "EEPROM.h"
+#include <cstdio>
+#include <cstring>
+#include "NativeHal.h"
+
+EEPROMClass EEPROM;
+
+namespace {
+FILE* openImage(const char* mode) {
+  char path[256];
+  return fopen(NativeHal::statePath("eeprom.bin", path, sizeof(path)), mode);
+}
+}  // namespace
+
+EEPROMClass::EEPROMClass() : _size(0), _dirty(false) {
+  memset(_data, 0xFF, sizeof(_data));
+}
+
+void EEPROMClass::begin(size_t size) {
+  if (size == 0 || size > kSectorSize) {
+    return;
+  }
+  // Erased flash reads back as 0xFF; so does anything past the saved image.
+  memset(_data, 0xFF, sizeof(_data));
+  FILE* file = openImage("rb");
+  if (file) {
+    size_t loaded = fread(_data, 1, size, file);
+    (void)loaded;
+    fclose(file);
+  }
+  _size = size;
+  _dirty = false;
+}
+
+uint8_t EEPROMClass::read(int address) {
+  if (address < 0 || static_cast<size_t>(address) >= _size) {
+    return 0;
+  }
+  return _data[address];
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+  if (address < 0 || static_cast<size_t>(address) >= _size) {
+    return;
+  }
+  if (_data[address] != value) {
+    _data[address] = value;
+    _dirty = true;
+  }
+}
+
+bool EEPROMClass::commit() {
+  if (_size == 0) {
+    return false;
+  }
+  if (!_dirty) {
+    return true;
+  }
+  FILE* file = openImage("wb");
+  if (!file) {
+    return false;
+  }
+  bool ok = fwrite(_data, 1, _size, file) == _size;
+  ok = fclose(file) == 0 && ok;
+  _dirty = !ok;
+  return ok;
+}
+
+bool EEPROMClass::end() {
+  bool ok = commit();
+  _size = 0;
+  return ok;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Emulated flash sector kept in the state directory as eeprom.bin. As on the
+// device, writes land in a RAM copy and reach the file only on commit().
+class EEPROMClass {
+public:
+  EEPROMClass();
+
+  void begin(size_t size);
+  uint8_t read(int address);
+  void write(int address, uint8_t value);
+  bool commit();
+  bool end();
+  size_t length() const { return _size; }
+
+private:
+  static constexpr size_t kSectorSize = 4096;
+
+  uint8_t _data[kSectorSize];
+  size_t _size;
+  bool _dirty;
+};
+
+extern EEPROMClass EEPROM;
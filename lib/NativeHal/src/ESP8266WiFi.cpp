@@ -0,0 +1,220 @@
+#include "ESP8266WiFi.h"
+#include <cstring>
+
+namespace {
+// Long enough that callers really do see WL_DISCONNECTED and a running scan
+// for a few loop passes, short enough not to slow a test run.
+constexpr unsigned long kJoinMs = 100;
+constexpr unsigned long kScanMs = 300;
+constexpr uint8_t kChannel = 6;
+constexpr int8_t kRssi = -50;
+}  // namespace
+
+bss_info ESP8266WiFiClass::s_accessPoint = {{0x02, 0x00, 0x00, 0x00, 0x00, 0x01}, {0}, 0, kChannel, kRssi};
+
+ESP8266WiFiClass WiFi;
+
+ESP8266WiFiClass::ESP8266WiFiClass()
+    : _mode(WIFI_STA),
+      _status(WL_DISCONNECTED),
+      _joining(false),
+      _joinable(false),
+      _joinDueMs(0),
+      _scanning(false),
+      _scanDueMs(0),
+      _scanResult(WIFI_SCAN_FAILED) {
+  _ssid[0] = '\0';
+}
+
+void ESP8266WiFiClass::setAccessPoint(const char* ssid) {
+  size_t length = ssid ? strlen(ssid) : 0;
+  if (length > sizeof(s_accessPoint.ssid)) {
+    length = sizeof(s_accessPoint.ssid);
+  }
+  memset(s_accessPoint.ssid, 0, sizeof(s_accessPoint.ssid));
+  memcpy(s_accessPoint.ssid, ssid, length);
+  s_accessPoint.ssid_len = static_cast<uint8_t>(length);
+}
+
+bool ESP8266WiFiClass::mode(WiFiMode_t mode) {
+  _mode = mode;
+  return true;
+}
+
+bool ESP8266WiFiClass::softAP(const char*, const char*, int, int, int) {
+  _mode = _mode == WIFI_STA ? WIFI_AP_STA : _mode;
+  return true;
+}
+
+bool ESP8266WiFiClass::softAPdisconnect(bool) {
+  if (_mode == WIFI_AP_STA) {
+    _mode = WIFI_STA;
+  }
+  return true;
+}
+
+IPAddress ESP8266WiFiClass::softAPIP() {
+  return IPAddress(192, 168, 4, 1);
+}
+
+wl_status_t ESP8266WiFiClass::begin(const char* ssid, const char*, int32_t channel, const uint8_t* bssid, bool connect) {
+  snprintf(_ssid, sizeof(_ssid), "%s", ssid ? ssid : "");
+  _joinable = strlen(_ssid) == s_accessPoint.ssid_len && memcmp(_ssid, s_accessPoint.ssid, s_accessPoint.ssid_len) == 0 &&
+              (channel == 0 || channel == s_accessPoint.channel) &&
+              (!bssid || memcmp(bssid, s_accessPoint.bssid, sizeof(s_accessPoint.bssid)) == 0);
+  _status = WL_DISCONNECTED;
+  _joining = connect;
+  _joinDueMs = millis() + kJoinMs;
+  return _status;
+}
+
+bool ESP8266WiFiClass::disconnect(bool wifiOff) {
+  _joining = false;
+  _status = WL_DISCONNECTED;
+  if (wifiOff) {
+    _mode = WIFI_OFF;
+  }
+  return true;
+}
+
+bool ESP8266WiFiClass::reconnect() {
+  begin(_ssid);
+  return true;
+}
+
+bool ESP8266WiFiClass::config(IPAddress local, IPAddress gateway, IPAddress subnet, IPAddress dns1, IPAddress) {
+  // All zeroes is the core's way of going back to DHCP.
+  _staticIp = local;
+  _staticGateway = gateway;
+  _staticSubnet = subnet;
+  _staticDns = dns1;
+  return true;
+}
+
+IPAddress ESP8266WiFiClass::localIP() {
+  if (_status != WL_CONNECTED) {
+    return IPAddress();
+  }
+  return static_cast<uint32_t>(_staticIp) != 0 ? _staticIp : IPAddress(127, 0, 0, 1);
+}
+
+IPAddress ESP8266WiFiClass::gatewayIP() {
+  if (_status != WL_CONNECTED) {
+    return IPAddress();
+  }
+  return static_cast<uint32_t>(_staticGateway) != 0 ? _staticGateway : IPAddress(127, 0, 0, 1);
+}
+
+IPAddress ESP8266WiFiClass::subnetMask() {
+  if (_status != WL_CONNECTED) {
+    return IPAddress();
+  }
+  return static_cast<uint32_t>(_staticSubnet) != 0 ? _staticSubnet : IPAddress(255, 0, 0, 0);
+}
+
+IPAddress ESP8266WiFiClass::dnsIP(uint8_t index) {
+  if (_status != WL_CONNECTED || index > 0) {
+    return IPAddress();
+  }
+  return static_cast<uint32_t>(_staticDns) != 0 ? _staticDns : IPAddress(127, 0, 0, 1);
+}
+
+int32_t ESP8266WiFiClass::RSSI() {
+  return _status == WL_CONNECTED ? s_accessPoint.rssi : 31;
+}
+
+uint8_t* ESP8266WiFiClass::BSSID() {
+  return _status == WL_CONNECTED ? s_accessPoint.bssid : nullptr;
+}
+
+int32_t ESP8266WiFiClass::channel() {
+  return _status == WL_CONNECTED ? s_accessPoint.channel : 0;
+}
+
+String ESP8266WiFiClass::SSID() const {
+  return _status == WL_CONNECTED ? String(_ssid) : String();
+}
+
+int8_t ESP8266WiFiClass::scanNetworks(bool async, bool) {
+  if (async) {
+    scanNetworksAsync(nullptr);
+    return WIFI_SCAN_RUNNING;
+  }
+  _scanning = false;
+  _scanResult = 1;
+  return _scanResult;
+}
+
+void ESP8266WiFiClass::scanNetworksAsync(std::function<void(int)> onComplete, bool) {
+  _scanCallback = onComplete;
+  _scanning = true;
+  _scanDueMs = millis() + kScanMs;
+  _scanResult = WIFI_SCAN_RUNNING;
+}
+
+void ESP8266WiFiClass::scanDelete() {
+  _scanResult = WIFI_SCAN_FAILED;
+}
+
+String ESP8266WiFiClass::SSID(uint8_t index) const {
+  if (!validIndex(index)) {
+    return String();
+  }
+  char ssid[sizeof(s_accessPoint.ssid) + 1];
+  memcpy(ssid, s_accessPoint.ssid, s_accessPoint.ssid_len);
+  ssid[s_accessPoint.ssid_len] = '\0';
+  return String(ssid);
+}
+
+int32_t ESP8266WiFiClass::RSSI(uint8_t index) {
+  return validIndex(index) ? s_accessPoint.rssi : 0;
+}
+
+uint8_t* ESP8266WiFiClass::BSSID(uint8_t index) {
+  return validIndex(index) ? s_accessPoint.bssid : nullptr;
+}
+
+int32_t ESP8266WiFiClass::channel(uint8_t index) {
+  return validIndex(index) ? s_accessPoint.channel : 0;
+}
+
+uint8_t ESP8266WiFiClass::encryptionType(uint8_t index) {
+  return validIndex(index) ? ENC_TYPE_CCMP : static_cast<uint8_t>(-1);
+}
+
+bool ESP8266WiFiClass::isHidden(uint8_t index) {
+  return validIndex(index) && s_accessPoint.ssid_len == 0;
+}
+
+bss_info* ESP8266WiFiClass::getScanInfoByIndex(int index) {
+  return index >= 0 && WiFi.validIndex(static_cast<uint8_t>(index)) ? &s_accessPoint : nullptr;
+}
+
+unsigned long ESP8266WiFiClass::msUntilEvent(unsigned long now) const {
+  unsigned long wait = ~0UL;
+  if (_joining) {
+    wait = static_cast<long>(_joinDueMs - now) > 0 ? _joinDueMs - now : 0;
+  }
+  if (_scanning) {
+    unsigned long scanWait = static_cast<long>(_scanDueMs - now) > 0 ? _scanDueMs - now : 0;
+    wait = scanWait < wait ? scanWait : wait;
+  }
+  return wait;
+}
+
+void ESP8266WiFiClass::service(unsigned long now) {
+  if (_joining && static_cast<long>(now - _joinDueMs) >= 0) {
+    _joining = false;
+    _status = _joinable ? WL_CONNECTED : WL_NO_SSID_AVAIL;
+  }
+  if (_scanning && static_cast<long>(now - _scanDueMs) >= 0) {
+    _scanning = false;
+    _scanResult = 1;
+    // Delivered from the loop thread, as the SDK's own callback would be.
+    std::function<void(int)> callback = _scanCallback;
+    _scanCallback = nullptr;
+    if (callback) {
+      callback(_scanResult);
+    }
+  }
+}
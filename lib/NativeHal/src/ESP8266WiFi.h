@@ -0,0 +1,114 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include "WiFiClient.h"
+
+enum wl_status_t {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_WRONG_PASSWORD = 6,
+  WL_DISCONNECTED = 7,
+};
+
+enum WiFiMode_t {
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+  WIFI_AP = 2,
+  WIFI_AP_STA = 3,
+};
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+
+#define ENC_TYPE_TKIP 2
+#define ENC_TYPE_CCMP 4
+#define ENC_TYPE_WEP 5
+#define ENC_TYPE_NONE 7
+#define ENC_TYPE_AUTO 8
+
+// The fields of the SDK scan record that callers read.
+struct bss_info {
+  uint8_t bssid[6];
+  uint8_t ssid[32];
+  uint8_t ssid_len;
+  uint8_t channel;
+  int8_t rssi;
+};
+
+// A radio that can see one access point, named by DEVICECORE_NATIVE_SSID.
+// Joining it and scanning for it complete after a short delay on the HAL
+// clock; once "associated", the station's address is loopback and traffic
+// goes through the host's own network stack.
+class ESP8266WiFiClass {
+public:
+  ESP8266WiFiClass();
+
+  bool mode(WiFiMode_t mode);
+  WiFiMode_t getMode() const { return _mode; }
+  bool softAP(const char* ssid, const char* passphrase = nullptr, int channel = 1, int hidden = 0, int maxConnections = 4);
+  bool softAPdisconnect(bool wifiOff = false);
+  IPAddress softAPIP();
+
+  wl_status_t begin(const char* ssid, const char* passphrase = nullptr, int32_t channel = 0, const uint8_t* bssid = nullptr,
+                    bool connect = true);
+  bool disconnect(bool wifiOff = false);
+  bool reconnect();
+  wl_status_t status() const { return _status; }
+  bool config(IPAddress local, IPAddress gateway, IPAddress subnet, IPAddress dns1 = IPAddress(), IPAddress dns2 = IPAddress());
+  IPAddress localIP();
+  IPAddress gatewayIP();
+  IPAddress subnetMask();
+  IPAddress dnsIP(uint8_t index = 0);
+  int32_t RSSI();
+  uint8_t* BSSID();
+  int32_t channel();
+  String SSID() const;
+
+  int8_t scanNetworks(bool async = false, bool showHidden = false);
+  void scanNetworksAsync(std::function<void(int)> onComplete, bool showHidden = false);
+  int8_t scanComplete() const { return _scanResult; }
+  void scanDelete();
+  String SSID(uint8_t index) const;
+  int32_t RSSI(uint8_t index);
+  uint8_t* BSSID(uint8_t index);
+  int32_t channel(uint8_t index);
+  uint8_t encryptionType(uint8_t index);
+  bool isHidden(uint8_t index);
+  static bss_info* getScanInfoByIndex(int index);
+
+  bool setAutoReconnect(bool) { return true; }
+  bool setAutoConnect(bool) { return true; }
+  bool persistent(bool) { return true; }
+
+  // Host side, driven by NativeHal.
+  void setAccessPoint(const char* ssid);
+  unsigned long msUntilEvent(unsigned long now) const;
+  void service(unsigned long now);
+
+private:
+  static bss_info s_accessPoint;
+
+  WiFiMode_t _mode;
+  wl_status_t _status;
+  bool _joining;
+  bool _joinable;
+  unsigned long _joinDueMs;
+  bool _scanning;
+  unsigned long _scanDueMs;
+  int8_t _scanResult;
+  std::function<void(int)> _scanCallback;
+  IPAddress _staticIp;
+  IPAddress _staticGateway;
+  IPAddress _staticSubnet;
+  IPAddress _staticDns;
+  char _ssid[33];
+
+  bool validIndex(uint8_t index) const { return _scanResult > 0 && index < _scanResult; }
+};
+
+extern ESP8266WiFiClass WiFi;
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <Arduino.h>
+
+// The portal's captive DNS responder; inert on the host, where the portal is
+// reached by address on DEVICECORE_NATIVE_HTTP_PORT.
+
+enum class AsyncDNSReplyCode : unsigned char {
+  NoError = 0,
+  FormError = 1,
+  ServerFailure = 2,
+  NonExistentDomain = 3,
+  NotImplemented = 4,
+  Refused = 5,
+};
+
+class AsyncDNSServer {
+public:
+  bool start(uint16_t, const String&, const IPAddress&) { return true; }
+  void stop() {}
+  void setErrorReplyCode(const AsyncDNSReplyCode&) {}
+  void setTTL(uint32_t) {}
+};
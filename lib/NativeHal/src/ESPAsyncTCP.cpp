@@ -0,0 +1,210 @@
+#include "ESPAsyncTCP.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+// lwIP's err_t values for the failures a host socket can report.
+constexpr int8_t kErrAborted = -13;
+constexpr int8_t kErrReset = -14;
+// tcp_sndbuf() of an idle connection; the host socket buffers far more.
+constexpr size_t kSendBuffer = 2 * 1460;
+}  // namespace
+
+AsyncClient* AsyncClient::s_first = nullptr;
+
+AsyncClient::AsyncClient()
+    : _next(s_first),
+      _fd(-1),
+      _state(State::Closed),
+      _unacked(0),
+      _ackNow(true),
+      _connectArg(nullptr),
+      _disconnectArg(nullptr),
+      _errorArg(nullptr),
+      _dataArg(nullptr) {
+  s_first = this;
+}
+
+AsyncClient::~AsyncClient() {
+  release();
+  for (AsyncClient** link = &s_first; *link; link = &(*link)->_next) {
+    if (*link == this) {
+      *link = _next;
+      break;
+    }
+  }
+}
+
+bool AsyncClient::connect(IPAddress ip, uint16_t port) {
+  if (_fd >= 0) {
+    return false;
+  }
+  _fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (_fd < 0) {
+    return false;
+  }
+
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = static_cast<uint32_t>(ip);
+  if (::connect(_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 && errno != EINPROGRESS) {
+    release();
+    return false;
+  }
+  // Even an immediate connect is reported from service(), as lwIP does.
+  _state = State::Connecting;
+  _unacked = 0;
+  return true;
+}
+
+bool AsyncClient::connect(const char* host, uint16_t port) {
+  IPAddress ip;
+  if (host && ip.fromString(host)) {
+    return connect(ip, port);
+  }
+
+  addrinfo hints = {};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* results = nullptr;
+  if (!host || getaddrinfo(host, nullptr, &hints, &results) != 0 || !results) {
+    return false;
+  }
+  ip = IPAddress(static_cast<uint32_t>(reinterpret_cast<sockaddr_in*>(results->ai_addr)->sin_addr.s_addr));
+  freeaddrinfo(results);
+  return connect(ip, port);
+}
+
+void AsyncClient::close(bool now) {
+  if (_fd < 0) {
+    return;
+  }
+  release();
+  if (_disconnectCb) {
+    _disconnectCb(_disconnectArg, this);
+  }
+}
+
+size_t AsyncClient::space() {
+  return _state == State::Connected ? kSendBuffer : 0;
+}
+
+size_t AsyncClient::add(const char* data, size_t size, uint8_t apiflags) {
+  if (_state != State::Connected) {
+    return 0;
+  }
+  ssize_t result = ::send(_fd, data, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+  // A failed socket is noticed and reported by the next service().
+  return result > 0 ? static_cast<size_t>(result) : 0;
+}
+
+size_t AsyncClient::ack(size_t len) {
+  if (len > _unacked) {
+    len = _unacked;
+  }
+  _unacked -= len;
+  return len;
+}
+
+void AsyncClient::setNoDelay(bool nodelay) {
+  if (_fd >= 0) {
+    int flag = nodelay ? 1 : 0;
+    setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+  }
+}
+
+void AsyncClient::onConnect(AcConnectHandler cb, void* arg) {
+  _connectCb = cb;
+  _connectArg = arg;
+}
+
+void AsyncClient::onDisconnect(AcConnectHandler cb, void* arg) {
+  _disconnectCb = cb;
+  _disconnectArg = arg;
+}
+
+void AsyncClient::onError(AcErrorHandler cb, void* arg) {
+  _errorCb = cb;
+  _errorArg = arg;
+}
+
+void AsyncClient::onData(AcDataHandler cb, void* arg) {
+  _dataCb = cb;
+  _dataArg = arg;
+}
+
+void AsyncClient::serviceAll() {
+  for (AsyncClient* client = s_first; client; client = client->_next) {
+    client->service();
+  }
+}
+
+void AsyncClient::service() {
+  if (_state == State::Connecting) {
+    pollfd entry = {_fd, POLLOUT, 0};
+    if (poll(&entry, 1, 0) <= 0) {
+      return;
+    }
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (getsockopt(_fd, SOL_SOCKET, SO_ERROR, &error, &length) != 0 || error != 0) {
+      fail(error == ECONNREFUSED ? kErrReset : kErrAborted);
+      return;
+    }
+    _state = State::Connected;
+    if (_connectCb) {
+      _connectCb(_connectArg, this);
+    }
+  }
+
+  if (_state != State::Connected || _unacked >= kWindow) {
+    return;
+  }
+  uint8_t buffer[kWindow];
+  ssize_t received = recv(_fd, buffer, kWindow - _unacked, MSG_DONTWAIT);
+  if (received == 0) {
+    close(true);
+    return;
+  }
+  if (received < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+      fail(errno == ECONNRESET ? kErrReset : kErrAborted);
+    }
+    return;
+  }
+  size_t count = static_cast<size_t>(received);
+  _unacked += count;
+  _ackNow = true;
+  if (_dataCb) {
+    _dataCb(_dataArg, this, buffer, count);
+  }
+  if (_ackNow) {
+    ack(count);
+  }
+}
+
+void AsyncClient::release() {
+  if (_fd >= 0) {
+    ::close(_fd);
+    _fd = -1;
+  }
+  _state = State::Closed;
+  _unacked = 0;
+}
+
+void AsyncClient::fail(int8_t error) {
+  release();
+  if (_errorCb) {
+    _errorCb(_errorArg, this, error);
+  }
+  if (_disconnectCb) {
+    _disconnectCb(_disconnectArg, this);
+  }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+
+#define ASYNC_WRITE_FLAG_COPY 0x01
+#define ASYNC_WRITE_FLAG_MORE 0x02
+
+class AsyncClient;
+
+typedef std::function<void(void*, AsyncClient*)> AcConnectHandler;
+typedef std::function<void(void*, AsyncClient*, int8_t error)> AcErrorHandler;
+typedef std::function<void(void*, AsyncClient*, void* data, size_t len)> AcDataHandler;
+
+// ESPAsyncTCP's client on a non-blocking host socket. The handshake,
+// incoming data and the peer's close are picked up in NativeHal::service(),
+// where the callbacks run as lwIP's do when the SDK gets the CPU. Names go
+// through the host resolver, so connect() returns only after the lookup and
+// fails at once if it does. As in lwIP, nothing more is read while kWindow
+// bytes handed to onData() after ackLater() still wait on ack().
+class AsyncClient {
+public:
+  // TCP_WND of the core's default low-memory lwIP build.
+  static constexpr size_t kWindow = 2144;
+
+  AsyncClient();
+  ~AsyncClient();
+  AsyncClient(const AsyncClient&) = delete;
+  AsyncClient& operator=(const AsyncClient&) = delete;
+
+  bool connect(IPAddress ip, uint16_t port);
+  bool connect(const char* host, uint16_t port);
+  void close(bool now = false);
+  void abort() { close(true); }
+  bool connecting() { return _state == State::Connecting; }
+  bool connected() { return _state == State::Connected; }
+  size_t space();
+  size_t add(const char* data, size_t size, uint8_t apiflags = 0);
+  bool send() { return connected(); }
+  size_t write(const char* data, size_t size) { return add(data, size); }
+  size_t ack(size_t len);
+  void ackLater() { _ackNow = false; }
+  void setNoDelay(bool nodelay);
+
+  void onConnect(AcConnectHandler cb, void* arg = nullptr);
+  void onDisconnect(AcConnectHandler cb, void* arg = nullptr);
+  void onError(AcErrorHandler cb, void* arg = nullptr);
+  void onData(AcDataHandler cb, void* arg = nullptr);
+
+  // Host side, driven by NativeHal.
+  static void serviceAll();
+
+private:
+  enum class State : uint8_t {
+    Closed,
+    Connecting,
+    Connected,
+  };
+
+  static AsyncClient* s_first;
+
+  AsyncClient* _next;
+  int _fd;
+  State _state;
+  size_t _unacked;
+  bool _ackNow;
+  AcConnectHandler _connectCb;
+  void* _connectArg;
+  AcConnectHandler _disconnectCb;
+  void* _disconnectArg;
+  AcErrorHandler _errorCb;
+  void* _errorArg;
+  AcDataHandler _dataCb;
+  void* _dataArg;
+
+  void service();
+  void release();
+  void fail(int8_t error);
+};
@@ -0,0 +1,411 @@
+#include "ESPAsyncWebServer.h"
+#include "NativeHal.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <netinet/in.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+constexpr int kListenBacklog = 16;
+
+const char* reasonPhrase(int code) {
+  switch (code) {
+    case 200:
+      return "OK";
+    case 202:
+      return "Accepted";
+    case 302:
+      return "Found";
+    case 304:
+      return "Not Modified";
+    case 400:
+      return "Bad Request";
+    case 404:
+      return "Not Found";
+    case 409:
+      return "Conflict";
+    case 413:
+      return "Payload Too Large";
+    case 431:
+      return "Request Header Fields Too Large";
+    case 503:
+      return "Service Unavailable";
+    default:
+      return "";
+  }
+}
+
+int hexValue(char ch) {
+  if (ch >= '0' && ch <= '9') {
+    return ch - '0';
+  }
+  if (ch >= 'a' && ch <= 'f') {
+    return ch - 'a' + 10;
+  }
+  if (ch >= 'A' && ch <= 'F') {
+    return ch - 'A' + 10;
+  }
+  return -1;
+}
+
+String urlDecode(const char* text, size_t length) {
+  std::string out;
+  for (size_t i = 0; i < length; ++i) {
+    if (text[i] == '+') {
+      out += ' ';
+    } else if (text[i] == '%' && i + 2 < length && hexValue(text[i + 1]) >= 0 && hexValue(text[i + 2]) >= 0) {
+      out += static_cast<char>(hexValue(text[i + 1]) * 16 + hexValue(text[i + 2]));
+      i += 2;
+    } else {
+      out += text[i];
+    }
+  }
+  return String(out.c_str());
+}
+
+// Splits name=value pairs separated by '&'.
+void parseParams(const char* text, size_t length, bool post, std::vector<AsyncWebParameter>& out) {
+  const char* end = text + length;
+  while (text < end) {
+    const char* pair = text;
+    const char* next = static_cast<const char*>(memchr(pair, '&', end - pair));
+    const char* pairEnd = next ? next : end;
+    const char* equals = static_cast<const char*>(memchr(pair, '=', pairEnd - pair));
+    if (pairEnd > pair) {
+      const char* nameEnd = equals ? equals : pairEnd;
+      const char* value = equals ? equals + 1 : pairEnd;
+      out.emplace_back(urlDecode(pair, nameEnd - pair), urlDecode(value, pairEnd - value), post);
+    }
+    text = next ? next + 1 : end;
+  }
+}
+
+const char* find(const char* data, const char* end, const char* text) {
+  return static_cast<const char*>(memmem(data, end - data, text, strlen(text)));
+}
+}  // namespace
+
+AsyncWebServerResponse::AsyncWebServerResponse(int code, const String& contentType, const char* content, size_t length)
+    : _code(code), _contentType(contentType), _content(content ? content : "", content ? length : 0) {}
+
+void AsyncWebServerResponse::addHeader(const String& name, const String& value) {
+  _headers.emplace_back(name, value);
+}
+
+std::string AsyncWebServerResponse::render() const {
+  char line[96];
+  snprintf(line, sizeof(line), "HTTP/1.1 %d %s\r\n", _code, reasonPhrase(_code));
+  std::string out = line;
+  if (_contentType.length() > 0) {
+    out += "Content-Type: ";
+    out += _contentType.c_str();
+    out += "\r\n";
+  }
+  for (const AsyncWebHeader& header : _headers) {
+    out += header.name().c_str();
+    out += ": ";
+    out += header.value().c_str();
+    out += "\r\n";
+  }
+  snprintf(line, sizeof(line), "Content-Length: %zu\r\nConnection: close\r\n\r\n", _content.size());
+  out += line;
+  out += _content;
+  return out;
+}
+
+size_t AsyncResponseStream::write(const uint8_t* buffer, size_t size) {
+  _content.append(reinterpret_cast<const char*>(buffer), size);
+  return size;
+}
+
+AsyncWebHeader* AsyncWebServerRequest::getHeader(const char* name) const {
+  for (AsyncWebHeader& header : _headers) {
+    if (strcasecmp(header.name().c_str(), name) == 0) {
+      return &header;
+    }
+  }
+  return nullptr;
+}
+
+AsyncWebParameter* AsyncWebServerRequest::getParam(const char* name, bool post) const {
+  for (AsyncWebParameter& param : _params) {
+    if (param.isPost() == post && param.name() == name) {
+      return &param;
+    }
+  }
+  return nullptr;
+}
+
+void AsyncWebServerRequest::send(int code, const char* contentType, const String& content) {
+  send(beginResponse(code, contentType ? String(contentType) : String(), content));
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse* response) {
+  // Only the first response counts.
+  if (_response) {
+    delete response;
+    return;
+  }
+  _response.reset(response);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const String& contentType, const String& content) {
+  return new AsyncWebServerResponse(code, contentType, content.c_str(), content.length());
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse_P(int code,
+                                                               const String& contentType,
+                                                               const uint8_t* content,
+                                                               size_t length) {
+  return new AsyncWebServerResponse(code, contentType, reinterpret_cast<const char*>(content), length);
+}
+
+AsyncResponseStream* AsyncWebServerRequest::beginResponseStream(const String& contentType, size_t bufferSize) {
+  return new AsyncResponseStream(contentType);
+}
+
+void AsyncWebServerRequest::redirect(const char* url) {
+  AsyncWebServerResponse* response = beginResponse(302);
+  response->addHeader("Location", url);
+  send(response);
+}
+
+AsyncWebServer* AsyncWebServer::s_first = nullptr;
+
+AsyncWebServer::AsyncWebServer(uint16_t port) : _next(s_first), _fd(-1) {
+  for (Connection& connection : _connections) {
+    connection.fd = -1;
+    connection.received = 0;
+    connection.sent = 0;
+  }
+  s_first = this;
+}
+
+AsyncWebServer::~AsyncWebServer() {
+  end();
+  for (AsyncWebServer** link = &s_first; *link; link = &(*link)->_next) {
+    if (*link == this) {
+      *link = _next;
+      break;
+    }
+  }
+}
+
+AsyncCallbackWebHandler& AsyncWebServer::on(const char* uri, int method, ArRequestHandlerFunction handler) {
+  _routes.push_back(Route{String(uri), method, handler});
+  return _handler;
+}
+
+void AsyncWebServer::begin() {
+  if (_fd >= 0) {
+    return;
+  }
+  _fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  int reuse = 1;
+  setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(NativeHal::httpPort());
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (_fd < 0 || bind(_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(_fd, kListenBacklog) != 0) {
+    fprintf(stderr, "NativeHal: portal cannot listen on port %u: %s\n", NativeHal::httpPort(), strerror(errno));
+    if (_fd >= 0) {
+      ::close(_fd);
+      _fd = -1;
+    }
+    return;
+  }
+  socklen_t length = sizeof(address);
+  getsockname(_fd, reinterpret_cast<sockaddr*>(&address), &length);
+  fprintf(stderr, "NativeHal: portal on http://127.0.0.1:%u/\n", ntohs(address.sin_port));
+}
+
+void AsyncWebServer::end() {
+  for (Connection& connection : _connections) {
+    close(connection);
+  }
+  if (_fd >= 0) {
+    ::close(_fd);
+    _fd = -1;
+  }
+}
+
+void AsyncWebServer::reset() {
+  _routes.clear();
+  _notFound = nullptr;
+}
+
+void AsyncWebServer::serviceAll() {
+  for (AsyncWebServer* server = s_first; server; server = server->_next) {
+    server->service();
+  }
+}
+
+void AsyncWebServer::service() {
+  if (_fd < 0) {
+    return;
+  }
+  accept();
+  for (Connection& connection : _connections) {
+    if (connection.fd < 0) {
+      continue;
+    }
+    if (connection.pending) {
+      transmit(connection);
+    } else {
+      receive(connection);
+    }
+  }
+}
+
+void AsyncWebServer::accept() {
+  for (Connection& connection : _connections) {
+    if (connection.fd >= 0) {
+      continue;
+    }
+    int fd = ::accept4(_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      return;
+    }
+    connection.fd = fd;
+    connection.received = 0;
+    connection.sent = 0;
+    connection.response.clear();
+  }
+}
+
+void AsyncWebServer::receive(Connection& connection) {
+  ssize_t result = recv(connection.fd, connection.request + connection.received,
+                        kMaxRequestBytes - connection.received, MSG_DONTWAIT);
+  if (result == 0 || (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+    close(connection);
+    return;
+  }
+  if (result > 0) {
+    connection.received += static_cast<size_t>(result);
+  }
+
+  const char* headerEnd = find(connection.request, connection.request + connection.received, "\r\n\r\n");
+  if (!headerEnd) {
+    if (connection.received == kMaxRequestBytes) {
+      connection.pending.reset(new AsyncWebServerRequest());
+      connection.pending->send(431);
+      connection.response = connection.pending->_response->render();
+    }
+    return;
+  }
+  dispatch(connection, static_cast<size_t>(headerEnd - connection.request) + 4);
+}
+
+void AsyncWebServer::dispatch(Connection& connection, size_t headerLength) {
+  std::unique_ptr<AsyncWebServerRequest> request(new AsyncWebServerRequest());
+  request->_method = static_cast<WebRequestMethod>(0);
+  request->_contentLength = 0;
+
+  // Request line: METHOD SP target SP version.
+  const char* cursor = connection.request;
+  const char* headersEnd = connection.request + headerLength - 2;
+  const char* lineEnd = find(cursor, headersEnd, "\r\n");
+  const char* space = static_cast<const char*>(memchr(cursor, ' ', lineEnd - cursor));
+  const char* target = space ? space + 1 : lineEnd;
+  const char* targetEnd = static_cast<const char*>(memchr(target, ' ', lineEnd - target));
+  targetEnd = targetEnd ? targetEnd : lineEnd;
+  if (space && space - cursor == 3 && memcmp(cursor, "GET", 3) == 0) {
+    request->_method = HTTP_GET;
+  } else if (space && space - cursor == 4 && memcmp(cursor, "POST", 4) == 0) {
+    request->_method = HTTP_POST;
+  }
+  const char* query = static_cast<const char*>(memchr(target, '?', targetEnd - target));
+  request->_url = String(std::string(target, query ? query : targetEnd).c_str());
+  if (query) {
+    parseParams(query + 1, targetEnd - query - 1, false, request->_params);
+  }
+
+  // Header fields.
+  cursor = lineEnd + 2;
+  while (cursor < headersEnd) {
+    lineEnd = find(cursor, headersEnd, "\r\n");
+    const char* colon = static_cast<const char*>(memchr(cursor, ':', lineEnd - cursor));
+    if (colon) {
+      const char* value = colon + 1;
+      while (value < lineEnd && *value == ' ') {
+        ++value;
+      }
+      request->_headers.emplace_back(String(std::string(cursor, colon).c_str()),
+                                     String(std::string(value, lineEnd).c_str()));
+    }
+    cursor = lineEnd + 2;
+  }
+  if (AsyncWebHeader* length = request->getHeader("Content-Length")) {
+    request->_contentLength = strtoul(length->value().c_str(), nullptr, 10);
+  }
+
+  // A body that fits is parsed once it is all here; one that does not is
+  // left unread and only its length is known to the handler.
+  size_t total = headerLength + request->_contentLength;
+  if (total <= kMaxRequestBytes) {
+    if (connection.received < total) {
+      return;
+    }
+    AsyncWebHeader* type = request->getHeader("Content-Type");
+    if (type && strncasecmp(type->value().c_str(), "application/x-www-form-urlencoded", 33) == 0) {
+      parseParams(connection.request + headerLength, request->_contentLength, true, request->_params);
+    }
+  }
+
+  const Route* route = nullptr;
+  for (const Route& candidate : _routes) {
+    if ((candidate.method & request->_method) && candidate.uri == request->_url) {
+      route = &candidate;
+      break;
+    }
+  }
+  if (route) {
+    route->handler(request.get());
+  } else if (_notFound) {
+    _notFound(request.get());
+  } else {
+    request->send(404);
+  }
+  // A handler that sends nothing gets the connection closed.
+  connection.response = request->_response ? request->_response->render() : std::string();
+  connection.sent = 0;
+  connection.pending = std::move(request);
+}
+
+void AsyncWebServer::transmit(Connection& connection) {
+  size_t remaining = connection.response.size() - connection.sent;
+  size_t chunk = remaining < kSendWindow ? remaining : kSendWindow;
+  if (chunk > 0) {
+    ssize_t result = ::send(connection.fd, connection.response.data() + connection.sent, chunk, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (result < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+      close(connection);
+      return;
+    }
+    if (result > 0) {
+      connection.sent += static_cast<size_t>(result);
+    }
+  }
+  if (connection.sent == connection.response.size()) {
+    close(connection);
+  }
+}
+
+void AsyncWebServer::close(Connection& connection) {
+  if (connection.fd < 0) {
+    return;
+  }
+  ::close(connection.fd);
+  connection.fd = -1;
+  connection.received = 0;
+  connection.sent = 0;
+  connection.response.clear();
+  std::unique_ptr<AsyncWebServerRequest> request = std::move(connection.pending);
+  if (request && request->_onDisconnect) {
+    request->_onDisconnect();
+  }
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// The provisioning portal's web server on a host TCP socket, listening on
+// DEVICECORE_NATIVE_HTTP_PORT rather than port 80. As in the library,
+// connections are picked up and handlers run from NativeHal::service() once
+// a request has fully arrived. Each connection buffers at most
+// kMaxRequestBytes of request, and its response goes out at most kSendWindow
+// bytes per service(), what lwIP's send buffer would take, so concurrent
+// requests overlap as they do on the device. There is no keep-alive: the
+// connection closes once its response is out, which is when onDisconnect()
+// handlers run.
+
+enum WebRequestMethod { HTTP_GET = 0x01, HTTP_POST = 0x02, HTTP_ANY = 0xFF };
+
+class AsyncWebHeader {
+public:
+  AsyncWebHeader(const String& name, const String& value) : _name(name), _value(value) {}
+
+  const String& name() const { return _name; }
+  const String& value() const { return _value; }
+
+private:
+  String _name;
+  String _value;
+};
+
+class AsyncWebParameter {
+public:
+  AsyncWebParameter(const String& name, const String& value, bool post) : _name(name), _value(value), _post(post) {}
+
+  const String& name() const { return _name; }
+  const String& value() const { return _value; }
+  bool isPost() const { return _post; }
+
+private:
+  String _name;
+  String _value;
+  bool _post;
+};
+
+class AsyncWebServerResponse {
+public:
+  AsyncWebServerResponse(int code, const String& contentType, const char* content, size_t length);
+  virtual ~AsyncWebServerResponse() {}
+
+  void addHeader(const String& name, const String& value);
+
+  // Host side: the status line, headers and body as they go on the wire.
+  std::string render() const;
+
+protected:
+  int _code;
+  String _contentType;
+  std::string _content;
+  std::vector<AsyncWebHeader> _headers;
+};
+
+class AsyncResponseStream : public AsyncWebServerResponse, public Print {
+public:
+  explicit AsyncResponseStream(const String& contentType) : AsyncWebServerResponse(200, contentType, nullptr, 0) {}
+
+  size_t write(uint8_t value) override { return write(&value, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+};
+
+class AsyncWebServerRequest {
+public:
+  WebRequestMethod method() const { return _method; }
+  const String& url() const { return _url; }
+  bool hasHeader(const char* name) const { return getHeader(name) != nullptr; }
+  AsyncWebHeader* getHeader(const char* name) const;
+  bool hasParam(const char* name, bool post = false) const { return getParam(name, post) != nullptr; }
+  AsyncWebParameter* getParam(const char* name, bool post = false) const;
+  size_t contentLength() const { return _contentLength; }
+
+  void send(int code, const char* contentType = nullptr, const String& content = String());
+  // The request owns responses handed to send(), as in the real library.
+  void send(AsyncWebServerResponse* response);
+  AsyncWebServerResponse* beginResponse(int code, const String& contentType = String(), const String& content = String());
+  AsyncWebServerResponse* beginResponse_P(int code, const String& contentType, const uint8_t* content, size_t length);
+  AsyncResponseStream* beginResponseStream(const String& contentType, size_t bufferSize = 1460);
+  void redirect(const char* url);
+  void onDisconnect(std::function<void()> handler) { _onDisconnect = handler; }
+
+private:
+  friend class AsyncWebServer;
+
+  WebRequestMethod _method;
+  String _url;
+  size_t _contentLength;
+  mutable std::vector<AsyncWebHeader> _headers;
+  mutable std::vector<AsyncWebParameter> _params;
+  std::unique_ptr<AsyncWebServerResponse> _response;
+  std::function<void()> _onDisconnect;
+};
+
+typedef std::function<void(AsyncWebServerRequest*)> ArRequestHandlerFunction;
+
+class AsyncCallbackWebHandler {};
+
+class AsyncWebServer {
+public:
+  // MEMP_NUM_TCP_PCB of the core's lwIP build; further clients wait in the
+  // listen backlog.
+  static constexpr size_t kMaxConnections = 5;
+  static constexpr size_t kMaxRequestBytes = 1024;
+  // tcp_sndbuf() of an idle connection.
+  static constexpr size_t kSendWindow = 2 * 1460;
+
+  explicit AsyncWebServer(uint16_t port);
+  ~AsyncWebServer();
+  AsyncWebServer(const AsyncWebServer&) = delete;
+  AsyncWebServer& operator=(const AsyncWebServer&) = delete;
+
+  AsyncCallbackWebHandler& on(const char* uri, int method, ArRequestHandlerFunction handler);
+  void onNotFound(ArRequestHandlerFunction handler) { _notFound = handler; }
+  void begin();
+  void end();
+  void reset();
+
+  // Host side, driven by NativeHal.
+  static void serviceAll();
+
+private:
+  struct Route {
+    String uri;
+    int method;
+    ArRequestHandlerFunction handler;
+  };
+
+  struct Connection {
+    int fd;
+    char request[kMaxRequestBytes];
+    size_t received;
+    std::unique_ptr<AsyncWebServerRequest> pending;
+    std::string response;
+    size_t sent;
+  };
+
+  static AsyncWebServer* s_first;
+
+  AsyncWebServer* _next;
+  int _fd;
+  std::vector<Route> _routes;
+  ArRequestHandlerFunction _notFound;
+  AsyncCallbackWebHandler _handler;
+  Connection _connections[kMaxConnections];
+
+  void service();
+  void accept();
+  void receive(Connection& connection);
+  void dispatch(Connection& connection, size_t headerLength);
+  void transmit(Connection& connection);
+  void close(Connection& connection);
+};
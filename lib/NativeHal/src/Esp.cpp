@@ -0,0 +1,104 @@
+#include "Esp.h"
+#include "NativeHal.h"
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+constexpr uint32_t kHostFreeHeap = 40960;
+constexpr uint32_t kHostFreeContStack = 3072;
+constexpr const char* kRtcFile = "rtc.bin";
+
+uint8_t s_rtc[EspClass::kRtcUserMemoryBytes];
+bool s_rtcLoaded = false;
+
+void loadRtc() {
+  if (s_rtcLoaded) {
+    return;
+  }
+  s_rtcLoaded = true;
+  char path[256];
+  FILE* file = fopen(NativeHal::statePath(kRtcFile, path, sizeof(path)), "rb");
+  if (!file) {
+    return;
+  }
+  size_t loaded = fread(s_rtc, 1, sizeof(s_rtc), file);
+  fclose(file);
+  memset(s_rtc + loaded, 0, sizeof(s_rtc) - loaded);
+}
+
+bool saveRtc() {
+  char path[256];
+  FILE* file = fopen(NativeHal::statePath(kRtcFile, path, sizeof(path)), "wb");
+  if (!file) {
+    return false;
+  }
+  bool ok = fwrite(s_rtc, 1, sizeof(s_rtc), file) == sizeof(s_rtc);
+  return fclose(file) == 0 && ok;
+}
+
+bool rtcRange(uint32_t offset, size_t size) {
+  return size > 0 && static_cast<size_t>(offset) * 4 + size <= sizeof(s_rtc);
+}
+}  // namespace
+
+EspClass ESP;
+
+uint32_t EspClass::getChipId() {
+  return static_cast<uint32_t>(gethostid()) & 0x00FFFFFFUL;
+}
+
+void EspClass::restart() {
+  NativeHal::restart();
+}
+
+uint32_t EspClass::getFreeHeap() {
+  return kHostFreeHeap;
+}
+
+uint32_t EspClass::getMaxFreeBlockSize() {
+  return kHostFreeHeap;
+}
+
+uint8_t EspClass::getHeapFragmentation() {
+  return 0;
+}
+
+void EspClass::getHeapStats(uint32_t* free, uint32_t* max, uint8_t* frag) {
+  if (free) {
+    *free = getFreeHeap();
+  }
+  if (max) {
+    *max = getMaxFreeBlockSize();
+  }
+  if (frag) {
+    *frag = getHeapFragmentation();
+  }
+}
+
+uint32_t EspClass::getFreeContStack() {
+  return kHostFreeContStack;
+}
+
+uint32_t EspClass::getCycleCount() {
+  // 80 MHz, like the default CPU clock.
+  return static_cast<uint32_t>(NativeHal::clock().nowUs() * 80);
+}
+
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t* data, size_t size) {
+  if (!data || !rtcRange(offset, size)) {
+    return false;
+  }
+  loadRtc();
+  memcpy(data, s_rtc + offset * 4, size);
+  return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t* data, size_t size) {
+  if (!data || !rtcRange(offset, size)) {
+    return false;
+  }
+  loadRtc();
+  memcpy(s_rtc + offset * 4, data, size);
+  return saveRtc();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// ESP.* calls. Heap and stack figures have no host equivalent and report
+// fixed, healthy values so memory alarms stay quiet; RTC user memory is
+// kept in the state directory so it survives restart() as it would a
+// soft reset.
+class EspClass {
+public:
+  static constexpr size_t kRtcUserMemoryBytes = 512;
+
+  uint32_t getChipId();
+  [[noreturn]] void restart();
+  uint32_t getFreeHeap();
+  uint32_t getMaxFreeBlockSize();
+  uint8_t getHeapFragmentation();
+  void getHeapStats(uint32_t* free = nullptr, uint32_t* max = nullptr, uint8_t* frag = nullptr);
+  uint32_t getFreeContStack();
+  void resetFreeContStack() {}
+  uint32_t getCycleCount();
+  // offset is in 4-byte blocks, size in bytes, as on the device.
+  bool rtcUserMemoryRead(uint32_t offset, uint32_t* data, size_t size);
+  bool rtcUserMemoryWrite(uint32_t offset, uint32_t* data, size_t size);
+};
+
+extern EspClass ESP;
@@ -0,0 +1,266 @@
+#include "FS.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <string>
+#include "LittleFS.h"
+#include "NativeHal.h"
+
+namespace fs {
+
+// Unbuffered descriptors rather than stdio, so a reader opened alongside an
+// appender sees each append as soon as the appender's write returns.
+struct File::Handle {
+  int fd;
+  std::string name;
+
+  Handle(int descriptor, const char* path) : fd(descriptor), name(path) {}
+  ~Handle() { ::close(fd); }
+};
+
+struct Dir::Handle {
+  DIR* dir;
+  std::string path;
+  std::string virtualPath;
+  std::string current;
+
+  Handle(DIR* opened, const char* hostPath, const char* volumePath) : dir(opened), path(hostPath), virtualPath(volumePath) {}
+  ~Handle() { closedir(dir); }
+};
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+  if (!_handle) {
+    return 0;
+  }
+  size_t written = 0;
+  while (written < size) {
+    ssize_t result = ::write(_handle->fd, buffer + written, size - written);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      break;
+    }
+    written += static_cast<size_t>(result);
+  }
+  return written;
+}
+
+int File::available() {
+  if (!_handle) {
+    return 0;
+  }
+  size_t total = size();
+  size_t offset = position();
+  return offset < total ? static_cast<int>(total - offset) : 0;
+}
+
+int File::read() {
+  uint8_t value;
+  return read(&value, 1) == 1 ? value : -1;
+}
+
+int File::peek() {
+  if (!_handle) {
+    return -1;
+  }
+  uint8_t value;
+  ssize_t result = pread(_handle->fd, &value, 1, lseek(_handle->fd, 0, SEEK_CUR));
+  return result == 1 ? value : -1;
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+  if (!_handle) {
+    return 0;
+  }
+  size_t got = 0;
+  while (got < size) {
+    ssize_t result = ::read(_handle->fd, buffer + got, size - got);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      break;
+    }
+    got += static_cast<size_t>(result);
+  }
+  return got;
+}
+
+bool File::seek(uint32_t position, SeekMode mode) {
+  if (!_handle) {
+    return false;
+  }
+  int whence = mode == SeekCur ? SEEK_CUR : (mode == SeekEnd ? SEEK_END : SEEK_SET);
+  off_t offset = mode == SeekSet ? static_cast<off_t>(position) : static_cast<off_t>(static_cast<int32_t>(position));
+  off_t target = lseek(_handle->fd, 0, whence) + offset;
+  // LittleFS refuses to seek past the end of the file; POSIX would allow it.
+  if (target < 0 || static_cast<size_t>(target) > size()) {
+    return false;
+  }
+  return lseek(_handle->fd, target, SEEK_SET) == target;
+}
+
+size_t File::position() const {
+  if (!_handle) {
+    return 0;
+  }
+  off_t offset = lseek(_handle->fd, 0, SEEK_CUR);
+  return offset > 0 ? static_cast<size_t>(offset) : 0;
+}
+
+size_t File::size() const {
+  struct stat info;
+  if (!_handle || fstat(_handle->fd, &info) != 0) {
+    return 0;
+  }
+  return static_cast<size_t>(info.st_size);
+}
+
+bool File::truncate(uint32_t size) {
+  return _handle && ftruncate(_handle->fd, static_cast<off_t>(size)) == 0;
+}
+
+const char* File::name() const {
+  if (!_handle) {
+    return "";
+  }
+  const char* slash = strrchr(_handle->name.c_str(), '/');
+  return slash ? slash + 1 : _handle->name.c_str();
+}
+
+bool Dir::next() {
+  if (!_handle) {
+    return false;
+  }
+  while (struct dirent* entry = readdir(_handle->dir)) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+      continue;
+    }
+    _handle->current = entry->d_name;
+    return true;
+  }
+  _handle->current.clear();
+  return false;
+}
+
+String Dir::fileName() const {
+  return _handle ? String(_handle->current.c_str()) : String();
+}
+
+size_t Dir::fileSize() const {
+  struct stat info;
+  if (!_handle || _handle->current.empty()) {
+    return 0;
+  }
+  std::string path = _handle->path + "/" + _handle->current;
+  return stat(path.c_str(), &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+}
+
+File Dir::openFile(const char* mode) {
+  if (!_handle || _handle->current.empty()) {
+    return File();
+  }
+  std::string path = _handle->virtualPath;
+  if (path.empty() || path.back() != '/') {
+    path += '/';
+  }
+  path += _handle->current;
+  return LittleFS.open(path.c_str(), mode);
+}
+
+bool FS::begin() {
+  char root[256];
+  if (!hostPath("/", root, sizeof(root))) {
+    return false;
+  }
+  if (::mkdir(root, 0755) != 0 && errno != EEXIST) {
+    return false;
+  }
+  _mounted = true;
+  return true;
+}
+
+File FS::open(const char* path, const char* mode) {
+  char host[256];
+  if (!_mounted || !mode || !hostPath(path, host, sizeof(host))) {
+    return File();
+  }
+  int flags;
+  bool plus = strchr(mode, '+') != nullptr;
+  switch (mode[0]) {
+    case 'r':
+      flags = plus ? O_RDWR : O_RDONLY;
+      break;
+    case 'w':
+      flags = (plus ? O_RDWR : O_WRONLY) | O_CREAT | O_TRUNC;
+      break;
+    case 'a':
+      flags = (plus ? O_RDWR : O_WRONLY) | O_CREAT | O_APPEND;
+      break;
+    default:
+      return File();
+  }
+  int fd = ::open(host, flags | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return File();
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || S_ISDIR(info.st_mode)) {
+    ::close(fd);
+    return File();
+  }
+  return File(std::make_shared<File::Handle>(fd, path));
+}
+
+bool FS::exists(const char* path) {
+  char host[256];
+  struct stat info;
+  return _mounted && hostPath(path, host, sizeof(host)) && stat(host, &info) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+  char host[256];
+  return _mounted && hostPath(path, host, sizeof(host)) && ::mkdir(host, 0755) == 0;
+}
+
+bool FS::remove(const char* path) {
+  char host[256];
+  return _mounted && hostPath(path, host, sizeof(host)) && (unlink(host) == 0 || rmdir(host) == 0);
+}
+
+bool FS::rename(const char* from, const char* to) {
+  char hostFrom[256];
+  char hostTo[256];
+  return _mounted && hostPath(from, hostFrom, sizeof(hostFrom)) && hostPath(to, hostTo, sizeof(hostTo)) &&
+         ::rename(hostFrom, hostTo) == 0;
+}
+
+Dir FS::openDir(const char* path) {
+  char host[256];
+  if (!_mounted || !hostPath(path, host, sizeof(host))) {
+    return Dir();
+  }
+  DIR* dir = opendir(host);
+  if (!dir) {
+    return Dir();
+  }
+  return Dir(std::make_shared<Dir::Handle>(dir, host, path));
+}
+
+bool FS::hostPath(const char* path, char* out, size_t capacity) const {
+  if (!path || path[0] != '/' || strstr(path, "..")) {
+    return false;
+  }
+  char root[200];
+  NativeHal::statePath(_volume, root, sizeof(root));
+  int written = snprintf(out, capacity, "%s%s", root, path);
+  return written > 0 && static_cast<size_t>(written) < capacity;
+}
+
+}  // namespace fs
+
+fs::FS LittleFS("littlefs");
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+
+// The core's fs:: API over a directory of the host file system. Paths are
+// absolute inside the mounted volume, as on LittleFS.
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File : public Stream {
+public:
+  File() {}
+
+  size_t write(uint8_t value) override { return write(&value, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t read(uint8_t* buffer, size_t size);
+  bool seek(uint32_t position, SeekMode mode);
+  size_t position() const;
+  size_t size() const;
+  bool truncate(uint32_t size);
+  void close() { _handle.reset(); }
+  const char* name() const;
+  explicit operator bool() const { return static_cast<bool>(_handle); }
+
+private:
+  friend class FS;
+  friend class Dir;
+  struct Handle;
+
+  explicit File(std::shared_ptr<Handle> handle) : _handle(std::move(handle)) {}
+
+  // Shared like the core's FileImplPtr, so copies of a File see one offset
+  // and the descriptor closes with the last of them.
+  std::shared_ptr<Handle> _handle;
+};
+
+class Dir {
+public:
+  Dir() {}
+
+  bool next();
+  String fileName() const;
+  size_t fileSize() const;
+  File openFile(const char* mode);
+
+private:
+  friend class FS;
+  struct Handle;
+
+  explicit Dir(std::shared_ptr<Handle> handle) : _handle(std::move(handle)) {}
+
+  std::shared_ptr<Handle> _handle;
+};
+
+class FS {
+public:
+  explicit FS(const char* volume) : _volume(volume), _mounted(false) {}
+
+  bool begin();
+  void end() { _mounted = false; }
+  File open(const char* path, const char* mode);
+  bool exists(const char* path);
+  bool mkdir(const char* path);
+  bool remove(const char* path);
+  bool rename(const char* from, const char* to);
+  Dir openDir(const char* path);
+
+private:
+  const char* _volume;
+  bool _mounted;
+
+  bool hostPath(const char* path, char* out, size_t capacity) const;
+};
+
+}  // namespace fs
+
+using fs::Dir;
+using fs::File;
+using fs::FS;
+using fs::SeekCur;
+using fs::SeekEnd;
+using fs::SeekMode;
+using fs::SeekSet;
@@ -0,0 +1,191 @@
+#include "HardwareSerial.h"
+#include "NativeHal.h"
+#include <cerrno>
+#include <unistd.h>
+
+namespace {
+// Driver default on the ESP8266.
+constexpr size_t kDefaultRxBufferSize = 256;
+// 8N1 framing: ten bit times per byte.
+constexpr unsigned long kBitsPerByte = 10;
+constexpr int kTxSpace = 4096;
+}  // namespace
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+
+HardwareSerial::HardwareSerial(int)
+    : _rxFd(-1),
+      _txFd(-1),
+      _paced(false),
+      _running(false),
+      _endOfInput(false),
+      _overrun(false),
+      _baud(115200),
+      _rxCapacity(kDefaultRxBufferSize),
+      _rxHead(0),
+      _rxCount(0),
+      _paceOriginUs(0),
+      _pacedBytes(0) {}
+
+void HardwareSerial::attach(int rxFd, int txFd, bool paced) {
+  _rxFd = rxFd;
+  _txFd = txFd;
+  _paced = paced;
+  _endOfInput = false;
+  restartPacing();
+}
+
+void HardwareSerial::begin(unsigned long baud) {
+  _baud = baud;
+  _running = true;
+  _rxHead = 0;
+  _rxCount = 0;
+  _overrun = false;
+  restartPacing();
+}
+
+void HardwareSerial::end() {
+  _running = false;
+}
+
+void HardwareSerial::updateBaudRate(unsigned long baud) {
+  fill();
+  _baud = baud;
+  restartPacing();
+}
+
+size_t HardwareSerial::setRxBufferSize(size_t size) {
+  if (size == 0 || size > kMaxRxBufferSize) {
+    size = kMaxRxBufferSize;
+  }
+  _rxCapacity = size;
+  _rxHead = 0;
+  _rxCount = 0;
+  return size;
+}
+
+int HardwareSerial::available() {
+  fill();
+  return static_cast<int>(_rxCount);
+}
+
+int HardwareSerial::read() {
+  fill();
+  if (_rxCount == 0) {
+    return -1;
+  }
+  uint8_t value = _rx[_rxHead];
+  _rxHead = (_rxHead + 1) % _rxCapacity;
+  --_rxCount;
+  return value;
+}
+
+int HardwareSerial::peek() {
+  fill();
+  return _rxCount == 0 ? -1 : _rx[_rxHead];
+}
+
+size_t HardwareSerial::write(uint8_t value) {
+  return write(&value, 1);
+}
+
+// Nothing waits on the host side: bytes the descriptor will not take right
+// now are dropped, like a TX FIFO nobody drains.
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  if (_txFd < 0) {
+    return size;
+  }
+  size_t written = 0;
+  while (written < size) {
+    ssize_t result = ::write(_txFd, buffer + written, size - written);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      break;
+    }
+    written += static_cast<size_t>(result);
+  }
+  return written;
+}
+
+int HardwareSerial::availableForWrite() {
+  return _txFd < 0 ? 0 : kTxSpace;
+}
+
+bool HardwareSerial::hasOverrun() {
+  fill();
+  bool overrun = _overrun;
+  _overrun = false;
+  return overrun;
+}
+
+void HardwareSerial::restartPacing() {
+  _paceOriginUs = NativeHal::clock().nowUs();
+  _pacedBytes = 0;
+}
+
+void HardwareSerial::fill() {
+  if (_rxFd < 0 || !_running || _endOfInput) {
+    return;
+  }
+  // An unpaced source is only read again once the buffer has drained; a
+  // read() per available() call would swamp any host measurement, and the
+  // bytes still come out in the order they were written.
+  if (!_paced && _rxCount > 0) {
+    return;
+  }
+
+  uint64_t due = ~0ULL;
+  if (_paced) {
+    uint64_t elapsedUs = NativeHal::clock().nowUs() - _paceOriginUs;
+    due = elapsedUs * (_baud / kBitsPerByte) / 1000000ULL - _pacedBytes;
+  }
+
+  while (due > 0 && _rxCount < _rxCapacity) {
+    size_t tail = (_rxHead + _rxCount) % _rxCapacity;
+    size_t room = tail >= _rxHead ? _rxCapacity - tail : _rxHead - tail;
+    if (room > _rxCapacity - _rxCount) {
+      room = _rxCapacity - _rxCount;
+    }
+    if (room > due) {
+      room = static_cast<size_t>(due);
+    }
+    ssize_t result = ::read(_rxFd, _rx + tail, room);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result == 0) {
+      _endOfInput = true;
+      return;
+    }
+    // EAGAIN, or EIO from a PTY nobody has opened yet.
+    if (result < 0) {
+      return;
+    }
+    _rxCount += static_cast<size_t>(result);
+    _pacedBytes += static_cast<uint64_t>(result);
+    due -= static_cast<uint64_t>(result);
+  }
+
+  if (_paced && due > 0) {
+    dropPaced(due);
+  }
+}
+
+// Bytes that arrived while the RX buffer was full.
+void HardwareSerial::dropPaced(uint64_t count) {
+  uint8_t scratch[256];
+  while (count > 0) {
+    size_t chunk = count < sizeof(scratch) ? static_cast<size_t>(count) : sizeof(scratch);
+    ssize_t result = ::read(_rxFd, scratch, chunk);
+    if (result <= 0) {
+      _endOfInput = result == 0;
+      return;
+    }
+    _pacedBytes += static_cast<uint64_t>(result);
+    count -= static_cast<uint64_t>(result);
+    _overrun = true;
+  }
+}
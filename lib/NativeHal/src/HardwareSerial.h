@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include "Stream.h"
+
+// UART backed by host file descriptors. Received bytes go through an RX
+// buffer of the size set with setRxBufferSize(), standing in for the
+// driver's ring. With a paced source (a capture file) bytes arrive at the
+// configured baud rate on the HAL clock, and any that would have landed in
+// a full buffer are dropped and reported by hasOverrun() as the hardware
+// would; otherwise (a PTY or stdin) bytes arrive as the writer sends them.
+class HardwareSerial : public Stream {
+public:
+  static constexpr size_t kMaxRxBufferSize = 4096;
+
+  // The unit number is kept for source compatibility; attach() decides
+  // where the bytes go.
+  explicit HardwareSerial(int uart);
+
+  void begin(unsigned long baud);
+  void end();
+  void updateBaudRate(unsigned long baud);
+  size_t setRxBufferSize(size_t size);
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t value) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int availableForWrite() override;
+  void flush() override {}
+
+  // Reports and clears an RX overrun.
+  bool hasOverrun();
+  bool hasRxError() { return false; }
+  operator bool() const { return true; }
+
+  // Host side: rxFd or txFd may be -1 for a direction that is not wired up.
+  void attach(int rxFd, int txFd, bool paced);
+
+private:
+  int _rxFd;
+  int _txFd;
+  bool _paced;
+  bool _running;
+  bool _endOfInput;
+  bool _overrun;
+  unsigned long _baud;
+  uint8_t _rx[kMaxRxBufferSize];
+  size_t _rxCapacity;
+  size_t _rxHead;
+  size_t _rxCount;
+  uint64_t _paceOriginUs;
+  uint64_t _pacedBytes;
+
+  void restartPacing();
+  void fill();
+  void dropPaced(uint64_t count);
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
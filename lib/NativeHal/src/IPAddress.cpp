@@ -0,0 +1,19 @@
+#include "IPAddress.h"
+#include <arpa/inet.h>
+#include <cstdio>
+
+bool IPAddress::fromString(const char* text) {
+  in_addr parsed;
+  if (!text || inet_pton(AF_INET, text, &parsed) != 1) {
+    return false;
+  }
+  _address = parsed.s_addr;
+  return true;
+}
+
+String IPAddress::toString() const {
+  char text[16];
+  snprintf(text, sizeof(text), "%u.%u.%u.%u", static_cast<unsigned>((*this)[0]), static_cast<unsigned>((*this)[1]),
+           static_cast<unsigned>((*this)[2]), static_cast<unsigned>((*this)[3]));
+  return String(text);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include "WString.h"
+
+class IPAddress {
+public:
+  IPAddress() : _address(0) {}
+  IPAddress(uint8_t first, uint8_t second, uint8_t third, uint8_t fourth)
+      : _address(static_cast<uint32_t>(first) | static_cast<uint32_t>(second) << 8 |
+                 static_cast<uint32_t>(third) << 16 | static_cast<uint32_t>(fourth) << 24) {}
+  IPAddress(uint32_t address) : _address(address) {}
+  explicit IPAddress(const uint8_t* octets) : IPAddress(octets[0], octets[1], octets[2], octets[3]) {}
+
+  // Same layout as lwIP: first octet in the low byte, i.e. network order.
+  operator uint32_t() const { return _address; }
+  uint8_t operator[](int index) const { return static_cast<uint8_t>(_address >> (8 * index)); }
+  bool operator==(const IPAddress& other) const { return _address == other._address; }
+  bool operator!=(const IPAddress& other) const { return _address != other._address; }
+
+  bool isSet() const { return _address != 0; }
+  bool fromString(const char* text);
+  String toString() const;
+
+private:
+  uint32_t _address;
+};
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "FS.h"
+
+// Mounted at <state directory>/littlefs.
+extern fs::FS LittleFS;
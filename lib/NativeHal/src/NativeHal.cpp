@@ -0,0 +1,177 @@
+#include "NativeHal.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <ESPAsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+#include <Ticker.h>
+
+namespace NativeHal {
+
+namespace {
+constexpr const char* kDefaultStateDir = ".native";
+constexpr const char* kDefaultSsid = "native";
+constexpr const char* kDefaultHttpPort = "8080";
+
+Clock* s_clock = nullptr;
+bool s_clockOverridden = false;
+char** s_argv = nullptr;
+const char* s_stateDir = kDefaultStateDir;
+unsigned long s_runMs = 0;
+uint16_t s_httpPort = 8080;
+
+const char* setting(const char* name, const char* fallback) {
+  const char* value = getenv(name);
+  return value && value[0] ? value : fallback;
+}
+
+uint64_t monotonicUs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000ULL + static_cast<uint64_t>(now.tv_nsec) / 1000ULL;
+}
+
+// A pseudo-terminal in raw mode, so a terminal program or a slave simulator
+// can sit on the other end. Our own handle on the slave side keeps the
+// master from reporting a hangup before anyone else has opened it.
+int openPty() {
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+    perror("NativeHal: pty");
+    return -1;
+  }
+  const char* slavePath = ptsname(master);
+  int slave = slavePath ? open(slavePath, O_RDWR | O_NOCTTY | O_CLOEXEC) : -1;
+  struct termios settings;
+  if (slave >= 0 && tcgetattr(slave, &settings) == 0) {
+    cfmakeraw(&settings);
+    tcsetattr(slave, TCSANOW, &settings);
+  }
+  fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+  fcntl(master, F_SETFD, FD_CLOEXEC);
+  fprintf(stderr, "NativeHal: UART0 on %s\n", slavePath ? slavePath : "?");
+  return master;
+}
+
+void attachUart() {
+  const char* source = setting("DEVICECORE_NATIVE_UART", "pty");
+  if (strcmp(source, "pty") == 0) {
+    int fd = openPty();
+    Serial.attach(fd, fd, false);
+  } else if (strcmp(source, "-") == 0) {
+    fcntl(STDIN_FILENO, F_SETFL, fcntl(STDIN_FILENO, F_GETFL) | O_NONBLOCK);
+    Serial.attach(STDIN_FILENO, STDOUT_FILENO, false);
+  } else {
+    int fd = open(source, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      fprintf(stderr, "NativeHal: cannot open UART capture %s: %s\n", source, strerror(errno));
+    }
+    Serial.attach(fd, STDOUT_FILENO, true);
+  }
+  // UART1 is transmit-only on the ESP8266; the logger writes there.
+  Serial1.attach(-1, STDERR_FILENO, false);
+}
+}  // namespace
+
+SystemClock::SystemClock() : _originUs(monotonicUs()) {}
+
+uint64_t SystemClock::nowUs() {
+  return monotonicUs() - _originUs;
+}
+
+void SystemClock::sleepUs(uint64_t us) {
+  struct timespec wait;
+  wait.tv_sec = static_cast<time_t>(us / 1000000ULL);
+  wait.tv_nsec = static_cast<long>(us % 1000000ULL) * 1000L;
+  while (nanosleep(&wait, &wait) != 0 && errno == EINTR) {
+  }
+}
+
+void setClock(Clock& clock) {
+  s_clock = &clock;
+  s_clockOverridden = true;
+}
+
+Clock& clock() {
+  if (!s_clock) {
+    static SystemClock systemClock;
+    s_clock = &systemClock;
+  }
+  return *s_clock;
+}
+
+void begin(int argc, char** argv) {
+  (void)argc;
+  s_argv = argv;
+  // A broker that drops the connection must not kill the process.
+  signal(SIGPIPE, SIG_IGN);
+
+  if (!s_clockOverridden && strcmp(setting("DEVICECORE_NATIVE_CLOCK", "system"), "virtual") == 0) {
+    static ManualClock virtualClock;
+    s_clock = &virtualClock;
+  }
+  s_stateDir = setting("DEVICECORE_NATIVE_STATE", kDefaultStateDir);
+  s_runMs = strtoul(setting("DEVICECORE_NATIVE_RUN_MS", "0"), nullptr, 10);
+  s_httpPort = static_cast<uint16_t>(strtoul(setting("DEVICECORE_NATIVE_HTTP_PORT", kDefaultHttpPort), nullptr, 10));
+  if (mkdir(s_stateDir, 0755) != 0 && errno != EEXIST) {
+    fprintf(stderr, "NativeHal: cannot create %s: %s\n", s_stateDir, strerror(errno));
+  }
+
+  WiFi.setAccessPoint(setting("DEVICECORE_NATIVE_SSID", kDefaultSsid));
+  attachUart();
+}
+
+void service() {
+  unsigned long now = millis();
+  Ticker::serviceAll(now);
+  WiFi.service(now);
+  AsyncClient::serviceAll();
+  AsyncWebServer::serviceAll();
+}
+
+void idle(uint32_t maxMs) {
+  unsigned long now = millis();
+  unsigned long wait = maxMs;
+  unsigned long ticker = Ticker::msUntilNext(now);
+  unsigned long radio = WiFi.msUntilEvent(now);
+  wait = ticker < wait ? ticker : wait;
+  wait = radio < wait ? radio : wait;
+  if (wait > 0) {
+    clock().sleepUs(static_cast<uint64_t>(wait) * 1000ULL);
+  }
+  service();
+}
+
+bool finished() {
+  return s_runMs > 0 && millis() >= s_runMs;
+}
+
+uint16_t httpPort() {
+  return s_httpPort;
+}
+
+const char* statePath(const char* name, char* out, size_t capacity) {
+  snprintf(out, capacity, "%s/%s", s_stateDir, name);
+  return out;
+}
+
+void restart() {
+  fflush(stdout);
+  fflush(stderr);
+  if (s_argv) {
+    execv("/proc/self/exe", s_argv);
+    perror("NativeHal: restart");
+  }
+  _exit(EXIT_FAILURE);
+}
+
+}  // namespace NativeHal
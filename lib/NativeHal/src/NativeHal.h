@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Host-side plumbing behind the Arduino and ESP8266 stand-ins in this
+// library. Everything runs on the loop thread: timers fire and the simulated
+// radio makes progress only inside service(), which yield(), delay() and
+// esp_delay() call while they wait, just as the SDK only gets the CPU when
+// the sketch yields.
+//
+// Runtime settings come from the environment:
+//   DEVICECORE_NATIVE_UART    "pty" (default) opens a pseudo-terminal for
+//                             UART0 and prints its path; "-" uses stdin and
+//                             stdout; anything else is a capture file that
+//                             is replayed at the configured baud rate
+//   DEVICECORE_NATIVE_STATE   directory holding EEPROM, LittleFS and RTC
+//                             memory (default ".native")
+//   DEVICECORE_NATIVE_SSID    SSID of the single simulated access point
+//                             (default "native")
+//   DEVICECORE_NATIVE_CLOCK   "system" (default) or "virtual"
+//   DEVICECORE_NATIVE_RUN_MS  exit cleanly after this many clock ms
+//   DEVICECORE_NATIVE_HTTP_PORT
+//                             loopback port of the provisioning portal
+//                             (default 8080; 0 picks a free one)
+namespace NativeHal {
+
+// Time source behind millis() and micros(). sleepUs() is the only way the
+// loop waits, so a virtual clock can skip idle time instead of spending it.
+class Clock {
+public:
+  virtual ~Clock() {}
+  virtual uint64_t nowUs() = 0;
+  virtual void sleepUs(uint64_t us) = 0;
+};
+
+// CLOCK_MONOTONIC, zeroed on first use like the ESP's boot-relative timer.
+class SystemClock : public Clock {
+public:
+  SystemClock();
+  uint64_t nowUs() override;
+  void sleepUs(uint64_t us) override;
+
+private:
+  uint64_t _originUs;
+};
+
+// Moves only when slept on or advanced. Scheduling and paced UART replay
+// become independent of host speed; work between sleeps takes no time, and
+// socket replies still arrive in host time, so use the system clock when
+// talking to a broker or measuring task durations.
+class ManualClock : public Clock {
+public:
+  ManualClock() : _nowUs(0) {}
+  uint64_t nowUs() override { return _nowUs; }
+  void sleepUs(uint64_t us) override { _nowUs += us; }
+  void advanceUs(uint64_t us) { _nowUs += us; }
+
+private:
+  uint64_t _nowUs;
+};
+
+// Replaces the clock; call before begin() to override DEVICECORE_NATIVE_CLOCK.
+void setClock(Clock& clock);
+Clock& clock();
+
+// Reads the environment, creates the state directory and attaches the
+// UARTs. Call once before setup().
+void begin(int argc, char** argv);
+// Runs due timers and pending simulated SDK events.
+void service();
+// Waits up to maxMs, less if a timer or SDK event falls due first, then
+// services.
+void idle(uint32_t maxMs);
+// True once DEVICECORE_NATIVE_RUN_MS of clock time has passed.
+bool finished();
+// Port the portal's web server listens on.
+uint16_t httpPort();
+
+// Path of name inside the state directory.
+const char* statePath(const char* name, char* out, size_t capacity);
+// Re-executes the program in place; backs ESP.restart().
+[[noreturn]] void restart();
+
+}  // namespace NativeHal
@@ -0,0 +1,16 @@
+#include <Arduino.h>
+#include "NativeHal.h"
+
+void setup();
+void loop();
+
+// The ESP8266 core's main loop. Weak, so a host test can bring its own.
+__attribute__((weak)) int main(int argc, char** argv) {
+  NativeHal::begin(argc, argv);
+  setup();
+  while (!NativeHal::finished()) {
+    loop();
+    NativeHal::service();
+  }
+  return 0;
+}
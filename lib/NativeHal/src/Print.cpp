@@ -0,0 +1,57 @@
+#include "Print.h"
+#include <cstdio>
+
+namespace {
+constexpr size_t kPrintfBufferBytes = 256;
+}  // namespace
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t written = 0;
+  while (size-- > 0) {
+    written += write(*buffer++);
+  }
+  return written;
+}
+
+size_t Print::print(double value, int digits) {
+  char text[64];
+  int length = snprintf(text, sizeof(text), "%.*f", digits, value);
+  return length > 0 ? write(text, static_cast<size_t>(length)) : 0;
+}
+
+size_t Print::printf(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  size_t written = vprintf(format, args);
+  va_end(args);
+  return written;
+}
+
+size_t Print::printf_P(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  size_t written = vprintf(format, args);
+  va_end(args);
+  return written;
+}
+
+// Like the core, output longer than the stack buffer is truncated.
+size_t Print::vprintf(const char* format, va_list args) {
+  char text[kPrintfBufferBytes];
+  int length = vsnprintf(text, sizeof(text), format, args);
+  if (length <= 0) {
+    return 0;
+  }
+  size_t size = static_cast<size_t>(length) < sizeof(text) ? static_cast<size_t>(length) : sizeof(text) - 1;
+  return write(text, size);
+}
+
+size_t Print::printNumber(unsigned long value, int base) {
+  String text(value, static_cast<unsigned char>(base));
+  return print(text);
+}
+
+size_t Print::printSigned(long value, int base) {
+  String text(value, static_cast<unsigned char>(base));
+  return print(text);
+}
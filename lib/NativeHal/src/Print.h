@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print {
+public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t value) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* text) { return text ? write(reinterpret_cast<const uint8_t*>(text), strlen(text)) : 0; }
+  size_t write(const char* buffer, size_t size) { return write(reinterpret_cast<const uint8_t*>(buffer), size); }
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+
+  size_t print(const __FlashStringHelper* text) { return write(reinterpret_cast<const char*>(text)); }
+  size_t print(const String& text) { return write(text.c_str(), text.length()); }
+  size_t print(const char* text) { return write(text); }
+  size_t print(char value) { return write(static_cast<uint8_t>(value)); }
+  size_t print(unsigned char value, int base = DEC) { return printNumber(value, base); }
+  size_t print(int value, int base = DEC) { return printSigned(value, base); }
+  size_t print(unsigned int value, int base = DEC) { return printNumber(value, base); }
+  size_t print(long value, int base = DEC) { return printSigned(value, base); }
+  size_t print(unsigned long value, int base = DEC) { return printNumber(value, base); }
+  size_t print(double value, int digits = 2);
+
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(const T& value) {
+    size_t written = print(value);
+    return written + println();
+  }
+  template <typename T>
+  size_t println(const T& value, int format) {
+    size_t written = print(value, format);
+    return written + println();
+  }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+  size_t printf_P(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+private:
+  size_t vprintf(const char* format, va_list args);
+  size_t printNumber(unsigned long value, int base);
+  size_t printSigned(long value, int base);
+};
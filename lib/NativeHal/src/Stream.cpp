@@ -0,0 +1,26 @@
+#include "Stream.h"
+#include <Arduino.h>
+
+int Stream::timedRead() {
+  unsigned long start = millis();
+  do {
+    int value = read();
+    if (value >= 0) {
+      return value;
+    }
+    delay(1);
+  } while (millis() - start < _timeout);
+  return -1;
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+  size_t count = 0;
+  while (count < length) {
+    int value = timedRead();
+    if (value < 0) {
+      break;
+    }
+    buffer[count++] = static_cast<char>(value);
+  }
+  return count;
+}
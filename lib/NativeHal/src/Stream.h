@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Print.h"
+
+class Stream : public Print {
+public:
+  Stream() : _timeout(1000) {}
+
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long timeoutMs) { _timeout = timeoutMs; }
+  unsigned long getTimeout() const { return _timeout; }
+  // Reads until length bytes arrive or no byte has come for the timeout.
+  size_t readBytes(char* buffer, size_t length);
+  size_t readBytes(uint8_t* buffer, size_t length) { return readBytes(reinterpret_cast<char*>(buffer), length); }
+
+protected:
+  unsigned long _timeout;
+
+  int timedRead();
+};
@@ -0,0 +1,94 @@
+#include "Ticker.h"
+
+Ticker* Ticker::s_first = nullptr;
+
+Ticker::Ticker()
+    : _next(nullptr),
+      _active(false),
+      _repeat(false),
+      _periodMs(0),
+      _dueMs(0),
+      _callback(nullptr),
+      _callbackWithArg(nullptr),
+      _arg(nullptr) {}
+
+Ticker::~Ticker() {
+  detach();
+}
+
+void Ticker::arm(uint32_t milliseconds, bool repeat, callback_t callback, callback_with_arg_t callbackWithArg, void* arg) {
+  detach();
+  _repeat = repeat;
+  _periodMs = milliseconds;
+  _dueMs = millis() + milliseconds;
+  _callback = callback;
+  _callbackWithArg = callbackWithArg;
+  _arg = arg;
+  _active = true;
+  _next = s_first;
+  s_first = this;
+}
+
+void Ticker::detach() {
+  if (!_active) {
+    return;
+  }
+  for (Ticker** link = &s_first; *link; link = &(*link)->_next) {
+    if (*link == this) {
+      *link = _next;
+      break;
+    }
+  }
+  _next = nullptr;
+  _active = false;
+}
+
+unsigned long Ticker::msUntilNext(unsigned long now) {
+  unsigned long next = ~0UL;
+  for (Ticker* ticker = s_first; ticker; ticker = ticker->_next) {
+    long wait = static_cast<long>(ticker->_dueMs - now);
+    if (wait <= 0) {
+      return 0;
+    }
+    if (static_cast<unsigned long>(wait) < next) {
+      next = static_cast<unsigned long>(wait);
+    }
+  }
+  return next;
+}
+
+// A callback may arm or detach any ticker, so the walk restarts after each
+// one fires. Every ticker that fires is rescheduled past now, which bounds
+// the restarts.
+void Ticker::serviceAll(unsigned long now) {
+  bool fired = true;
+  while (fired) {
+    fired = false;
+    for (Ticker* ticker = s_first; ticker; ticker = ticker->_next) {
+      if (static_cast<long>(ticker->_dueMs - now) <= 0) {
+        ticker->fire(now);
+        fired = true;
+        break;
+      }
+    }
+  }
+}
+
+void Ticker::fire(unsigned long now) {
+  callback_t callback = _callback;
+  callback_with_arg_t callbackWithArg = _callbackWithArg;
+  void* arg = _arg;
+  if (_repeat && _periodMs > 0) {
+    _dueMs += _periodMs;
+    if (static_cast<long>(_dueMs - now) <= 0) {
+      _dueMs = now + _periodMs;
+    }
+  } else {
+    detach();
+  }
+  if (callback) {
+    callback();
+  } else if (callbackWithArg) {
+    callbackWithArg(arg);
+  }
+}
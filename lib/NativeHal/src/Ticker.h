@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Arduino.h>
+
+// os_timer stand-in. Callbacks run from NativeHal::service(), i.e. only
+// while the loop yields, delays or sleeps in esp_delay() -- the same points
+// at which the SDK runs timer callbacks on the device. A periodic timer that
+// falls behind fires once and realigns rather than bursting to catch up.
+class Ticker {
+public:
+  typedef void (*callback_t)();
+  typedef void (*callback_with_arg_t)(void*);
+
+  Ticker();
+  ~Ticker();
+  Ticker(const Ticker&) = delete;
+  Ticker& operator=(const Ticker&) = delete;
+
+  void attach_ms(uint32_t milliseconds, callback_t callback) { arm(milliseconds, true, callback, nullptr, nullptr); }
+  void once_ms(uint32_t milliseconds, callback_t callback) { arm(milliseconds, false, callback, nullptr, nullptr); }
+
+  template <typename TArg>
+  void attach_ms(uint32_t milliseconds, void (*callback)(TArg), TArg arg) {
+    static_assert(sizeof(TArg) <= sizeof(void*), "attach_ms() callback argument size must be <= sizeof(void*)");
+    arm(milliseconds, true, nullptr, reinterpret_cast<callback_with_arg_t>(callback), reinterpret_cast<void*>(arg));
+  }
+
+  template <typename TArg>
+  void once_ms(uint32_t milliseconds, void (*callback)(TArg), TArg arg) {
+    static_assert(sizeof(TArg) <= sizeof(void*), "once_ms() callback argument size must be <= sizeof(void*)");
+    arm(milliseconds, false, nullptr, reinterpret_cast<callback_with_arg_t>(callback), reinterpret_cast<void*>(arg));
+  }
+
+  void detach();
+  bool active() const { return _active; }
+
+  // Host side, driven by NativeHal.
+  static unsigned long msUntilNext(unsigned long now);
+  static void serviceAll(unsigned long now);
+
+private:
+  static Ticker* s_first;
+
+  Ticker* _next;
+  bool _active;
+  bool _repeat;
+  uint32_t _periodMs;
+  unsigned long _dueMs;
+  callback_t _callback;
+  callback_with_arg_t _callbackWithArg;
+  void* _arg;
+
+  void arm(uint32_t milliseconds, bool repeat, callback_t callback, callback_with_arg_t callbackWithArg, void* arg);
+  void fire(unsigned long now);
+};
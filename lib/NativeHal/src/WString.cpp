@@ -0,0 +1,56 @@
+#include "WString.h"
+#include <cctype>
+#include <cstring>
+
+namespace {
+std::string formatUnsigned(unsigned long value, unsigned char base) {
+  if (base < 2 || base > 36) {
+    base = 10;
+  }
+  // Filled from the end so the digits come out most significant first.
+  char digits[sizeof(unsigned long) * 8];
+  size_t start = sizeof(digits);
+  do {
+    unsigned long digit = value % base;
+    digits[--start] = static_cast<char>(digit < 10 ? '0' + digit : 'a' + digit - 10);
+    value /= base;
+  } while (value > 0);
+  return std::string(digits + start, sizeof(digits) - start);
+}
+
+std::string formatSigned(long value, unsigned char base) {
+  if (value < 0 && base == 10) {
+    return "-" + formatUnsigned(0UL - static_cast<unsigned long>(value), base);
+  }
+  return formatUnsigned(static_cast<unsigned long>(value), base);
+}
+}  // namespace
+
+String::String(int value, unsigned char base) : _text(formatSigned(value, base)) {}
+
+String::String(unsigned int value, unsigned char base) : _text(formatUnsigned(value, base)) {}
+
+String::String(long value, unsigned char base) : _text(formatSigned(value, base)) {}
+
+String::String(unsigned long value, unsigned char base) : _text(formatUnsigned(value, base)) {}
+
+void String::trim() {
+  size_t start = 0;
+  while (start < _text.size() && isspace(static_cast<unsigned char>(_text[start]))) {
+    ++start;
+  }
+  size_t end = _text.size();
+  while (end > start && isspace(static_cast<unsigned char>(_text[end - 1]))) {
+    --end;
+  }
+  _text = _text.substr(start, end - start);
+}
+
+void String::toCharArray(char* buffer, unsigned int size) const {
+  if (!buffer || size == 0) {
+    return;
+  }
+  size_t length = _text.size() < size - 1 ? _text.size() : size - 1;
+  memcpy(buffer, _text.data(), length);
+  buffer[length] = '\0';
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+class __FlashStringHelper;
+
+// Arduino String over std::string, limited to the members DeviceCore and
+// the stand-in libraries call.
+class String {
+public:
+  String(const char* text = "") : _text(text ? text : "") {}
+  String(const __FlashStringHelper* text) : String(reinterpret_cast<const char*>(text)) {}
+  explicit String(char value) : _text(1, value) {}
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+
+  bool reserve(unsigned int size) {
+    _text.reserve(size);
+    return true;
+  }
+  unsigned int length() const { return static_cast<unsigned int>(_text.size()); }
+  const char* c_str() const { return _text.c_str(); }
+  bool isEmpty() const { return _text.empty(); }
+  char operator[](unsigned int index) const { return index < _text.size() ? _text[index] : '\0'; }
+
+  String& operator=(const char* text) {
+    _text = text ? text : "";
+    return *this;
+  }
+  String& operator+=(const String& other) {
+    _text += other._text;
+    return *this;
+  }
+  String& operator+=(const char* text) {
+    _text += text ? text : "";
+    return *this;
+  }
+  String& operator+=(char value) {
+    _text += value;
+    return *this;
+  }
+  String& operator+=(int value) { return *this += String(value); }
+  String& operator+=(unsigned int value) { return *this += String(value); }
+  String& operator+=(long value) { return *this += String(value); }
+  String& operator+=(unsigned long value) { return *this += String(value); }
+  bool concat(const char* text) {
+    *this += text;
+    return true;
+  }
+
+  friend String operator+(const String& left, const String& right) {
+    String result(left);
+    result += right;
+    return result;
+  }
+  friend String operator+(const String& left, const char* right) {
+    String result(left);
+    result += right;
+    return result;
+  }
+  friend String operator+(const char* left, const String& right) {
+    String result(left);
+    result += right;
+    return result;
+  }
+
+  bool equals(const char* text) const { return _text == (text ? text : ""); }
+  bool operator==(const String& other) const { return _text == other._text; }
+  bool operator==(const char* text) const { return equals(text); }
+  bool operator!=(const String& other) const { return !(*this == other); }
+  bool operator!=(const char* text) const { return !equals(text); }
+
+  void trim();
+  void toCharArray(char* buffer, unsigned int size) const;
+
+private:
+  std::string _text;
+};
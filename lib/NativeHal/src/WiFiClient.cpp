@@ -0,0 +1,155 @@
+#include "WiFiClient.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+WiFiClient::WiFiClient() : _fd(-1), _noDelay(false) {}
+
+WiFiClient::~WiFiClient() {
+  stop();
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+  stop();
+  _fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (_fd < 0) {
+    return 0;
+  }
+  setNoDelay(_noDelay);
+
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = static_cast<uint32_t>(ip);
+  if (::connect(_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+    return 1;
+  }
+  int error = errno;
+  if (error == EINPROGRESS && waitFor(POLLOUT)) {
+    socklen_t length = sizeof(error);
+    if (getsockopt(_fd, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0) {
+      return 1;
+    }
+  }
+  stop();
+  return 0;
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+  IPAddress ip;
+  if (ip.fromString(host)) {
+    return connect(ip, port);
+  }
+
+  addrinfo hints = {};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* results = nullptr;
+  if (!host || getaddrinfo(host, nullptr, &hints, &results) != 0 || !results) {
+    return 0;
+  }
+  ip = IPAddress(static_cast<uint32_t>(reinterpret_cast<sockaddr_in*>(results->ai_addr)->sin_addr.s_addr));
+  freeaddrinfo(results);
+  return connect(ip, port);
+}
+
+size_t WiFiClient::write(uint8_t value) {
+  return write(&value, 1);
+}
+
+size_t WiFiClient::write(const uint8_t* buffer, size_t size) {
+  size_t written = 0;
+  while (_fd >= 0 && written < size) {
+    ssize_t result = send(_fd, buffer + written, size - written, MSG_NOSIGNAL);
+    if (result > 0) {
+      written += static_cast<size_t>(result);
+      continue;
+    }
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && waitFor(POLLOUT)) {
+      continue;
+    }
+    stop();
+  }
+  return written;
+}
+
+int WiFiClient::available() {
+  int pending = 0;
+  if (_fd < 0 || ioctl(_fd, FIONREAD, &pending) != 0) {
+    return 0;
+  }
+  return pending;
+}
+
+int WiFiClient::read() {
+  uint8_t value;
+  return read(&value, 1) == 1 ? value : -1;
+}
+
+int WiFiClient::read(uint8_t* buffer, size_t size) {
+  if (_fd < 0) {
+    return 0;
+  }
+  ssize_t result = recv(_fd, buffer, size, MSG_DONTWAIT);
+  return result > 0 ? static_cast<int>(result) : 0;
+}
+
+int WiFiClient::peek() {
+  uint8_t value;
+  if (_fd < 0 || recv(_fd, &value, 1, MSG_PEEK | MSG_DONTWAIT) != 1) {
+    return -1;
+  }
+  return value;
+}
+
+void WiFiClient::stop() {
+  if (_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+}
+
+// Like the device, still connected while unread data remains after the
+// peer has closed.
+uint8_t WiFiClient::connected() {
+  if (_fd < 0) {
+    return 0;
+  }
+  uint8_t value;
+  ssize_t result = recv(_fd, &value, 1, MSG_PEEK | MSG_DONTWAIT);
+  if (result > 0) {
+    return 1;
+  }
+  if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+    return 1;
+  }
+  return 0;
+}
+
+void WiFiClient::setNoDelay(bool noDelay) {
+  _noDelay = noDelay;
+  if (_fd >= 0) {
+    int flag = noDelay ? 1 : 0;
+    setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+  }
+}
+
+bool WiFiClient::waitFor(short events) {
+  pollfd entry = {_fd, events, 0};
+  int timeout = _timeout > 0x7FFFFFFFUL ? -1 : static_cast<int>(_timeout);
+  int result;
+  do {
+    result = poll(&entry, 1, timeout);
+  } while (result < 0 && errno == EINTR);
+  return result > 0 && (entry.revents & events) != 0;
+}
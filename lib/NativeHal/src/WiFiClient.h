@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Client.h"
+
+// TCP client on a host socket. connect() and write() block for at most the
+// Stream timeout, as lwIP's do on the device; reads never block.
+class WiFiClient : public Client {
+public:
+  WiFiClient();
+  ~WiFiClient() override;
+  WiFiClient(const WiFiClient&) = delete;
+  WiFiClient& operator=(const WiFiClient&) = delete;
+
+  int connect(IPAddress ip, uint16_t port) override;
+  // Dotted-quad hosts are parsed in place; only names go through the
+  // resolver, which allocates.
+  int connect(const char* host, uint16_t port) override;
+  size_t write(uint8_t value) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int read(uint8_t* buffer, size_t size) override;
+  int peek() override;
+  void flush() override {}
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override { return connected(); }
+  void setNoDelay(bool noDelay);
+
+private:
+  int _fd;
+  bool _noDelay;
+
+  bool waitFor(short events);
+};
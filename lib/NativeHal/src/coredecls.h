@@ -0,0 +1,25 @@
+#pragma once
+
+#include <Arduino.h>
+#include "NativeHal.h"
+
+// Wakes a loop suspended in esp_delay(). The loop thread re-checks its
+// predicate after every timer it services, so there is nothing to signal.
+inline void esp_schedule() {}
+
+void esp_delay(unsigned long ms);
+
+// Waits until blocked() returns false or timeoutMs passes, re-checking at
+// least every intervalMs and after any timer fires in between.
+template <typename T>
+void esp_delay(const uint32_t timeoutMs, T&& blocked, const uint32_t intervalMs) {
+  const unsigned long start = millis();
+  while (blocked()) {
+    unsigned long elapsed = millis() - start;
+    if (elapsed >= timeoutMs) {
+      return;
+    }
+    unsigned long remaining = timeoutMs - elapsed;
+    NativeHal::idle(remaining < intervalMs ? remaining : intervalMs);
+  }
+}
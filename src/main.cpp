@@ -1,15 +1,27 @@
 #include <Arduino.h>
 #include <DeviceCore.h>
 
+#ifndef MQTT_SERVER
+#define MQTT_SERVER "broker.emqx.io"
+#endif
+
+#ifndef WIFI_SSID
+#define WIFI_SSID ""
+#endif
+
+#ifndef WIFI_PASSWORD
+#define WIFI_PASSWORD ""
+#endif
+
 using DeviceCore::DeviceConfig;
 using DeviceCore::DeviceController;
 
 namespace {
 
 DeviceConfig kDeviceConfig = {
-  "",                             // ssid (empty -> requires provisioning)
-  "",                             // password
-  "broker.emqx.io",              // mqttServer
+  WIFI_SSID,                      // ssid (empty -> requires provisioning)
+  WIFI_PASSWORD,                  // password
+  MQTT_SERVER,                    // mqttServer
   1883,                           // mqttPort
   "mah1ro_esp32",                // clientId
   "esp32/test/mah1ro",           // primaryTopic
@@ -21,7 +33,28 @@ DeviceConfig kDeviceConfig = {
   150UL,                          // user1PulseDuration
   150UL,                          // errPulseDuration
   256,                            // serialBufferLimit
-  115200UL                        // serialBaud
+  115200UL,                       // serialBaud
+  nullptr,                        // maintenancePhone
+  nullptr,                        // userManualUrl
+  1024,                           // serialRxDepth (bytes, power of two)
+  65536,                          // offlineQueueBytes (LittleFS budget)
+  0,                              // serialBatchMaxBytes (0 -> one publish per line)
+  50UL,                           // serialBatchMaxLatencyMs
+  0,                              // mqttQos for forwarded serial data (0 or 1)
+  4,                              // mqttInflightWindow (unacknowledged QoS 1 publishes)
+  nullptr,                        // modbusBlocks (nullptr -> no Modbus polling)
+  0,                              // modbusBlockCount
+  "esp32/test/mah1ro/modbus",    // modbusTopic
+  0xFF,                           // modbusDePin (0xFF -> auto-direction transceiver)
+  100UL,                          // modbusTimeoutMs
+  nullptr,                        // modbusRequestTopic (nullptr -> no MQTT gateway; only set on an authenticated broker)
+  "esp32/test/mah1ro/modbus/resp",  // modbusResponseTopic
+  DeviceCore::kLogSinkRing,       // logSinks (kLogSinkMqtt publishes to logTopic; kLogSinkSerial1 shares GPIO2 with pinErr)
+  "esp32/test/mah1ro/log",       // logTopic
+  "esp32/test/mah1ro/metrics",   // metricsTopic
+  60000UL,                        // metricsIntervalMs (0 -> only on "metrics/get")
+  4096,                           // heapAlarmMinBlock (largest free block, bytes; 0 -> no alarm)
+  nullptr                         // configTopic (nullptr -> no runtime config; only set on an authenticated broker)
 };
 
 DeviceController controller(kDeviceConfig);
@@ -0,0 +1,125 @@
+#include <DeviceCore.h>
+#include <chrono>
+#include <cstdio>
+#include <unity.h>
+
+// Handles the same inbound command payloads with CommandDispatcher and with
+// the String and JsonDocument handler it replaced, and reports commands/sec
+// and heap allocations per command. Allocation counts need the
+// native_alloccheck environment:
+//   pio test -e native_alloccheck -f test_bench_command_dispatch -v
+
+using namespace DeviceCore;
+
+namespace {
+constexpr size_t kRounds = 20000;
+constexpr const char* kTopic = "bench/cmd";
+const char* const kPayloads[] = {
+    "{\"cmd\":\"heartbeat\",\"enable\":true}",
+    "{\"cmd\":\"heartbeat\",\"enable\":false}",
+    "{\"cmd\":\"settings/get\"}",
+    "{\"cmd\":\"modbus/read\",\"slave\":1,\"function\":3,\"start\":100,\"count\":4}",
+};
+constexpr size_t kPayloadCount = sizeof(kPayloads) / sizeof(kPayloads[0]);
+
+struct Result {
+  double seconds;
+  uint32_t allocations;
+  uint32_t handled;
+};
+
+bool s_heartbeat = false;
+uint32_t s_handled = 0;
+
+uint32_t allocations() {
+  return AllocTrace::totals(AllocTrace::kOutsideTasks).allocations;
+}
+
+// DeviceController::onMqttMessage before the dispatcher: the payload is
+// echoed and copied into a String a byte at a time, then parsed into a
+// heap-backed JsonDocument to look for the one command it knew.
+void legacyHandler(const char* topic, const uint8_t* payload, size_t length) {
+  Serial.print("Message arrived [");
+  Serial.print(topic);
+  Serial.print("]: ");
+  String msg;
+  for (size_t i = 0; i < length; ++i) {
+    Serial.print(static_cast<char>(payload[i]));
+    msg += static_cast<char>(payload[i]);
+  }
+  Serial.println();
+
+  JsonDocument doc;
+  if (deserializeJson(doc, msg) == DeserializationError::Ok) {
+    if (doc["cmd"] == "heartbeat") {
+      s_heartbeat = doc["enable"];
+      ++s_handled;
+    } else if (!doc["cmd"].isNull()) {
+      ++s_handled;
+    }
+  }
+}
+
+void onHeartbeat(void* context, JsonVariantConst message) {
+  s_heartbeat = message["enable"] | false;
+  ++s_handled;
+}
+
+void onCommand(void* context, JsonVariantConst message) {
+  ++s_handled;
+}
+
+template <typename Handle>
+Result run(Handle handle) {
+  s_handled = 0;
+  uint32_t before = allocations();
+  auto start = std::chrono::steady_clock::now();
+  for (size_t round = 0; round < kRounds; ++round) {
+    const char* payload = kPayloads[round % kPayloadCount];
+    handle(reinterpret_cast<const uint8_t*>(payload), strlen(payload));
+  }
+  Result result;
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  result.allocations = allocations() - before;
+  result.handled = s_handled;
+  return result;
+}
+
+void report(const char* name, const Result& result) {
+  char allocs[24] = "n/a";
+  if (AllocTrace::enabled()) {
+    snprintf(allocs, sizeof(allocs), "%.2f", static_cast<double>(result.allocations) / kRounds);
+  }
+  printf("%-18s %10.0f commands/s  allocations/command %s\n", name, kRounds / result.seconds, allocs);
+}
+}  // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_legacy_handler() {
+  Result result = run([](const uint8_t* payload, size_t length) { legacyHandler(kTopic, payload, length); });
+  report("String+JsonDocument", result);
+  TEST_ASSERT_EQUAL_UINT32(kRounds, result.handled);
+}
+
+void test_command_dispatcher() {
+  static CommandDispatcher dispatcher;
+  TEST_ASSERT_TRUE(dispatcher.add(nullptr, "heartbeat", &onHeartbeat, nullptr));
+  TEST_ASSERT_TRUE(dispatcher.add(nullptr, "settings/get", &onCommand, nullptr));
+  TEST_ASSERT_TRUE(dispatcher.add(kTopic, "modbus/read", &onCommand, nullptr));
+
+  Result result = run([](const uint8_t* payload, size_t length) { dispatcher.dispatch(kTopic, payload, length); });
+  report("CommandDispatcher", result);
+  TEST_ASSERT_EQUAL_UINT32(kRounds, result.handled);
+  if (AllocTrace::enabled()) {
+    TEST_ASSERT_EQUAL_UINT32(0, result.allocations);
+  }
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_legacy_handler);
+  RUN_TEST(test_command_dispatcher);
+  return UNITY_END();
+}
@@ -0,0 +1,211 @@
+#include <DeviceCore.h>
+#include <NativeHal.h>
+#include <PubSubClient.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <memory>
+#include <unistd.h>
+#include <unity.h>
+
+// Forwards the same stream of short lines, arriving at 115200 baud, with
+// batching off, with the default 1 KB / 50 ms window and with a 200-byte
+// window that fills before the timer runs out, and reports messages/sec,
+// MQTT packets and bytes on the wire for each:
+//   pio test -e native -f test_bench_serial_batching -v
+
+using namespace DeviceCore;
+
+namespace {
+constexpr size_t kLines = 5000;
+constexpr size_t kLineBytes = 40;  // including the '\n'
+constexpr uint32_t kTickMs = 5;
+// 115200 baud, 10 bits per byte, per tick.
+constexpr size_t kBytesPerTick = 115200 / 10 * kTickMs / 1000;
+constexpr const char* kTopic = "bench/serial";
+
+// Broker stand-in: accepts the CONNECT, then splits what follows into MQTT
+// packets and counts them, their bytes and the PUBLISH payload bytes.
+class CountingClient : public Client {
+public:
+  int connect(IPAddress ip, uint16_t port) override { return 1; }
+  int connect(const char* host, uint16_t port) override { return 1; }
+  size_t write(uint8_t value) override { return write(&value, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    if (!_session) {
+      _session = true;
+      _replyLength = sizeof(kConnack);
+      return size;
+    }
+    wireBytes += size;
+    for (size_t i = 0; i < size; ++i) {
+      consume(buffer[i]);
+    }
+    return size;
+  }
+  int available() override { return static_cast<int>(_replyLength); }
+  int read() override { return _replyLength ? kConnack[sizeof(kConnack) - _replyLength--] : -1; }
+  int read(uint8_t* buffer, size_t size) override {
+    size_t count = 0;
+    while (count < size && _replyLength) {
+      buffer[count++] = static_cast<uint8_t>(read());
+    }
+    return static_cast<int>(count);
+  }
+  int peek() override { return _replyLength ? kConnack[sizeof(kConnack) - _replyLength] : -1; }
+  void flush() override {}
+  void stop() override { _session = false; }
+  uint8_t connected() override { return 1; }
+  operator bool() override { return true; }
+
+  size_t wireBytes = 0;
+  size_t packets = 0;
+  size_t payloadBytes = 0;
+  size_t largestPayload = 0;
+
+private:
+  static constexpr uint8_t kConnack[4] = {0x20, 0x02, 0x00, 0x00};
+  bool _session = false;
+  size_t _replyLength = 0;
+  // Fixed header parser state.
+  bool _inHeader = true;
+  bool _haveType = false;
+  size_t _remaining = 0;
+  size_t _shift = 0;
+
+  void consume(uint8_t value) {
+    if (!_inHeader) {
+      if (--_remaining == 0) {
+        _inHeader = true;
+      }
+      return;
+    }
+    if (!_haveType) {
+      _haveType = true;
+      _remaining = 0;
+      _shift = 0;
+      ++packets;
+      return;
+    }
+    _remaining |= static_cast<size_t>(value & 0x7F) << _shift;
+    _shift += 7;
+    if (value & 0x80) {
+      return;
+    }
+    _haveType = false;
+    // QoS 0 PUBLISH: two length bytes and the topic ahead of the payload.
+    size_t payload = _remaining - 2 - strlen(kTopic);
+    payloadBytes += payload;
+    largestPayload = payload > largestPayload ? payload : largestPayload;
+    _inHeader = _remaining == 0;
+  }
+};
+
+constexpr uint8_t CountingClient::kConnack[4];
+
+NativeHal::ManualClock s_clock;
+int s_pipe[2] = {-1, -1};
+char s_input[kLines * kLineBytes];
+
+void buildInput() {
+  for (size_t i = 0; i < kLines; ++i) {
+    char* line = s_input + i * kLineBytes;
+    snprintf(line, kLineBytes, "%06u,t=21.5,h=40.2,p=1013.2", static_cast<unsigned>(i));
+    memset(line + strlen(line), '.', kLineBytes - 1 - strlen(line));
+    line[kLineBytes - 1] = '\n';
+  }
+}
+
+void runForwarder(const char* name, size_t batchMaxBytes) {
+  DeviceConfig config = {};
+  config.serialTopic = kTopic;
+  config.primaryTopic = kTopic;
+  config.serialBufferLimit = 256;
+  config.serialRxDepth = SerialIngest::kCapacity;
+  config.serialBatchMaxBytes = batchMaxBytes;
+  config.serialBatchMaxLatencyMs = 50;
+
+  CountingClient wire;
+  PubSubClient client(wire);
+  AsyncTcpClient socket;
+  MqttLayer mqtt(client, socket, config);
+  mqtt.begin(nullptr);
+  TEST_ASSERT_TRUE(client.connect("bench"));
+  LedSubsystem leds(0, 0, 0, 0);
+  std::unique_ptr<SerialForwarder> forwarder(new SerialForwarder(config.serialBufferLimit));
+  forwarder->begin(Serial, config.serialRxDepth, 0);
+
+  auto step = [&]() {
+    s_clock.advanceUs(kTickMs * 1000ULL);
+    NativeHal::service();
+    forwarder->process(millis(), config, true, true, mqtt, leds);
+  };
+  auto start = std::chrono::steady_clock::now();
+  for (size_t offset = 0; offset < sizeof(s_input); offset += kBytesPerTick) {
+    size_t chunk = sizeof(s_input) - offset < kBytesPerTick ? sizeof(s_input) - offset : kBytesPerTick;
+    TEST_ASSERT_EQUAL(static_cast<ssize_t>(chunk), write(s_pipe[1], s_input + offset, chunk));
+    step();
+  }
+  // Let the last window close.
+  for (uint32_t waited = 0; waited < config.serialBatchMaxLatencyMs + kTickMs; waited += kTickMs) {
+    step();
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printf("%-10s %9.0f lines/s  %6zu packets  %8zu bytes on the wire  %5.2f bytes/line overhead\n", name,
+         kLines / seconds, wire.packets, wire.wireBytes,
+         static_cast<double>(wire.wireBytes - kLines * (kLineBytes - 1)) / kLines);
+
+  // Every line arrived once; a batch carries a '\n' between its lines.
+  TEST_ASSERT_EQUAL_size_t(kLines * kLineBytes, wire.payloadBytes + wire.packets);
+  if (batchMaxBytes == 0) {
+    TEST_ASSERT_EQUAL_size_t(kLines, wire.packets);
+  } else {
+    TEST_ASSERT_LESS_THAN(kLines / 4, wire.packets);
+    TEST_ASSERT_LESS_OR_EQUAL(batchMaxBytes, wire.largestPayload);
+  }
+}
+}  // namespace
+
+void setUp() {
+  TEST_ASSERT_EQUAL(0, pipe2(s_pipe, O_NONBLOCK | O_CLOEXEC));
+  Serial.attach(s_pipe[0], -1, false);
+  Serial.begin(115200);
+}
+
+void tearDown() {
+  close(s_pipe[0]);
+  close(s_pipe[1]);
+}
+
+void test_unbatched() {
+  runForwarder("unbatched", 0);
+}
+
+void test_batched() {
+  runForwarder("batched", 1024);
+}
+
+void test_batched_by_size() {
+  runForwarder("by size", 200);
+}
+
+int main(int argc, char** argv) {
+  char stateDir[] = "/tmp/devicecore-bench-XXXXXX";
+  if (!mkdtemp(stateDir)) {
+    perror("mkdtemp");
+    return 1;
+  }
+  setenv("DEVICECORE_NATIVE_STATE", stateDir, 1);
+  setenv("DEVICECORE_NATIVE_UART", "/dev/null", 1);
+  NativeHal::setClock(s_clock);
+  NativeHal::begin(argc, argv);
+  buildInput();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_unbatched);
+  RUN_TEST(test_batched);
+  RUN_TEST(test_batched_by_size);
+  return UNITY_END();
+}
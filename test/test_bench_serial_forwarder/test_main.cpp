@@ -0,0 +1,219 @@
+#include <DeviceCore.h>
+#include <NativeHal.h>
+#include <PubSubClient.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <memory>
+#include <unistd.h>
+#include <unity.h>
+
+// Forwards the same UART stream through SerialForwarder and through the
+// String-based forwarder it replaced, and reports bytes/sec and heap
+// allocations for each. Allocation counts need the native_alloccheck
+// environment:
+//   pio test -e native_alloccheck -f test_bench_serial_forwarder -v
+
+using namespace DeviceCore;
+
+namespace {
+constexpr size_t kLines = 20000;
+constexpr size_t kLineBytes = 64;  // including the '\n'
+constexpr size_t kChunkBytes = 1024;
+constexpr uint32_t kTickMs = 5;
+constexpr const char* kTopic = "bench/serial";
+
+// Broker stand-in: accepts the CONNECT and counts every byte sent after it.
+class CountingClient : public Client {
+public:
+  int connect(IPAddress ip, uint16_t port) override { return 1; }
+  int connect(const char* host, uint16_t port) override { return 1; }
+  size_t write(uint8_t value) override { return write(&value, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    if (!_session) {
+      _session = true;
+      _replyLength = sizeof(kConnack);
+      return size;
+    }
+    wireBytes += size;
+    return size;
+  }
+  int available() override { return static_cast<int>(_replyLength); }
+  int read() override { return _replyLength ? kConnack[sizeof(kConnack) - _replyLength--] : -1; }
+  int read(uint8_t* buffer, size_t size) override {
+    size_t count = 0;
+    while (count < size && _replyLength) {
+      buffer[count++] = static_cast<uint8_t>(read());
+    }
+    return static_cast<int>(count);
+  }
+  int peek() override { return _replyLength ? kConnack[sizeof(kConnack) - _replyLength] : -1; }
+  void flush() override {}
+  void stop() override { _session = false; }
+  uint8_t connected() override { return 1; }
+  operator bool() override { return true; }
+
+  size_t wireBytes = 0;
+
+private:
+  static constexpr uint8_t kConnack[4] = {0x20, 0x02, 0x00, 0x00};
+  bool _session = false;
+  size_t _replyLength = 0;
+};
+
+constexpr uint8_t CountingClient::kConnack[4];
+
+// SerialForwarder as it was before the fixed line buffer: a String grown a
+// character at a time, published with PubSubClient, echoed to the UART and
+// reset with "".
+class StringForwarder {
+public:
+  explicit StringForwarder(size_t bufferLimit) : _bufferLimit(bufferLimit) { _buffer.reserve(_bufferLimit); }
+
+  void process(PubSubClient& client) {
+    while (Serial.available() > 0) {
+      char ch = static_cast<char>(Serial.read());
+      if (ch == '\r' || ch == '\n') {
+        if (_buffer.length() > 0) {
+          client.publish(kTopic, _buffer.c_str());
+          Serial.print("Forwarded serial: ");
+          Serial.println(_buffer);
+          _buffer = "";
+        }
+        continue;
+      }
+      if (_buffer.length() < _bufferLimit) {
+        _buffer += ch;
+      }
+    }
+  }
+
+private:
+  String _buffer;
+  size_t _bufferLimit;
+};
+
+struct Result {
+  double seconds;
+  uint32_t allocations;
+  size_t wireBytes;
+};
+
+NativeHal::ManualClock s_clock;
+int s_pipe[2] = {-1, -1};
+char s_input[kLines * kLineBytes];
+
+uint32_t allocations() {
+  return AllocTrace::totals(AllocTrace::kOutsideTasks).allocations;
+}
+
+void buildInput() {
+  for (size_t i = 0; i < kLines; ++i) {
+    char* line = s_input + i * kLineBytes;
+    snprintf(line, kLineBytes, "%06u,temperature=21.5,humidity=40.2,pressure=1013.2,ok", static_cast<unsigned>(i));
+    memset(line + strlen(line), '.', kLineBytes - 1 - strlen(line));
+    line[kLineBytes - 1] = '\n';
+  }
+}
+
+// Feeds the input a chunk per tick, as a UART at well over 1 Mbaud would,
+// and calls step() after each tick's timers have run.
+template <typename Step>
+Result run(CountingClient& wire, Step step) {
+  Result result;
+  uint32_t before = allocations();
+  auto start = std::chrono::steady_clock::now();
+  for (size_t offset = 0; offset < sizeof(s_input); offset += kChunkBytes) {
+    size_t chunk = sizeof(s_input) - offset < kChunkBytes ? sizeof(s_input) - offset : kChunkBytes;
+    TEST_ASSERT_EQUAL(static_cast<ssize_t>(chunk), write(s_pipe[1], s_input + offset, chunk));
+    s_clock.advanceUs(kTickMs * 1000ULL);
+    NativeHal::service();
+    step();
+  }
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  result.allocations = allocations() - before;
+  result.wireBytes = wire.wireBytes;
+  return result;
+}
+
+void report(const char* name, const Result& result) {
+  char allocs[24] = "n/a";
+  if (AllocTrace::enabled()) {
+    snprintf(allocs, sizeof(allocs), "%.3f", static_cast<double>(result.allocations) / kLines);
+  }
+  printf("%-16s %10.0f bytes/s  %8.0f lines/s  allocations/line %s\n", name,
+         sizeof(s_input) / result.seconds, kLines / result.seconds, allocs);
+}
+
+size_t expectedWireBytes() {
+  size_t remaining = 2 + strlen(kTopic) + (kLineBytes - 1);
+  return kLines * (1 + (remaining < 128 ? 1 : 2) + remaining);
+}
+}  // namespace
+
+void setUp() {
+  TEST_ASSERT_EQUAL(0, pipe2(s_pipe, O_NONBLOCK | O_CLOEXEC));
+  Serial.attach(s_pipe[0], -1, false);
+  Serial.setRxBufferSize(HardwareSerial::kMaxRxBufferSize);
+  Serial.begin(115200);
+}
+
+void tearDown() {
+  close(s_pipe[0]);
+  close(s_pipe[1]);
+}
+
+void test_string_forwarder() {
+  CountingClient wire;
+  PubSubClient client(wire);
+  TEST_ASSERT_TRUE(client.connect("bench"));
+  StringForwarder forwarder(256);
+  Result result = run(wire, [&]() { forwarder.process(client); });
+  report("String", result);
+  TEST_ASSERT_EQUAL_size_t(expectedWireBytes(), result.wireBytes);
+}
+
+void test_serial_forwarder() {
+  DeviceConfig config = {};
+  config.serialTopic = kTopic;
+  config.primaryTopic = kTopic;
+  config.serialBufferLimit = 256;
+  config.serialRxDepth = SerialIngest::kCapacity;
+
+  CountingClient wire;
+  PubSubClient client(wire);
+  AsyncTcpClient socket;
+  MqttLayer mqtt(client, socket, config);
+  mqtt.begin(nullptr);
+  TEST_ASSERT_TRUE(client.connect("bench"));
+  LedSubsystem leds(0, 0, 0, 0);
+  std::unique_ptr<SerialForwarder> forwarder(new SerialForwarder(config.serialBufferLimit));
+  forwarder->begin(Serial, config.serialRxDepth, 0);
+
+  Result result = run(wire, [&]() { forwarder->process(millis(), config, true, true, mqtt, leds); });
+  report("SerialForwarder", result);
+  TEST_ASSERT_EQUAL_size_t(expectedWireBytes(), result.wireBytes);
+  TEST_ASSERT_EQUAL_UINT32(0, forwarder->droppedBytes());
+  if (AllocTrace::enabled()) {
+    TEST_ASSERT_EQUAL_UINT32(0, result.allocations);
+  }
+}
+
+int main(int argc, char** argv) {
+  char stateDir[] = "/tmp/devicecore-bench-XXXXXX";
+  if (!mkdtemp(stateDir)) {
+    perror("mkdtemp");
+    return 1;
+  }
+  setenv("DEVICECORE_NATIVE_STATE", stateDir, 1);
+  setenv("DEVICECORE_NATIVE_UART", "/dev/null", 1);
+  NativeHal::setClock(s_clock);
+  NativeHal::begin(argc, argv);
+  buildInput();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_string_forwarder);
+  RUN_TEST(test_serial_forwarder);
+  return UNITY_END();
+}
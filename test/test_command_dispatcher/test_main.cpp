@@ -0,0 +1,124 @@
+#include <DeviceCore.h>
+#include <unity.h>
+
+using DeviceCore::CommandDispatcher;
+
+namespace {
+struct Calls {
+  int count;
+  int value;
+};
+
+Calls s_topicCalls;
+Calls s_anyCalls;
+
+void onCommand(void* context, JsonVariantConst message) {
+  Calls* calls = static_cast<Calls*>(context);
+  ++calls->count;
+  calls->value = message["value"] | -1;
+}
+
+bool dispatch(CommandDispatcher& dispatcher, const char* topic, const char* payload) {
+  return dispatcher.dispatch(topic, reinterpret_cast<const uint8_t*>(payload), strlen(payload));
+}
+}  // namespace
+
+void setUp() {
+  s_topicCalls = Calls();
+  s_anyCalls = Calls();
+}
+
+void tearDown() {}
+
+void test_topic_route_wins_over_wildcard() {
+  CommandDispatcher dispatcher;
+  TEST_ASSERT_TRUE(dispatcher.add("dev/a", "ping", &onCommand, &s_topicCalls));
+  TEST_ASSERT_TRUE(dispatcher.add(nullptr, "ping", &onCommand, &s_anyCalls));
+
+  TEST_ASSERT_TRUE(dispatch(dispatcher, "dev/a", "{\"cmd\":\"ping\",\"value\":7}"));
+  TEST_ASSERT_EQUAL(1, s_topicCalls.count);
+  TEST_ASSERT_EQUAL(7, s_topicCalls.value);
+  TEST_ASSERT_EQUAL(0, s_anyCalls.count);
+
+  TEST_ASSERT_TRUE(dispatch(dispatcher, "dev/b", "{\"cmd\":\"ping\"}"));
+  TEST_ASSERT_EQUAL(1, s_anyCalls.count);
+  TEST_ASSERT_EQUAL(-1, s_anyCalls.value);
+  TEST_ASSERT_EQUAL_UINT32(2, dispatcher.stats().dispatched);
+}
+
+void test_dedicated_topic_skips_wildcard_commands() {
+  CommandDispatcher dispatcher;
+  TEST_ASSERT_TRUE(dispatcher.add("dev/gateway", "read", &onCommand, &s_topicCalls));
+  TEST_ASSERT_TRUE(dispatcher.add(nullptr, "ping", &onCommand, &s_anyCalls));
+
+  // Commands registered for any topic stay off a topic with its own table.
+  TEST_ASSERT_FALSE(dispatch(dispatcher, "dev/gateway", "{\"cmd\":\"ping\"}"));
+  TEST_ASSERT_EQUAL(0, s_anyCalls.count);
+  TEST_ASSERT_EQUAL_UINT32(1, dispatcher.stats().unknown);
+
+  TEST_ASSERT_TRUE(dispatch(dispatcher, "dev/gateway", "{\"cmd\":\"read\"}"));
+  TEST_ASSERT_EQUAL(1, s_topicCalls.count);
+  TEST_ASSERT_TRUE(dispatch(dispatcher, "dev/a", "{\"cmd\":\"ping\"}"));
+  TEST_ASSERT_EQUAL(1, s_anyCalls.count);
+}
+
+void test_unknown_command_is_counted() {
+  CommandDispatcher dispatcher;
+  dispatcher.add(nullptr, "ping", &onCommand, &s_anyCalls);
+  TEST_ASSERT_FALSE(dispatch(dispatcher, "dev/a", "{\"cmd\":\"pong\"}"));
+  TEST_ASSERT_EQUAL(0, s_anyCalls.count);
+  TEST_ASSERT_EQUAL_UINT32(1, dispatcher.stats().unknown);
+}
+
+void test_only_json_looking_payloads_count_as_parse_errors() {
+  CommandDispatcher dispatcher;
+  dispatcher.add(nullptr, "ping", &onCommand, &s_anyCalls);
+  TEST_ASSERT_FALSE(dispatch(dispatcher, "dev/a", "{\"cmd\":"));
+  TEST_ASSERT_FALSE(dispatch(dispatcher, "dev/a", "plain text"));
+  TEST_ASSERT_EQUAL_UINT32(1, dispatcher.stats().parseErrors);
+}
+
+void test_payload_need_not_be_terminated() {
+  CommandDispatcher dispatcher;
+  dispatcher.add(nullptr, "ping", &onCommand, &s_anyCalls);
+  const char json[] = "{\"cmd\":\"ping\",\"value\":3}";
+  uint8_t payload[sizeof(json) - 1 + 8];
+  memcpy(payload, json, sizeof(json) - 1);
+  memset(payload + sizeof(json) - 1, '}', 8);
+  TEST_ASSERT_TRUE(dispatcher.dispatch("dev/a", payload, sizeof(json) - 1));
+  TEST_ASSERT_EQUAL(3, s_anyCalls.value);
+  DeviceCore::CommandStats stats = dispatcher.stats();
+  TEST_ASSERT_GREATER_THAN(0, stats.arenaHighWater);
+  TEST_ASSERT_LESS_OR_EQUAL(DeviceCore::CommandArena::kCapacity, stats.arenaHighWater);
+}
+
+void test_table_keeps_one_slot_free() {
+  static char names[CommandDispatcher::kSlots][8];
+  CommandDispatcher dispatcher;
+  for (size_t i = 0; i < CommandDispatcher::kSlots - 1; ++i) {
+    snprintf(names[i], sizeof(names[i]), "c%u", static_cast<unsigned>(i));
+    TEST_ASSERT_TRUE(dispatcher.add(nullptr, names[i], &onCommand, &s_anyCalls));
+  }
+  snprintf(names[CommandDispatcher::kSlots - 1], sizeof(names[0]), "extra");
+  TEST_ASSERT_FALSE(dispatcher.add(nullptr, names[CommandDispatcher::kSlots - 1], &onCommand, &s_anyCalls));
+
+  // Every registered command is still found, and none that is not.
+  char payload[32];
+  for (size_t i = 0; i < CommandDispatcher::kSlots - 1; ++i) {
+    snprintf(payload, sizeof(payload), "{\"cmd\":\"%s\"}", names[i]);
+    TEST_ASSERT_TRUE(dispatch(dispatcher, "dev/a", payload));
+  }
+  TEST_ASSERT_FALSE(dispatch(dispatcher, "dev/a", "{\"cmd\":\"extra\"}"));
+  TEST_ASSERT_EQUAL(static_cast<int>(CommandDispatcher::kSlots - 1), s_anyCalls.count);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_topic_route_wins_over_wildcard);
+  RUN_TEST(test_dedicated_topic_skips_wildcard_commands);
+  RUN_TEST(test_unknown_command_is_counted);
+  RUN_TEST(test_only_json_looking_payloads_count_as_parse_errors);
+  RUN_TEST(test_payload_need_not_be_terminated);
+  RUN_TEST(test_table_keeps_one_slot_free);
+  return UNITY_END();
+}
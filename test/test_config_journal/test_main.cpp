@@ -0,0 +1,208 @@
+#include <DeviceCore.h>
+#include <EEPROM.h>
+#include <LittleFS.h>
+#include <NativeHal.h>
+#include <cstdlib>
+#include <unity.h>
+
+using DeviceCore::ConfigJournal;
+using DeviceCore::PersistedConfig;
+
+namespace {
+constexpr const char* kJournalPath = "/cfg.jnl";
+// Pre-journal EEPROM layout: magic, SSID[32], password[64].
+constexpr size_t kLegacyEepromSize = 1 + 32 + 64;
+
+PersistedConfig network(const char* ssid, const char* password) {
+  PersistedConfig config;
+  strncpy(config.networks[0].ssid, ssid, sizeof(config.networks[0].ssid) - 1);
+  strncpy(config.networks[0].password, password, sizeof(config.networks[0].password) - 1);
+  config.networkCount = 1;
+  return config;
+}
+
+PersistedConfig numbered(int index) {
+  char ssid[16];
+  snprintf(ssid, sizeof(ssid), "net-%02d", index);
+  return network(ssid, "secret");
+}
+
+size_t journalSize() {
+  File file = LittleFS.open(kJournalPath, "r");
+  size_t size = file ? file.size() : 0;
+  file.close();
+  return size;
+}
+
+// Size of one record, measured from a scratch journal.
+size_t recordSize() {
+  ConfigJournal journal;
+  TEST_ASSERT_TRUE(journal.begin());
+  TEST_ASSERT_TRUE(journal.commit(numbered(0)));
+  size_t size = journalSize();
+  LittleFS.remove(kJournalPath);
+  return size;
+}
+
+void writeLegacyEeprom(uint8_t magic, const char* ssid, const char* password) {
+  EEPROM.begin(kLegacyEepromSize);
+  EEPROM.write(0, magic);
+  for (size_t i = 0; i < 32; ++i) {
+    EEPROM.write(1 + i, static_cast<uint8_t>(i < strlen(ssid) ? ssid[i] : 0));
+  }
+  for (size_t i = 0; i < 64; ++i) {
+    EEPROM.write(33 + i, static_cast<uint8_t>(i < strlen(password) ? password[i] : 0));
+  }
+  EEPROM.commit();
+  EEPROM.end();
+}
+}  // namespace
+
+void setUp() {
+  TEST_ASSERT_TRUE(LittleFS.begin());
+  LittleFS.remove(kJournalPath);
+  writeLegacyEeprom(0x00, "", "");
+}
+
+void tearDown() {}
+
+void test_commit_survives_restart() {
+  {
+    ConfigJournal journal;
+    TEST_ASSERT_TRUE(journal.begin());
+    TEST_ASSERT_TRUE(journal.commit(network("home", "secret")));
+  }
+  ConfigJournal journal;
+  TEST_ASSERT_TRUE(journal.begin());
+  TEST_ASSERT_TRUE(journal.current() == network("home", "secret"));
+  TEST_ASSERT_EQUAL_UINT32(1, journal.sequence());
+}
+
+void test_unchanged_commit_skips_flash() {
+  ConfigJournal journal;
+  TEST_ASSERT_TRUE(journal.begin());
+  TEST_ASSERT_TRUE(journal.commit(network("home", "secret")));
+  size_t size = journalSize();
+  TEST_ASSERT_TRUE(journal.commit(network("home", "secret")));
+  TEST_ASSERT_EQUAL_size_t(size, journalSize());
+  TEST_ASSERT_EQUAL_UINT32(1, journal.sequence());
+}
+
+void test_compacts_after_max_records() {
+  size_t record = recordSize();
+  const int commits = 40;
+  {
+    ConfigJournal journal;
+    TEST_ASSERT_TRUE(journal.begin());
+    for (int i = 1; i <= commits; ++i) {
+      TEST_ASSERT_TRUE(journal.commit(numbered(i)));
+      TEST_ASSERT_TRUE(journalSize() <= ConfigJournal::kMaxRecords * record);
+    }
+  }
+  // Compacted at commits 17 and 33, leaving 33..40.
+  TEST_ASSERT_EQUAL_size_t((commits - 2 * ConfigJournal::kMaxRecords) * record, journalSize());
+  ConfigJournal journal;
+  TEST_ASSERT_TRUE(journal.begin());
+  TEST_ASSERT_TRUE(journal.current() == numbered(commits));
+  TEST_ASSERT_EQUAL_UINT32(commits, journal.sequence());
+}
+
+void test_torn_tail_is_rewritten() {
+  size_t record = recordSize();
+  {
+    ConfigJournal journal;
+    TEST_ASSERT_TRUE(journal.begin());
+    for (int i = 1; i <= 3; ++i) {
+      TEST_ASSERT_TRUE(journal.commit(numbered(i)));
+    }
+  }
+  // Power lost partway through the fourth append.
+  File file = LittleFS.open(kJournalPath, "a");
+  uint8_t torn[32];
+  memset(torn, 0x5A, sizeof(torn));
+  file.write(torn, sizeof(torn));
+  file.close();
+
+  ConfigJournal journal;
+  TEST_ASSERT_TRUE(journal.begin());
+  TEST_ASSERT_TRUE(journal.current() == numbered(3));
+  TEST_ASSERT_EQUAL_size_t(record, journalSize());
+  // Appends line up with the record boundary again.
+  TEST_ASSERT_TRUE(journal.commit(numbered(4)));
+  TEST_ASSERT_EQUAL_size_t(2 * record, journalSize());
+  ConfigJournal reopened;
+  TEST_ASSERT_TRUE(reopened.begin());
+  TEST_ASSERT_TRUE(reopened.current() == numbered(4));
+}
+
+void test_corrupt_record_falls_back_to_previous() {
+  size_t record = recordSize();
+  {
+    ConfigJournal journal;
+    TEST_ASSERT_TRUE(journal.begin());
+    TEST_ASSERT_TRUE(journal.commit(numbered(1)));
+    TEST_ASSERT_TRUE(journal.commit(numbered(2)));
+  }
+  // Flip an SSID byte of the second record; its CRC no longer matches.
+  File file = LittleFS.open(kJournalPath, "r");
+  uint8_t bytes[2048];
+  TEST_ASSERT_TRUE(2 * record <= sizeof(bytes));
+  TEST_ASSERT_EQUAL_size_t(2 * record, file.read(bytes, 2 * record));
+  file.close();
+  bytes[record + 16] ^= 0xFF;
+  file = LittleFS.open(kJournalPath, "w");
+  file.write(bytes, 2 * record);
+  file.close();
+
+  ConfigJournal journal;
+  TEST_ASSERT_TRUE(journal.begin());
+  TEST_ASSERT_TRUE(journal.current() == numbered(1));
+  TEST_ASSERT_EQUAL_UINT32(1, journal.sequence());
+}
+
+void test_migrates_legacy_eeprom_credentials() {
+  writeLegacyEeprom(0xA5, "legacy", "oldpass");
+  {
+    ConfigJournal journal;
+    TEST_ASSERT_TRUE(journal.begin());
+    TEST_ASSERT_TRUE(journal.current() == network("legacy", "oldpass"));
+  }
+  // The EEPROM copy is retired once the journal holds it.
+  EEPROM.begin(kLegacyEepromSize);
+  TEST_ASSERT_EQUAL_UINT8(0, EEPROM.read(0));
+  EEPROM.end();
+
+  ConfigJournal journal;
+  TEST_ASSERT_TRUE(journal.begin());
+  TEST_ASSERT_TRUE(journal.current() == network("legacy", "oldpass"));
+  TEST_ASSERT_EQUAL_UINT32(1, journal.sequence());
+}
+
+void test_ignores_eeprom_without_magic() {
+  writeLegacyEeprom(0x00, "legacy", "oldpass");
+  ConfigJournal journal;
+  TEST_ASSERT_TRUE(journal.begin());
+  TEST_ASSERT_EQUAL_UINT8(0, journal.current().networkCount);
+  TEST_ASSERT_EQUAL_size_t(0, journalSize());
+}
+
+int main(int argc, char** argv) {
+  char stateDir[] = "/tmp/devicecore-test-XXXXXX";
+  if (!mkdtemp(stateDir)) {
+    perror("mkdtemp");
+    return 1;
+  }
+  setenv("DEVICECORE_NATIVE_STATE", stateDir, 1);
+  setenv("DEVICECORE_NATIVE_UART", "/dev/null", 1);
+  NativeHal::begin(argc, argv);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_commit_survives_restart);
+  RUN_TEST(test_unchanged_commit_skips_flash);
+  RUN_TEST(test_compacts_after_max_records);
+  RUN_TEST(test_torn_tail_is_rewritten);
+  RUN_TEST(test_corrupt_record_falls_back_to_previous);
+  RUN_TEST(test_migrates_legacy_eeprom_credentials);
+  RUN_TEST(test_ignores_eeprom_without_magic);
+  return UNITY_END();
+}
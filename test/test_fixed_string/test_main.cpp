@@ -0,0 +1,59 @@
+#include <DeviceCore.h>
+#include <unity.h>
+
+using DeviceCore::FixedString;
+
+void setUp() {}
+void tearDown() {}
+
+void test_append_fits() {
+  FixedString<8> text;
+  TEST_ASSERT_TRUE(text.empty());
+  TEST_ASSERT_TRUE(text.append("abc"));
+  TEST_ASSERT_TRUE(text.append('d'));
+  TEST_ASSERT_TRUE(text.append("efgh", 2));
+  TEST_ASSERT_EQUAL_STRING("abcdef", text.c_str());
+  TEST_ASSERT_EQUAL_size_t(6, text.length());
+  TEST_ASSERT_FALSE(text.overflowed());
+  TEST_ASSERT_TRUE(text == "abcdef");
+}
+
+void test_append_truncates_and_latches_overflow() {
+  FixedString<4> text;
+  TEST_ASSERT_FALSE(text.append("abcdef"));
+  TEST_ASSERT_EQUAL_STRING("abcd", text.c_str());
+  TEST_ASSERT_TRUE(text.overflowed());
+  // Stays set, so only the last append needs checking.
+  TEST_ASSERT_FALSE(text.append(""));
+  text.clear();
+  TEST_ASSERT_FALSE(text.overflowed());
+  TEST_ASSERT_TRUE(text.append("ab"));
+}
+
+void test_appendf_formats_and_truncates() {
+  FixedString<10> text("id=");
+  TEST_ASSERT_TRUE(text.appendf("%d,%s", 42, "ok"));
+  TEST_ASSERT_EQUAL_STRING("id=42,ok", text.c_str());
+  TEST_ASSERT_FALSE(text.appendf("%s", "-overflowing"));
+  TEST_ASSERT_EQUAL_size_t(10, text.length());
+  TEST_ASSERT_EQUAL_STRING("id=42,ok-o", text.c_str());
+}
+
+void test_truncate_undoes_an_append() {
+  FixedString<6> text("{\"a\":");
+  size_t mark = text.length();
+  TEST_ASSERT_FALSE(text.append("123"));
+  text.truncate(mark);
+  TEST_ASSERT_FALSE(text.overflowed());
+  TEST_ASSERT_EQUAL_STRING("{\"a\":", text.c_str());
+  TEST_ASSERT_TRUE(text.append('1'));
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_append_fits);
+  RUN_TEST(test_append_truncates_and_latches_overflow);
+  RUN_TEST(test_appendf_formats_and_truncates);
+  RUN_TEST(test_truncate_undoes_an_append);
+  return UNITY_END();
+}
@@ -0,0 +1,93 @@
+#include <DeviceCore.h>
+#include <unity.h>
+
+using DeviceCore::MqttInflightWindow;
+
+namespace {
+const uint8_t kPayload[] = {'4', '2'};
+}  // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_acquire_copies_and_release_frees() {
+  MqttInflightWindow window;
+  MqttInflightWindow::Entry* entry = window.acquire("dev/out", kPayload, sizeof(kPayload));
+  TEST_ASSERT_NOT_NULL(entry);
+  TEST_ASSERT_EQUAL_STRING("dev/out", entry->topic);
+  TEST_ASSERT_EQUAL(sizeof(kPayload), entry->length);
+  TEST_ASSERT_EQUAL_MEMORY(kPayload, entry->payload, sizeof(kPayload));
+  TEST_ASSERT_EQUAL_size_t(1, window.size());
+
+  uint16_t packetId = entry->packetId;
+  TEST_ASSERT_TRUE(window.release(packetId));
+  TEST_ASSERT_FALSE(window.release(packetId));
+  TEST_ASSERT_EQUAL_size_t(0, window.size());
+  TEST_ASSERT_EQUAL_UINT32(1, window.stats().published);
+  TEST_ASSERT_EQUAL_UINT32(1, window.stats().acked);
+}
+
+void test_window_limits_outstanding_publishes() {
+  MqttInflightWindow window;
+  window.setWindow(2);
+  TEST_ASSERT_NOT_NULL(window.acquire("t", kPayload, sizeof(kPayload)));
+  TEST_ASSERT_NOT_NULL(window.acquire("t", kPayload, sizeof(kPayload)));
+  TEST_ASSERT_TRUE(window.full());
+  TEST_ASSERT_NULL(window.acquire("t", kPayload, sizeof(kPayload)));
+  // Zero and oversized requests fall back to the pool size.
+  window.setWindow(0);
+  TEST_ASSERT_EQUAL_size_t(MqttInflightWindow::kMaxSlots, window.window());
+}
+
+void test_packet_ids_are_unique_and_nonzero() {
+  MqttInflightWindow window;
+  MqttInflightWindow::Entry* held = window.acquire("t", kPayload, sizeof(kPayload));
+  TEST_ASSERT_NOT_NULL(held);
+  // Cycle the other slots through the whole 16-bit id space.
+  for (uint32_t i = 0; i < 70000; ++i) {
+    MqttInflightWindow::Entry* entry = window.acquire("t", kPayload, sizeof(kPayload));
+    TEST_ASSERT_NOT_NULL(entry);
+    TEST_ASSERT_NOT_EQUAL(0, entry->packetId);
+    TEST_ASSERT_NOT_EQUAL(held->packetId, entry->packetId);
+    TEST_ASSERT_TRUE(window.release(entry->packetId));
+  }
+}
+
+void test_next_pending_visits_oldest_first() {
+  MqttInflightWindow window;
+  MqttInflightWindow::Entry* first = window.acquire("a", kPayload, sizeof(kPayload));
+  MqttInflightWindow::Entry* second = window.acquire("b", kPayload, sizeof(kPayload));
+  MqttInflightWindow::Entry* third = window.acquire("c", kPayload, sizeof(kPayload));
+  // Reusing the first slot must not move its successor ahead of the others.
+  window.release(first->packetId);
+  MqttInflightWindow::Entry* fourth = window.acquire("d", kPayload, sizeof(kPayload));
+
+  MqttInflightWindow::Entry* entry = window.nextPending(0);
+  TEST_ASSERT_EQUAL_PTR(second, entry);
+  entry = window.nextPending(entry->sequence);
+  TEST_ASSERT_EQUAL_PTR(third, entry);
+  entry = window.nextPending(entry->sequence);
+  TEST_ASSERT_EQUAL_PTR(fourth, entry);
+  TEST_ASSERT_NULL(window.nextPending(entry->sequence));
+}
+
+void test_fits_checks_topic_and_payload() {
+  char topic[MqttInflightWindow::kMaxTopic + 2];
+  memset(topic, 't', sizeof(topic) - 1);
+  topic[sizeof(topic) - 1] = '\0';
+  TEST_ASSERT_FALSE(MqttInflightWindow::fits(topic, 1));
+  topic[MqttInflightWindow::kMaxTopic] = '\0';
+  TEST_ASSERT_TRUE(MqttInflightWindow::fits(topic, MqttInflightWindow::kMaxPayload));
+  TEST_ASSERT_FALSE(MqttInflightWindow::fits(topic, MqttInflightWindow::kMaxPayload + 1));
+  TEST_ASSERT_FALSE(MqttInflightWindow::fits(nullptr, 1));
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_acquire_copies_and_release_frees);
+  RUN_TEST(test_window_limits_outstanding_publishes);
+  RUN_TEST(test_packet_ids_are_unique_and_nonzero);
+  RUN_TEST(test_next_pending_visits_oldest_first);
+  RUN_TEST(test_fits_checks_topic_and_payload);
+  return UNITY_END();
+}
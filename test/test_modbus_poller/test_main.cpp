@@ -0,0 +1,391 @@
+#include <DeviceCore.h>
+#include <NativeHal.h>
+#include <PubSubClient.h>
+#include <cstdlib>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <unity.h>
+#include <vector>
+
+using namespace DeviceCore;
+
+namespace {
+constexpr const char* kTopic = "test/modbus";
+// ModbusPoller's payload buffer.
+constexpr size_t kPayloadCapacity = 768;
+
+struct Request {
+  uint8_t slaveId;
+  uint8_t function;
+  uint16_t start;
+  uint16_t count;
+};
+
+uint16_t addressValue(uint16_t reg) {
+  return reg;
+}
+
+// High words of 0x8000 make every S32 value eleven characters long.
+uint16_t negativeValue(uint16_t reg) {
+  return reg % 2 == 0 ? 0x8000 : reg;
+}
+
+uint16_t crc16(const uint8_t* data, size_t length) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < length; ++i) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 1) ? static_cast<uint16_t>((crc >> 1) ^ 0xA001) : static_cast<uint16_t>(crc >> 1);
+    }
+  }
+  return crc;
+}
+
+// Answers every read on the other end of the UART from a register map and
+// logs the requests. Runs on its own thread, as the slave would.
+class SimulatedSlave {
+public:
+  explicit SimulatedSlave(uint16_t (*value)(uint16_t)) : _value(value) {
+    TEST_ASSERT_EQUAL(0, pipe2(_toSlave, O_CLOEXEC));
+    TEST_ASSERT_EQUAL(0, pipe2(_toMaster, O_NONBLOCK | O_CLOEXEC));
+    Serial.attach(_toMaster[0], _toSlave[1], false);
+    Serial.begin(9600);
+    _thread = std::thread(&SimulatedSlave::serve, this);
+  }
+
+  ~SimulatedSlave() {
+    close(_toSlave[1]);
+    _thread.join();
+    close(_toSlave[0]);
+    close(_toMaster[0]);
+    close(_toMaster[1]);
+  }
+
+  std::vector<Request> requests() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _requests;
+  }
+
+private:
+  uint16_t (*_value)(uint16_t);
+  int _toSlave[2];
+  int _toMaster[2];
+  std::thread _thread;
+  std::mutex _mutex;
+  std::vector<Request> _requests;
+
+  bool readFully(uint8_t* out, size_t length) {
+    size_t received = 0;
+    while (received < length) {
+      ssize_t result = ::read(_toSlave[0], out + received, length - received);
+      if (result <= 0) {
+        return false;
+      }
+      received += static_cast<size_t>(result);
+    }
+    return true;
+  }
+
+  void serve() {
+    uint8_t request[8];
+    while (readFully(request, sizeof(request))) {
+      Request logged = {request[0], request[1], static_cast<uint16_t>(request[2] << 8 | request[3]),
+                        static_cast<uint16_t>(request[4] << 8 | request[5])};
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _requests.push_back(logged);
+      }
+      uint8_t reply[5 + 2 * ModbusBus::kMaxRegisters];
+      reply[0] = logged.slaveId;
+      reply[1] = logged.function;
+      reply[2] = static_cast<uint8_t>(logged.count * 2);
+      for (uint16_t i = 0; i < logged.count; ++i) {
+        uint16_t value = _value(static_cast<uint16_t>(logged.start + i));
+        reply[3 + 2 * i] = static_cast<uint8_t>(value >> 8);
+        reply[4 + 2 * i] = static_cast<uint8_t>(value);
+      }
+      size_t length = 3 + 2 * logged.count;
+      uint16_t crc = crc16(reply, length);
+      reply[length++] = static_cast<uint8_t>(crc);
+      reply[length++] = static_cast<uint8_t>(crc >> 8);
+      // No assertions off the test thread; a short reply shows up as a bus error.
+      if (::write(_toMaster[1], reply, length) != static_cast<ssize_t>(length)) {
+        return;
+      }
+    }
+  }
+};
+
+// Broker stand-in: accepts the CONNECT and keeps the payload of every
+// PUBLISH, however PubSubClient splits it into writes.
+class CapturingClient : public Client {
+public:
+  int connect(IPAddress ip, uint16_t port) override { return 1; }
+  int connect(const char* host, uint16_t port) override { return 1; }
+  size_t write(uint8_t value) override { return write(&value, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    if (!_session) {
+      _session = true;
+      _replyLength = sizeof(kConnack);
+      return size;
+    }
+    _pending.append(reinterpret_cast<const char*>(buffer), size);
+    parse();
+    return size;
+  }
+  int available() override { return static_cast<int>(_replyLength); }
+  int read() override { return _replyLength ? kConnack[sizeof(kConnack) - _replyLength--] : -1; }
+  int read(uint8_t* buffer, size_t size) override {
+    size_t count = 0;
+    while (count < size && _replyLength) {
+      buffer[count++] = static_cast<uint8_t>(read());
+    }
+    return static_cast<int>(count);
+  }
+  int peek() override { return _replyLength ? kConnack[sizeof(kConnack) - _replyLength] : -1; }
+  void flush() override {}
+  void stop() override { _session = false; }
+  uint8_t connected() override { return 1; }
+  operator bool() override { return true; }
+
+  std::vector<std::string> payloads;
+
+private:
+  static constexpr uint8_t kConnack[4] = {0x20, 0x02, 0x00, 0x00};
+  bool _session = false;
+  size_t _replyLength = 0;
+  std::string _pending;
+
+  void parse() {
+    for (;;) {
+      size_t remaining = 0;
+      size_t header = 1;
+      for (size_t shift = 0;; shift += 7) {
+        if (header >= _pending.size()) {
+          return;
+        }
+        uint8_t digit = static_cast<uint8_t>(_pending[header++]);
+        remaining |= static_cast<size_t>(digit & 0x7F) << shift;
+        if (!(digit & 0x80)) {
+          break;
+        }
+      }
+      if (_pending.size() < header + remaining) {
+        return;
+      }
+      if ((static_cast<uint8_t>(_pending[0]) & 0xF0) == 0x30) {
+        size_t topicLength = static_cast<uint8_t>(_pending[header]) << 8 | static_cast<uint8_t>(_pending[header + 1]);
+        size_t body = header + 2 + topicLength;
+        payloads.push_back(_pending.substr(body, header + remaining - body));
+      }
+      _pending.erase(0, header + remaining);
+    }
+  }
+};
+
+constexpr uint8_t CapturingClient::kConnack[4];
+
+// One poller with its bus, broker and slave.
+struct Rig {
+  explicit Rig(uint16_t (*value)(uint16_t))
+      : forwarder(new SerialForwarder(64)),
+        bus(*forwarder),
+        poller(bus),
+        client(wire),
+        mqtt(client, socket, config),
+        slave(value) {
+    config.modbusTopic = kTopic;
+    config.primaryTopic = kTopic;
+    mqtt.begin(nullptr);
+    TEST_ASSERT_TRUE(client.connect("poller"));
+    bus.begin(Serial, 0xFF, 100);
+  }
+
+  // Runs every transaction due at now, one per run() as the scheduler would.
+  void runDue(unsigned long now, size_t transactions) {
+    for (size_t i = 0; i < transactions; ++i) {
+      poller.run(now, config, mqtt);
+    }
+  }
+
+  DeviceConfig config = {};
+  std::unique_ptr<SerialForwarder> forwarder;
+  ModbusBus bus;
+  ModbusPoller poller;
+  CapturingClient wire;
+  PubSubClient client;
+  AsyncTcpClient socket;
+  MqttLayer mqtt;
+  SimulatedSlave slave;
+};
+
+ModbusBlock block(const char* name, uint8_t slaveId, ModbusFunction function, uint16_t start, uint16_t count,
+                  ModbusValueType type = ModbusValueType::U16, unsigned long intervalMs = 1000) {
+  return {name, slaveId, function, start, count, type, intervalMs};
+}
+
+bool requested(const std::vector<Request>& requests, uint8_t slaveId, uint8_t function, uint16_t start, uint16_t count) {
+  for (const Request& request : requests) {
+    if (request.slaveId == slaveId && request.function == function && request.start == start && request.count == count) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string field(const std::string& payload, const char* name) {
+  std::string key = std::string("\"") + name + "\":";
+  size_t start = payload.find(key);
+  if (start == std::string::npos) {
+    return std::string();
+  }
+  start += key.size();
+  size_t end = payload.find_first_of(",}", start);
+  return payload.substr(start, end - start);
+}
+
+std::vector<long long> values(const std::string& payload) {
+  std::vector<long long> out;
+  size_t start = payload.find('[');
+  size_t end = payload.find(']');
+  const char* cursor = payload.c_str() + start + 1;
+  while (cursor < payload.c_str() + end) {
+    char* next;
+    out.push_back(strtoll(cursor, &next, 10));
+    cursor = next + 1;
+  }
+  return out;
+}
+
+// Messages of one block, in publish order.
+std::vector<std::string> messagesOf(const Rig& rig, const char* name) {
+  std::vector<std::string> out;
+  for (const std::string& payload : rig.wire.payloads) {
+    if (field(payload, "block") == std::string("\"") + name + "\"") {
+      out.push_back(payload);
+    }
+  }
+  return out;
+}
+}  // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_merges_touching_and_overlapping_blocks() {
+  const ModbusBlock blocks[] = {
+      block("c", 1, ModbusFunction::HoldingRegisters, 12, 8),
+      block("a", 1, ModbusFunction::HoldingRegisters, 0, 10),
+      block("b", 1, ModbusFunction::HoldingRegisters, 10, 5),
+      block("gap", 1, ModbusFunction::HoldingRegisters, 30, 4),
+      block("slave2", 2, ModbusFunction::HoldingRegisters, 0, 4),
+      block("input", 1, ModbusFunction::InputRegisters, 0, 2),
+      block("slow", 1, ModbusFunction::HoldingRegisters, 0, 2, ModbusValueType::U16, 5000),
+  };
+  Rig rig(addressValue);
+  TEST_ASSERT_EQUAL_size_t(5, rig.poller.begin(blocks, 7, 0));
+  rig.runDue(0, 5);
+
+  std::vector<Request> requests = rig.slave.requests();
+  TEST_ASSERT_EQUAL_size_t(5, requests.size());
+  TEST_ASSERT_TRUE(requested(requests, 1, 3, 0, 20));
+  TEST_ASSERT_TRUE(requested(requests, 1, 3, 30, 4));
+  TEST_ASSERT_TRUE(requested(requests, 2, 3, 0, 4));
+  TEST_ASSERT_TRUE(requested(requests, 1, 4, 0, 2));
+  TEST_ASSERT_TRUE(requested(requests, 1, 3, 0, 2));
+
+  // Each block is published on its own, cut out of the merged read.
+  const char* names[] = {"a", "b", "c", "gap"};
+  const uint16_t starts[] = {0, 10, 12, 30};
+  const size_t counts[] = {10, 5, 8, 4};
+  for (size_t i = 0; i < 4; ++i) {
+    std::vector<std::string> messages = messagesOf(rig, names[i]);
+    TEST_ASSERT_EQUAL_size_t(1, messages.size());
+    TEST_ASSERT_EQUAL(starts[i], atoi(field(messages[0], "reg").c_str()));
+    std::vector<long long> read = values(messages[0]);
+    TEST_ASSERT_EQUAL_size_t(counts[i], read.size());
+    TEST_ASSERT_EQUAL(starts[i], read.front());
+    TEST_ASSERT_EQUAL(starts[i] + counts[i] - 1, read.back());
+  }
+}
+
+void test_merge_stops_at_the_register_limit() {
+  const ModbusBlock blocks[] = {
+      block("head", 1, ModbusFunction::HoldingRegisters, 0, 100),
+      block("fill", 1, ModbusFunction::HoldingRegisters, 100, 25),
+      block("over", 1, ModbusFunction::HoldingRegisters, 125, 1),
+  };
+  Rig rig(addressValue);
+  TEST_ASSERT_EQUAL_size_t(2, rig.poller.begin(blocks, 3, 0));
+  rig.runDue(0, 2);
+
+  std::vector<Request> requests = rig.slave.requests();
+  TEST_ASSERT_EQUAL_size_t(2, requests.size());
+  TEST_ASSERT_TRUE(requested(requests, 1, 3, 0, ModbusBus::kMaxRegisters));
+  TEST_ASSERT_TRUE(requested(requests, 1, 3, 125, 1));
+}
+
+void test_splits_long_block_on_value_boundaries() {
+  const uint16_t start = 1000;
+  const uint16_t count = 124;
+  const ModbusBlock blocks[] = {block("long", 1, ModbusFunction::HoldingRegisters, start, count, ModbusValueType::S32)};
+  Rig rig(negativeValue);
+  TEST_ASSERT_EQUAL_size_t(1, rig.poller.begin(blocks, 1, 0));
+  rig.runDue(0, 1);
+
+  std::vector<std::string> messages = messagesOf(rig, "long");
+  TEST_ASSERT_GREATER_THAN(1, messages.size());
+  uint16_t reg = start;
+  for (const std::string& message : messages) {
+    TEST_ASSERT_TRUE(message.size() <= kPayloadCapacity);
+    // "reg" is the register of the message's first value; a 32-bit value
+    // is never split across messages.
+    TEST_ASSERT_EQUAL(reg, atoi(field(message, "reg").c_str()));
+    std::vector<long long> read = values(message);
+    TEST_ASSERT_GREATER_THAN(0, read.size());
+    TEST_ASSERT_EQUAL(INT32_MIN + reg + 1, read.front());
+    reg = static_cast<uint16_t>(reg + 2 * read.size());
+  }
+  TEST_ASSERT_EQUAL(start + count, reg);
+}
+
+void test_most_overdue_transaction_runs_first() {
+  const ModbusBlock blocks[] = {
+      block("slow", 1, ModbusFunction::HoldingRegisters, 0, 1, ModbusValueType::U16, 1000),
+      block("fast", 2, ModbusFunction::HoldingRegisters, 0, 1, ModbusValueType::U16, 100),
+  };
+  Rig rig(addressValue);
+  TEST_ASSERT_EQUAL_size_t(2, rig.poller.begin(blocks, 2, 0));
+  rig.runDue(0, 2);
+  // At 1500 the slow block is 500 ms late and the fast one 1400 ms.
+  rig.runDue(1500, 2);
+
+  std::vector<Request> requests = rig.slave.requests();
+  TEST_ASSERT_EQUAL_size_t(4, requests.size());
+  TEST_ASSERT_EQUAL_UINT8(1, requests[0].slaveId);
+  TEST_ASSERT_EQUAL_UINT8(2, requests[1].slaveId);
+  TEST_ASSERT_EQUAL_UINT8(2, requests[2].slaveId);
+  TEST_ASSERT_EQUAL_UINT8(1, requests[3].slaveId);
+}
+
+int main(int argc, char** argv) {
+  char stateDir[] = "/tmp/devicecore-test-XXXXXX";
+  if (!mkdtemp(stateDir)) {
+    perror("mkdtemp");
+    return 1;
+  }
+  setenv("DEVICECORE_NATIVE_STATE", stateDir, 1);
+  setenv("DEVICECORE_NATIVE_UART", "/dev/null", 1);
+  NativeHal::begin(argc, argv);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_merges_touching_and_overlapping_blocks);
+  RUN_TEST(test_merge_stops_at_the_register_limit);
+  RUN_TEST(test_splits_long_block_on_value_boundaries);
+  RUN_TEST(test_most_overdue_transaction_runs_first);
+  return UNITY_END();
+}
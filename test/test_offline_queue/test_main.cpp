@@ -0,0 +1,172 @@
+#include <DeviceCore.h>
+#include <LittleFS.h>
+#include <NativeHal.h>
+#include <cstdlib>
+#include <unity.h>
+#include <vector>
+
+using DeviceCore::OfflineQueue;
+
+namespace {
+constexpr const char* kQueueDir = "/fwdq";
+constexpr size_t kLargeBudget = OfflineQueue::kMaxSegments * OfflineQueue::kSegmentSize;
+
+void line(char* out, size_t capacity, int index) {
+  snprintf(out, capacity, "line-%03d", index);
+}
+
+void pushLines(OfflineQueue& queue, int first, int count) {
+  char text[16];
+  for (int i = first; i < first + count; ++i) {
+    line(text, sizeof(text), i);
+    TEST_ASSERT_TRUE(queue.push(0, text, strlen(text)));
+  }
+}
+
+void expectLines(OfflineQueue& queue, int first, int count) {
+  char expected[16];
+  char out[32];
+  for (int i = first; i < first + count; ++i) {
+    line(expected, sizeof(expected), i);
+    size_t length = queue.peek(out, sizeof(out));
+    TEST_ASSERT_EQUAL_size_t(strlen(expected), length);
+    TEST_ASSERT_EQUAL_STRING_LEN(expected, out, length);
+    queue.pop(0);
+  }
+}
+
+void segmentPath(uint32_t seq, char* out, size_t capacity) {
+  snprintf(out, capacity, "%s/%08lx.log", kQueueDir, static_cast<unsigned long>(seq));
+}
+
+// Writes a segment file directly, one record per index.
+void writeSegment(uint32_t seq, int first, int count) {
+  char path[32];
+  segmentPath(seq, path, sizeof(path));
+  File file = LittleFS.open(path, "a");
+  TEST_ASSERT_TRUE(static_cast<bool>(file));
+  char text[16];
+  for (int i = first; i < first + count; ++i) {
+    line(text, sizeof(text), i);
+    uint8_t header[2] = {static_cast<uint8_t>(strlen(text)), 0};
+    file.write(header, sizeof(header));
+    file.write(reinterpret_cast<const uint8_t*>(text), strlen(text));
+  }
+  file.close();
+}
+}  // namespace
+
+void setUp() {
+  TEST_ASSERT_TRUE(LittleFS.begin());
+  std::vector<String> names;
+  Dir dir = LittleFS.openDir(kQueueDir);
+  while (dir.next()) {
+    names.push_back(dir.fileName());
+  }
+  for (const String& name : names) {
+    String path = String(kQueueDir) + "/" + name;
+    LittleFS.remove(path.c_str());
+  }
+}
+
+void tearDown() {}
+
+void test_replays_in_order() {
+  OfflineQueue queue;
+  TEST_ASSERT_TRUE(queue.begin(kLargeBudget));
+  TEST_ASSERT_TRUE(queue.empty());
+  pushLines(queue, 0, 5);
+  TEST_ASSERT_EQUAL_UINT32(5, queue.depth());
+  expectLines(queue, 0, 5);
+  TEST_ASSERT_TRUE(queue.empty());
+  TEST_ASSERT_EQUAL_UINT32(5, queue.stats().replayed);
+}
+
+void test_recovers_after_restart() {
+  {
+    OfflineQueue queue;
+    TEST_ASSERT_TRUE(queue.begin(kLargeBudget));
+    pushLines(queue, 0, 3);
+    queue.flush();
+  }
+  OfflineQueue queue;
+  TEST_ASSERT_TRUE(queue.begin(kLargeBudget));
+  TEST_ASSERT_EQUAL_UINT32(3, queue.depth());
+  expectLines(queue, 0, 3);
+  TEST_ASSERT_TRUE(queue.empty());
+}
+
+void test_torn_tail_keeps_complete_records() {
+  {
+    OfflineQueue queue;
+    TEST_ASSERT_TRUE(queue.begin(kLargeBudget));
+    pushLines(queue, 0, 2);
+    queue.flush();
+  }
+  // Power lost halfway through the next record.
+  char path[32];
+  segmentPath(0, path, sizeof(path));
+  File file = LittleFS.open(path, "a");
+  const uint8_t torn[] = {10, 0, 'l', 'i', 'n'};
+  file.write(torn, sizeof(torn));
+  file.close();
+
+  OfflineQueue queue;
+  TEST_ASSERT_TRUE(queue.begin(kLargeBudget));
+  TEST_ASSERT_EQUAL_UINT32(2, queue.depth());
+  pushLines(queue, 2, 1);
+  queue.flush();
+  // Nothing is appended behind the torn record.
+  segmentPath(1, path, sizeof(path));
+  TEST_ASSERT_TRUE(LittleFS.exists(path));
+  expectLines(queue, 0, 3);
+}
+
+void test_budget_drops_the_oldest_segment() {
+  OfflineQueue queue;
+  // Two segments' worth.
+  TEST_ASSERT_TRUE(queue.begin(2 * OfflineQueue::kSegmentSize));
+  char text[200];
+  memset(text, 'x', sizeof(text));
+  const size_t perSegment = OfflineQueue::kSegmentSize / (sizeof(text) + 2);
+  for (size_t i = 0; i < 3 * perSegment; ++i) {
+    text[0] = static_cast<char>('A' + i / perSegment);
+    TEST_ASSERT_TRUE(queue.push(0, text, sizeof(text)));
+  }
+  queue.flush();
+  TEST_ASSERT_EQUAL_UINT32(perSegment, queue.stats().dropped);
+  TEST_ASSERT_EQUAL_UINT32(2 * perSegment, queue.depth());
+  char out[256];
+  TEST_ASSERT_EQUAL_size_t(sizeof(text), queue.peek(out, sizeof(out)));
+  TEST_ASSERT_EQUAL('B', out[0]);
+}
+
+void test_recovery_keeps_the_newest_segments() {
+  const uint32_t files = OfflineQueue::kMaxSegments + 6;
+  for (uint32_t seq = 0; seq < files; ++seq) {
+    writeSegment(seq, static_cast<int>(seq), 1);
+  }
+  OfflineQueue queue;
+  TEST_ASSERT_TRUE(queue.begin(kLargeBudget));
+  TEST_ASSERT_EQUAL_UINT32(OfflineQueue::kMaxSegments, queue.depth());
+  expectLines(queue, 6, static_cast<int>(OfflineQueue::kMaxSegments));
+}
+
+int main(int argc, char** argv) {
+  char stateDir[] = "/tmp/devicecore-test-XXXXXX";
+  if (!mkdtemp(stateDir)) {
+    perror("mkdtemp");
+    return 1;
+  }
+  setenv("DEVICECORE_NATIVE_STATE", stateDir, 1);
+  setenv("DEVICECORE_NATIVE_UART", "/dev/null", 1);
+  NativeHal::begin(argc, argv);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_replays_in_order);
+  RUN_TEST(test_recovers_after_restart);
+  RUN_TEST(test_torn_tail_keeps_complete_records);
+  RUN_TEST(test_budget_drops_the_oldest_segment);
+  RUN_TEST(test_recovery_keeps_the_newest_segments);
+  return UNITY_END();
+}
@@ -0,0 +1,228 @@
+#include <DeviceCore.h>
+#include <NativeHal.h>
+#include <Network/PortalPage.h>
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <unity.h>
+#include <vector>
+
+// Serves the provisioning portal from the loop thread while client threads
+// fetch its pages over loopback TCP, and reports requests/sec and latency
+// percentiles:
+//   pio test -e native -f test_portal_load -v
+
+using namespace DeviceCore;
+
+namespace {
+constexpr size_t kClients = 8;
+constexpr size_t kRequestsPerClient = 100;
+const char* const kPaths[] = {"/", "/info.json", "/status", "/scan", "/generate_204"};
+constexpr size_t kPathCount = sizeof(kPaths) / sizeof(kPaths[0]);
+
+uint16_t s_port = 0;
+ConfigJournal s_journal;
+CredentialStore s_store(s_journal);
+WifiScanCache s_scanCache;
+ProvisioningManager s_manager(s_store, s_scanCache, "000-0000", "http://manual.example");
+
+struct Sample {
+  int status;
+  double ms;
+};
+
+uint16_t freePort() {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(address);
+  bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+  getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+  close(fd);
+  return ntohs(address.sin_port);
+}
+
+int openConnection() {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  timeval timeout = {5, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(s_port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// One request on its own connection, read until the server closes it.
+// Returns the status code, or -1 if the exchange failed.
+int fetch(const std::string& request, std::string* body = nullptr) {
+  int fd = openConnection();
+  if (fd < 0 || send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size())) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    return -1;
+  }
+  std::string response;
+  char buffer[4096];
+  ssize_t received;
+  while ((received = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+    response.append(buffer, static_cast<size_t>(received));
+  }
+  close(fd);
+  if (received < 0 || response.compare(0, 9, "HTTP/1.1 ") != 0) {
+    return -1;
+  }
+  if (body) {
+    size_t start = response.find("\r\n\r\n");
+    *body = start == std::string::npos ? std::string() : response.substr(start + 4);
+  }
+  return atoi(response.c_str() + 9);
+}
+
+std::string get(const char* path) {
+  return std::string("GET ") + path + " HTTP/1.1\r\nHost: 192.168.4.1\r\n\r\n";
+}
+
+// Runs the loop thread until done() holds.
+template <typename Done>
+void serveUntil(Done done) {
+  while (!done()) {
+    s_manager.loop();
+    NativeHal::service();
+  }
+}
+
+double percentile(std::vector<double>& sorted, double fraction) {
+  size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+  return sorted[index];
+}
+}  // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_concurrent_clients() {
+  std::vector<Sample> samples(kClients * kRequestsPerClient);
+  std::atomic<size_t> finished(0);
+  std::vector<std::thread> clients;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t client = 0; client < kClients; ++client) {
+    clients.emplace_back([&samples, &finished, client]() {
+      for (size_t i = 0; i < kRequestsPerClient; ++i) {
+        Sample& sample = samples[client * kRequestsPerClient + i];
+        auto sent = std::chrono::steady_clock::now();
+        sample.status = fetch(get(kPaths[(client + i) % kPathCount]));
+        sample.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sent).count();
+      }
+      ++finished;
+    });
+  }
+  serveUntil([&]() { return finished.load() == kClients; });
+  for (std::thread& client : clients) {
+    client.join();
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::vector<double> latencies;
+  size_t ok = 0;
+  size_t busy = 0;
+  size_t failed = 0;
+  for (const Sample& sample : samples) {
+    latencies.push_back(sample.ms);
+    ok += sample.status == 200 || sample.status == 302;
+    busy += sample.status == 503;
+    failed += sample.status != 200 && sample.status != 302 && sample.status != 503;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  printf("%zu clients: %.0f requests/s  p50 %.2f ms  p99 %.2f ms  max %.2f ms  503s %zu\n", kClients,
+         samples.size() / seconds, percentile(latencies, 0.50), percentile(latencies, 0.99), latencies.back(), busy);
+
+  TEST_ASSERT_EQUAL_size_t(0, failed);
+  TEST_ASSERT_GREATER_THAN(samples.size() / 2, ok);
+}
+
+void test_idle_connections_do_not_stall_the_portal() {
+  // Clients that connect and never send hold a connection each.
+  std::vector<int> idle;
+  for (size_t i = 0; i + 1 < AsyncWebServer::kMaxConnections; ++i) {
+    idle.push_back(openConnection());
+    TEST_ASSERT_GREATER_OR_EQUAL(0, idle.back());
+  }
+  std::atomic<int> status(0);
+  std::thread client([&status]() { status = fetch(get("/info.json")); });
+  serveUntil([&]() { return status.load() != 0; });
+  client.join();
+  TEST_ASSERT_EQUAL(200, status.load());
+  for (int fd : idle) {
+    close(fd);
+  }
+}
+
+void test_root_revalidates_with_etag() {
+  std::string request = std::string("GET / HTTP/1.1\r\nIf-None-Match: ") + kPortalPageEtag + "\r\n\r\n";
+  std::atomic<int> status(0);
+  std::thread client([&]() { status = fetch(request); });
+  serveUntil([&]() { return status.load() != 0; });
+  client.join();
+  TEST_ASSERT_EQUAL(304, status.load());
+}
+
+void test_submit_starts_a_connection_test() {
+  const char form[] = "ssid=+home%20net+&password=secret";
+  char request[256];
+  snprintf(request, sizeof(request),
+           "POST /submit HTTP/1.1\r\nContent-Type: application/x-www-form-urlencoded\r\nContent-Length: %zu\r\n\r\n%s",
+           strlen(form), form);
+  std::atomic<int> status(0);
+  std::string body;
+  std::thread client([&]() { status = fetch(request, &body); });
+  serveUntil([&]() { return status.load() != 0; });
+  client.join();
+  TEST_ASSERT_EQUAL(202, status.load());
+
+  status = 0;
+  std::thread poll([&]() { status = fetch(get("/status"), &body); });
+  serveUntil([&]() { return status.load() != 0; });
+  poll.join();
+  TEST_ASSERT_EQUAL(200, status.load());
+  TEST_ASSERT_TRUE(body.find("\"state\":\"idle\"") == std::string::npos);
+  TEST_ASSERT_TRUE(body.find("\"ssid\":\"home net\"") != std::string::npos);
+}
+
+int main(int argc, char** argv) {
+  char stateDir[] = "/tmp/devicecore-portal-XXXXXX";
+  if (!mkdtemp(stateDir)) {
+    perror("mkdtemp");
+    return 1;
+  }
+  s_port = freePort();
+  char port[8];
+  snprintf(port, sizeof(port), "%u", s_port);
+  setenv("DEVICECORE_NATIVE_STATE", stateDir, 1);
+  setenv("DEVICECORE_NATIVE_UART", "/dev/null", 1);
+  setenv("DEVICECORE_NATIVE_HTTP_PORT", port, 1);
+  NativeHal::begin(argc, argv);
+  s_manager.begin();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_concurrent_clients);
+  RUN_TEST(test_idle_connections_do_not_stall_the_portal);
+  RUN_TEST(test_root_revalidates_with_etag);
+  RUN_TEST(test_submit_starts_a_connection_test);
+  int failures = UNITY_END();
+  s_manager.stop();
+  return failures;
+}
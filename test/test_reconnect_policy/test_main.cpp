@@ -0,0 +1,116 @@
+#include <DeviceCore.h>
+#include <unity.h>
+
+using DeviceCore::ReconnectPolicy;
+
+namespace {
+constexpr unsigned long kBaseMs = 100;
+constexpr unsigned long kMaxMs = 6400;
+constexpr unsigned long kStableMs = 60000;
+
+// Fails one attempt at now and returns the delay the policy chose.
+unsigned long failAt(ReconnectPolicy& policy, unsigned long now) {
+  policy.onAttempt(now);
+  policy.onFailure(now);
+  return policy.nextAttemptMs() - now;
+}
+}  // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_first_attempt_is_immediate() {
+  ReconnectPolicy policy("test", kBaseMs, kMaxMs, kStableMs);
+  TEST_ASSERT_TRUE(policy.shouldAttempt(0));
+  policy.onAttempt(0);
+  TEST_ASSERT_FALSE(policy.shouldAttempt(kBaseMs - 1));
+  TEST_ASSERT_TRUE(policy.shouldAttempt(kBaseMs));
+}
+
+void test_delay_ceiling_doubles_up_to_the_cap() {
+  // Full jitter makes single delays random, so check each level's ceiling
+  // over many trials.
+  for (uint8_t failures = 1; failures < ReconnectPolicy::kBreakerThreshold; ++failures) {
+    unsigned long ceiling = kBaseMs << failures;
+    if (ceiling > kMaxMs) {
+      ceiling = kMaxMs;
+    }
+    unsigned long longest = 0;
+    for (int trial = 0; trial < 200; ++trial) {
+      ReconnectPolicy policy("test", kBaseMs, kMaxMs, kStableMs);
+      unsigned long delay = 0;
+      for (uint8_t i = 0; i < failures; ++i) {
+        delay = failAt(policy, 1000);
+      }
+      TEST_ASSERT_LESS_OR_EQUAL(ceiling, delay);
+      longest = delay > longest ? delay : longest;
+    }
+    TEST_ASSERT_GREATER_THAN(ceiling / 2, longest);
+  }
+}
+
+void test_breaker_opens_and_spaces_at_the_cap() {
+  ReconnectPolicy policy("test", kBaseMs, kMaxMs, kStableMs);
+  unsigned long now = 0;
+  for (uint8_t i = 0; i < ReconnectPolicy::kBreakerThreshold; ++i) {
+    TEST_ASSERT_FALSE(policy.breakerOpen());
+    now += failAt(policy, now);
+  }
+  TEST_ASSERT_TRUE(policy.breakerOpen());
+  TEST_ASSERT_EQUAL_UINT32(1, policy.stats().breakerTrips);
+  for (int i = 0; i < 50; ++i) {
+    unsigned long delay = failAt(policy, now);
+    TEST_ASSERT_GREATER_OR_EQUAL(kMaxMs / 2, delay);
+    TEST_ASSERT_LESS_OR_EQUAL(kMaxMs, delay);
+    now += delay;
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, policy.stats().breakerTrips);
+}
+
+void test_stable_session_resets_the_backoff() {
+  ReconnectPolicy policy("test", kBaseMs, kMaxMs, kStableMs);
+  for (uint8_t i = 0; i < ReconnectPolicy::kBreakerThreshold; ++i) {
+    failAt(policy, 0);
+  }
+  policy.onAttempt(1000);
+  policy.onSuccess(1000);
+  policy.onDisconnected(1000 + kStableMs);
+  TEST_ASSERT_FALSE(policy.breakerOpen());
+  TEST_ASSERT_LESS_OR_EQUAL(kBaseMs, policy.nextAttemptMs() - (1000 + kStableMs));
+}
+
+void test_flapping_session_keeps_the_breaker_open() {
+  ReconnectPolicy policy("test", kBaseMs, kMaxMs, kStableMs);
+  for (uint8_t i = 0; i < ReconnectPolicy::kBreakerThreshold; ++i) {
+    failAt(policy, 0);
+  }
+  policy.onAttempt(1000);
+  policy.onSuccess(1000);
+  policy.onDisconnected(2000);
+  TEST_ASSERT_TRUE(policy.breakerOpen());
+  TEST_ASSERT_GREATER_OR_EQUAL(kMaxMs / 2, policy.nextAttemptMs() - 2000);
+}
+
+void test_stats_track_time_to_reconnect() {
+  ReconnectPolicy policy("test", kBaseMs, kMaxMs, kStableMs);
+  failAt(policy, 500);
+  policy.onAttempt(900);
+  policy.onSuccess(900);
+  const DeviceCore::ReconnectStats& stats = policy.stats();
+  TEST_ASSERT_EQUAL_UINT32(2, stats.attempts);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.failures);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.successes);
+  TEST_ASSERT_EQUAL_UINT32(400, stats.lastTimeToReconnectMs);
+  TEST_ASSERT_EQUAL_UINT32(400, stats.maxTimeToReconnectMs);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_first_attempt_is_immediate);
+  RUN_TEST(test_delay_ceiling_doubles_up_to_the_cap);
+  RUN_TEST(test_breaker_opens_and_spaces_at_the_cap);
+  RUN_TEST(test_stable_session_resets_the_backoff);
+  RUN_TEST(test_flapping_session_keeps_the_breaker_open);
+  RUN_TEST(test_stats_track_time_to_reconnect);
+  return UNITY_END();
+}
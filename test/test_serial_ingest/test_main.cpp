@@ -0,0 +1,151 @@
+#include <DeviceCore.h>
+#include <NativeHal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <unity.h>
+
+using DeviceCore::SerialIngest;
+
+namespace {
+NativeHal::ManualClock s_clock;
+SerialIngest s_ingest;
+int s_pipe[2] = {-1, -1};
+unsigned s_wakes = 0;
+
+// UART0 reads from a pipe the test writes into.
+void feed(const char* text) {
+  TEST_ASSERT_EQUAL(static_cast<ssize_t>(strlen(text)), write(s_pipe[1], text, strlen(text)));
+}
+
+void advanceMs(uint32_t ms) {
+  s_clock.advanceUs(static_cast<uint64_t>(ms) * 1000ULL);
+}
+
+void onWake() {
+  ++s_wakes;
+}
+}  // namespace
+
+void setUp() {
+  TEST_ASSERT_EQUAL(0, pipe2(s_pipe, O_NONBLOCK | O_CLOEXEC));
+  Serial.attach(s_pipe[0], -1, false);
+  Serial.begin(115200);
+  s_wakes = 0;
+}
+
+void tearDown() {
+  s_ingest.end();
+  s_ingest.setWakeHandler(nullptr);
+  close(s_pipe[0]);
+  close(s_pipe[1]);
+}
+
+void test_depth_rounds_down_to_a_power_of_two() {
+  s_ingest.begin(Serial, 1000);
+  TEST_ASSERT_EQUAL_size_t(512, s_ingest.depth());
+  s_ingest.begin(Serial, SerialIngest::kCapacity * 4);
+  TEST_ASSERT_EQUAL_size_t(SerialIngest::kCapacity, s_ingest.depth());
+}
+
+void test_pump_preserves_order() {
+  s_ingest.begin(Serial, 64);
+  s_ingest.setWakeHandler(&onWake);
+  feed("hello");
+  s_ingest.pump();
+  TEST_ASSERT_EQUAL_size_t(5, s_ingest.available());
+  TEST_ASSERT_EQUAL_UINT32(1, s_wakes);
+  char out[6] = {};
+  for (size_t i = 0; i < 5; ++i) {
+    out[i] = static_cast<char>(s_ingest.read());
+  }
+  TEST_ASSERT_EQUAL_STRING("hello", out);
+  TEST_ASSERT_EQUAL(-1, s_ingest.read());
+}
+
+void test_ticker_drains_the_uart() {
+  s_ingest.begin(Serial, 64);
+  feed("abc");
+  TEST_ASSERT_EQUAL_size_t(0, s_ingest.available());
+  advanceMs(5);
+  NativeHal::service();
+  TEST_ASSERT_EQUAL_size_t(3, s_ingest.available());
+}
+
+void test_wraps_and_counts_dropped_bytes() {
+  s_ingest.begin(Serial, 16);
+  // Move the indices past the end of the storage once.
+  feed("0123456789");
+  s_ingest.pump();
+  for (int i = 0; i < 10; ++i) {
+    TEST_ASSERT_EQUAL('0' + i, s_ingest.read());
+  }
+  feed("abcdefghijklmnopqrst");
+  s_ingest.pump();
+  TEST_ASSERT_EQUAL_size_t(16, s_ingest.available());
+  TEST_ASSERT_EQUAL_UINT32(4, s_ingest.droppedBytes());
+  TEST_ASSERT_EQUAL_UINT32(0, s_ingest.overrunEvents());
+  for (int i = 0; i < 16; ++i) {
+    TEST_ASSERT_EQUAL('a' + i, s_ingest.read());
+  }
+}
+
+void test_uart_overrun_is_an_event_not_bytes() {
+  // A paced source overflows a small RX buffer once the clock runs ahead.
+  Serial.attach(s_pipe[0], -1, true);
+  Serial.setRxBufferSize(32);
+  Serial.begin(115200);
+  s_ingest.begin(Serial, 64);
+  feed("0123456789012345678901234567890123456789012345678901234567890123");
+  advanceMs(10);
+  s_ingest.pump();
+  TEST_ASSERT_EQUAL_size_t(32, s_ingest.available());
+  TEST_ASSERT_EQUAL_UINT32(1, s_ingest.overrunEvents());
+  TEST_ASSERT_EQUAL_UINT32(0, s_ingest.droppedBytes());
+  // The core's default.
+  Serial.setRxBufferSize(256);
+}
+
+void test_suspend_leaves_the_port_alone() {
+  s_ingest.begin(Serial, 64);
+  feed("ab");
+  s_ingest.suspend();
+  TEST_ASSERT_TRUE(s_ingest.suspended());
+  // What arrived before the hand-over is kept.
+  TEST_ASSERT_EQUAL_size_t(2, s_ingest.available());
+  feed("cd");
+  s_ingest.pump();
+  TEST_ASSERT_EQUAL_size_t(2, s_ingest.available());
+  TEST_ASSERT_EQUAL('c', Serial.read());
+  s_ingest.resume();
+  s_ingest.pump();
+  TEST_ASSERT_EQUAL_size_t(3, s_ingest.available());
+}
+
+void test_arrival_follows_the_read_position() {
+  s_ingest.begin(Serial, 64);
+  advanceMs(10);
+  unsigned long first = millis();
+  feed("xy");
+  s_ingest.pump();
+  advanceMs(10);
+  feed("z");
+  s_ingest.pump();
+  TEST_ASSERT_EQUAL_UINT32(first, s_ingest.arrivalMs());
+  s_ingest.read();
+  TEST_ASSERT_EQUAL_UINT32(first, s_ingest.arrivalMs());
+  s_ingest.read();
+  TEST_ASSERT_EQUAL_UINT32(first + 10, s_ingest.arrivalMs());
+}
+
+int main(int argc, char** argv) {
+  NativeHal::setClock(s_clock);
+  UNITY_BEGIN();
+  RUN_TEST(test_depth_rounds_down_to_a_power_of_two);
+  RUN_TEST(test_pump_preserves_order);
+  RUN_TEST(test_ticker_drains_the_uart);
+  RUN_TEST(test_wraps_and_counts_dropped_bytes);
+  RUN_TEST(test_uart_overrun_is_an_event_not_bytes);
+  RUN_TEST(test_suspend_leaves_the_port_alone);
+  RUN_TEST(test_arrival_follows_the_read_position);
+  return UNITY_END();
+}
@@ -0,0 +1,62 @@
+"""Compress web/portal.html into a PROGMEM header for the provisioning portal.
+
+Runs standalone (python tools/embed_portal.py) or as a PlatformIO pre-build
+script. The header is only rewritten when its content changes, so an
+unchanged page does not trigger a rebuild.
+"""
+
+import gzip
+import os
+import zlib
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+SOURCE = os.path.join(PROJECT_DIR, "web", "portal.html")
+TARGET = os.path.join(PROJECT_DIR, "lib", "DeviceCore", "src", "Network", "PortalPage.h")
+BYTES_PER_LINE = 16
+
+
+def render(payload, etag):
+    lines = [
+        "#pragma once",
+        "",
+        "// Generated by tools/embed_portal.py from web/portal.html; do not edit.",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "namespace DeviceCore {",
+        "",
+        "constexpr size_t kPortalPageGzLength = %d;" % len(payload),
+        'constexpr char kPortalPageEtag[] = "\\"%s\\"";' % etag,
+        "const uint8_t kPortalPageGz[] PROGMEM = {",
+    ]
+    for offset in range(0, len(payload), BYTES_PER_LINE):
+        chunk = payload[offset:offset + BYTES_PER_LINE]
+        lines.append("    " + ", ".join("0x%02x" % b for b in chunk) + ",")
+    lines += ["};", "", "}  // namespace DeviceCore", ""]
+    return "\n".join(lines)
+
+
+def main():
+    with open(SOURCE, "rb") as handle:
+        html = handle.read()
+
+    # mtime=0 keeps the output byte-identical across builds.
+    payload = gzip.compress(html, compresslevel=9, mtime=0)
+    etag = "%08x" % (zlib.crc32(html) & 0xFFFFFFFF)
+    header = render(payload, etag)
+
+    if os.path.exists(TARGET):
+        with open(TARGET, "r", encoding="utf-8") as handle:
+            if handle.read() == header:
+                return
+    with open(TARGET, "w", encoding="utf-8", newline="\n") as handle:
+        handle.write(header)
+    print("embed_portal: %d bytes -> %d bytes gzip" % (len(html), len(payload)))
+
+
+main()